@@ -0,0 +1,57 @@
+/* live controls: buttons post to /control instead of loading a page,
+   every open page follows the device state over /events */
+(function () {
+    var links = document.querySelectorAll("a.button");
+
+    function field(link) {
+        return /^\/(speed|animation)_(\w+)$/.exec(link.getAttribute("href"));
+    }
+
+    if (window.fetch) {
+        document.addEventListener("click", function (event) {
+            var link = event.target.closest("a.button");
+            var match = link && field(link);
+            if (!match) {
+                return;
+            }
+            event.preventDefault();
+            var update = {};
+            update[match[1]] = match[2];
+            fetch("/control", {
+                method: "POST",
+                headers: { "Content-Type": "application/json" },
+                body: JSON.stringify(update)
+            });
+        });
+    }
+
+    if (!window.EventSource) {
+        return;
+    }
+
+    /* left, middle and right bar followed by the rgb led */
+    var leds = document.createElement("div");
+    leds.className = "leds";
+    for (var i = 0; i < 4; i++) {
+        leds.appendChild(document.createElement("span"));
+    }
+    document.querySelector(".content").appendChild(leds);
+
+    var events = new EventSource("/events");
+    events.addEventListener("state", function (event) {
+        var state = JSON.parse(event.data);
+        for (var i = 0; i < links.length; i++) {
+            var match = field(links[i]);
+            if (match) {
+                links[i].className = "button " + (state[match[1]] === match[2] ? "on" : "off");
+            }
+        }
+    });
+    events.addEventListener("frame", function (event) {
+        var frame = JSON.parse(event.data);
+        for (var i = 0; i < 3; i++) {
+            leds.children[i].className = (frame.bars & (1 << i)) ? "lit" : "";
+        }
+        leds.children[3].className = frame.rgb === "none" ? "" : frame.rgb;
+    });
+})();
@@ -25,11 +25,16 @@
 #include "WiFiClient.h"
 #include "WebServer.h"
 #include "detail/mimetable.h"
+#include <lwip/sockets.h>
+
+#undef read
 
 #ifndef WEBSERVER_MAX_POST_ARGS
 #define WEBSERVER_MAX_POST_ARGS 32
 #endif
 
+static_assert(HTTP_HEAD_BUFLEN < 65536, "request views keep 16 bit offsets into the arena");
+
 #define __STR(a) #a
 #define _STR(a) __STR(a)
 const char * _http_method_str[] = {
@@ -95,6 +100,7 @@ bool WebServer::_parseRequest(WiFiClient& client) {
   String url = req.substring(addr_start + 1, addr_end);
   String versionEnd = req.substring(addr_end + 8);
   _currentVersion = atoi(versionEnd.c_str());
+  _persistent = _currentVersion > 0;
   String searchStr = "";
   int hasSearch = url.indexOf('?');
   if (hasSearch != -1){
@@ -170,6 +176,8 @@ bool WebServer::_parseRequest(WiFiClient& client) {
         contentLength = headerValue.toInt();
       } else if (headerName.equalsIgnoreCase(F("Host"))){
         _hostHeader = headerValue;
+      } else if (headerName.equalsIgnoreCase(F("Connection"))){
+        _persistent = !headerValue.equalsIgnoreCase(F("close")) && (_currentVersion || headerValue.equalsIgnoreCase(F("keep-alive")));
       }
     }
 
@@ -229,6 +237,8 @@ bool WebServer::_parseRequest(WiFiClient& client) {
 
 	  if (headerName.equalsIgnoreCase("Host")){
         _hostHeader = headerValue;
+      } else if (headerName.equalsIgnoreCase(F("Connection"))){
+        _persistent = !headerValue.equalsIgnoreCase(F("close")) && (_currentVersion || headerValue.equalsIgnoreCase(F("keep-alive")));
       }
     }
     _parseArguments(searchStr);
@@ -251,6 +261,185 @@ bool WebServer::_collectHeader(const char* headerName, const char* headerValue)
   return false;
 }
 
+// Parses a request _pollClient() found complete in a client slot. Arguments and
+// headers stay (offset, length) views of the arena, nothing is copied or decoded
+// until a handler asks for it.
+bool WebServer::_parseArena(char* arena, size_t length) {
+  _arena = arena;
+  _currentArgCount = 0;
+  _plainArg = -1;
+  _hostView = _makeView(arena, 0, true);
+  for (int i = 0; i < _headerKeysCount; ++i) {
+    _headerViews[i] = _makeView(arena, 0, true);
+  }
+
+  const char* end = (const char*)memmem(arena, length, "\r\n\r\n", 4);
+  if (!end) {
+    log_e("Invalid request: no end of head");
+    return false;
+  }
+  // First line of HTTP request looks like "GET /path HTTP/1.1"
+  const char* lineEnd = (const char*)memchr(arena, '\r', end + 2 - arena);
+  const char* methodEnd = (const char*)memchr(arena, ' ', lineEnd - arena);
+  const char* urlEnd = methodEnd ? (const char*)memchr(methodEnd + 1, ' ', lineEnd - methodEnd - 1) : nullptr;
+  if (!urlEnd) {
+    log_e("Invalid request: %.*s", (int)(lineEnd - arena), arena);
+    return false;
+  }
+  _currentVersion = lineEnd - urlEnd > 8 ? atoi(urlEnd + 8) : 0;
+  _persistent = _currentVersion > 0;
+
+  HTTPMethod method = HTTP_ANY;
+  size_t methodLength = methodEnd - arena;
+  size_t num_methods = sizeof(_http_method_str) / sizeof(const char *);
+  for (size_t i=0; i<num_methods; i++) {
+    if (strlen(_http_method_str[i]) == methodLength && !strncmp(arena, _http_method_str[i], methodLength)) {
+      method = (HTTPMethod)i;
+      break;
+    }
+  }
+  if (method == HTTP_ANY) {
+    log_e("Unknown HTTP Method: %.*s", (int)methodLength, arena);
+    return false;
+  }
+  _currentMethod = method;
+
+  const char* url = methodEnd + 1;
+  const char* search = (const char*)memchr(url, '?', urlEnd - url);
+  // keeps the buffer of the previous uri, only a longer one allocates
+  _currentUri.clear();
+  _currentUri.concat(url, (search ? search : urlEnd) - url);
+  _chunked = false;
+
+  bool isEncoded = false;
+  size_t contentLength = 0;
+  for (const char* line = lineEnd + 2; line < end; ) {
+    const char* next = (const char*)memchr(line, '\r', end + 2 - line);
+    const char* headerDiv = (const char*)memchr(line, ':', next - line);
+    if (!headerDiv) {
+      break;
+    }
+    const char* value = headerDiv + 1;
+    while (value < next && (*value == ' ' || *value == '\t'))
+      value++;
+    const char* valueEnd = next;
+    while (valueEnd > value && (valueEnd[-1] == ' ' || valueEnd[-1] == '\t'))
+      valueEnd--;
+    size_t nameLength = headerDiv - line;
+    size_t valueLength = valueEnd - value;
+    _collectHeaderView(line, nameLength, value, valueLength);
+
+    if (nameLength == sizeof(Content_Type) - 1 && !strncasecmp(line, Content_Type, nameLength)) {
+      isEncoded = !strncasecmp(value, "application/x-www-form-urlencoded", 33);
+    } else if (nameLength == 14 && !strncasecmp(line, "Content-Length", 14)) {
+      contentLength = strtoul(value, NULL, 10);
+    } else if (nameLength == 4 && !strncasecmp(line, "Host", 4)) {
+      _hostView = _makeView(value, valueLength, true);
+    } else if (nameLength == 10 && !strncasecmp(line, "Connection", 10)) {
+      bool closing = valueLength == 5 && !strncasecmp(value, "close", 5);
+      bool keepAlive = valueLength == 10 && !strncasecmp(value, "keep-alive", 10);
+      _persistent = !closing && (_currentVersion || keepAlive);
+    }
+    line = next + 2;
+  }
+
+  //attach handler
+  RequestHandler* handler;
+  for (handler = _firstHandler; handler; handler = handler->next()) {
+    if (handler->canHandle(_currentMethod, _currentUri))
+      break;
+  }
+  _currentHandler = handler;
+
+  if (search) {
+    _parseArgumentViews(search + 1 - arena, urlEnd - search - 1);
+  }
+  // the body follows the head, _pollClient() waited for all of it
+  size_t bodyOffset = end + 4 - arena;
+  size_t bodyLength = length - bodyOffset < contentLength ? length - bodyOffset : contentLength;
+  if ((method == HTTP_POST || method == HTTP_PUT || method == HTTP_PATCH || method == HTTP_DELETE) && bodyLength) {
+    if (isEncoded) {
+      //url encoded form
+      _parseArgumentViews(bodyOffset, bodyLength);
+    } else if (_currentArgCount < WEBSERVER_MAX_ARGS) {
+      //plain post json or other data
+      _plainArg = _currentArgCount;
+      ArgumentView& arg = _argViews[_currentArgCount++];
+      arg.key = _makeView(arena + bodyOffset, 0, true);
+      arg.value = _makeView(arena + bodyOffset, bodyLength, true);
+    }
+  }
+
+  log_v("Request: %s args: %d", _currentUri.c_str(), _currentArgCount);
+  return true;
+}
+
+void WebServer::_parseArgumentViews(size_t offset, size_t length) {
+  const char* data = _arena + offset;
+  const char* end = data + length;
+  while (data < end) {
+    const char* next = (const char*)memchr(data, '&', end - data);
+    if (!next)
+      next = end;
+    const char* equal_sign = (const char*)memchr(data, '=', next - data);
+    if (!equal_sign) {
+      log_e("arg missing value: %d", _currentArgCount);
+    } else if (_currentArgCount == WEBSERVER_MAX_ARGS) {
+      log_e("Too many args (max: %d) in request.", WEBSERVER_MAX_ARGS);
+      return;
+    } else {
+      ArgumentView& arg = _argViews[_currentArgCount++];
+      arg.key = _makeView(data, equal_sign - data, false);
+      arg.value = _makeView(equal_sign + 1, next - equal_sign - 1, false);
+    }
+    data = next + 1;
+  }
+}
+
+bool WebServer::_collectHeaderView(const char* headerName, size_t nameLength, const char* value, size_t length) {
+  for (int i = 0; i < _headerKeysCount; i++) {
+    const String& key = _currentHeaders[i].key;
+    if (key.length() == nameLength && !strncasecmp(key.c_str(), headerName, nameLength)) {
+      _headerViews[i] = _makeView(value, length, true);
+      return true;
+    }
+  }
+  return false;
+}
+
+WebServer::RequestView WebServer::_makeView(const char* start, size_t length, bool decoded) {
+  RequestView view;
+  view.offset = start - _arena;
+  view.length = length;
+  view.decoded = decoded;
+  return view;
+}
+
+const char* WebServer::_viewText(RequestView& view) {
+  char* text = _arena + view.offset;
+  if (!view.decoded) {
+    view.length = _urlDecodeInPlace(text, view.length);
+    view.decoded = true;
+  }
+  return text;
+}
+
+String WebServer::_viewString(RequestView& view) {
+  const char* text = _viewText(view);
+  return String(text, view.length);
+}
+
+bool WebServer::_viewEquals(RequestView& view, const String& text) {
+  const char* data = _viewText(view);
+  return view.length == text.length() && !memcmp(data, text.c_str(), view.length);
+}
+
+bool WebServer::_argNameEquals(int i, const String& name) {
+  if (i == _plainArg)
+    return name == "plain";
+  return _viewEquals(_argViews[i].key, name);
+}
+
 void WebServer::_parseArguments(String data) {
   log_v("args: %s", data.c_str());
   if (_currentArgs)
@@ -300,85 +489,200 @@ void WebServer::_parseArguments(String data) {
 
 }
 
-void WebServer::_uploadWriteByte(uint8_t b){
-  if (_currentUpload->currentSize == HTTP_UPLOAD_BUFLEN){
-    if(_currentHandler && _currentHandler->canUpload(_currentUri))
-      _currentHandler->upload(*this, _currentUri, *_currentUpload);
-    _currentUpload->totalSize += _currentUpload->currentSize;
-    _currentUpload->currentSize = 0;
+#ifndef WEBSERVER_BYTEWISE_UPLOAD
+// builds with WEBSERVER_BYTEWISE_UPLOAD link the previous byte at a time parser instead
+
+// The form is read in blocks into the buffer of the upload. data[pos, end) is
+// what has not been parsed yet, remaining what the client still has to send.
+struct FormBuffer {
+  uint8_t* data;
+  size_t size;
+  size_t pos;
+  size_t end;
+  size_t from;              // no delimiter starts in data[pos, from)
+  uint32_t remaining;
+  const uint8_t* delimiter; // CR LF "--" boundary
+  size_t delimiterLength;
+  uint8_t skip[256];
+};
+
+static void compactFormBuffer(FormBuffer& form)
+{
+  if (form.pos == 0)
+    return;
+  memmove(form.data, form.data + form.pos, form.end - form.pos);
+  form.end -= form.pos;
+  form.from = form.from > form.pos ? form.from - form.pos : 0;
+  form.pos = 0;
+}
+
+// appends whatever the client has, waiting up to its timeout for the next segment
+static bool fillFormBuffer(WiFiClient& client, FormBuffer& form)
+{
+  compactFormBuffer(form);
+  size_t space = form.size - form.end;
+  if (space > form.remaining)
+    space = form.remaining;
+  if (!space)
+    return false;
+  unsigned long startMillis = millis();
+  unsigned long timeoutMillis = client.getTimeout();
+  for(;;) {
+    int res = client.read(form.data + form.end, space);
+    if (res > 0) {
+      form.end += res;
+      form.remaining -= res;
+      return true;
+    }
+    unsigned long waited = millis() - startMillis;
+    int fd = client.fd();
+    if (res < 0 || fd < 0 || !client.connected() || waited >= timeoutMillis)
+      return false;
+    // sleeps until the segment arrives instead of polling
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(fd, &readable);
+    struct timeval tv;
+    tv.tv_sec = (timeoutMillis - waited) / 1000;
+    tv.tv_usec = ((timeoutMillis - waited) % 1000) * 1000;
+    select(fd + 1, &readable, NULL, NULL, &tv);
   }
-  _currentUpload->buf[_currentUpload->currentSize++] = b;
 }
 
-int WebServer::_uploadReadByte(WiFiClient& client){
-  int res = client.read();
-  if(res < 0) {
-    // keep trying until you either read a valid byte or timeout
-    unsigned long startMillis = millis();
-    long timeoutIntervalMillis = client.getTimeout();
-    boolean timedOut = false;
-    for(;;) {
-      if (!client.connected()) return -1;
-      // loosely modeled after blinkWithoutDelay pattern
-      while(!timedOut && !client.available() && client.connected()){
-        delay(2);
-        timedOut = millis() - startMillis >= timeoutIntervalMillis;
-      }
+// reads a line of the form up to its CR LF, or up to the end of the body
+static bool readFormLine(WiFiClient& client, FormBuffer& form, String& line)
+{
+  line.clear();
+  const uint8_t* lf;
+  while (!(lf = (const uint8_t*)memchr(form.data + form.pos, '\n', form.end - form.pos))) {
+    if (!fillFormBuffer(client, form)) {
+      line.concat((const char*)form.data + form.pos, form.end - form.pos);
+      form.pos = form.end;
+      return line.length() > 0;
+    }
+  }
+  size_t length = lf - (form.data + form.pos);
+  line.concat((const char*)form.data + form.pos, (length && lf[-1] == '\r') ? length - 1 : length);
+  form.pos += length + 1;
+  return true;
+}
 
-      res = client.read();
-      if(res >= 0) {
-        return res; // exit on a valid read
-      }
-      // NOTE: it is possible to get here and have all of the following
-      //       assertions hold true
-      //
-      //       -- client.available() > 0
-      //       -- client.connected == true
-      //       -- res == -1
-      //
-      //       a simple retry strategy overcomes this which is to say the
-      //       assertion is not permanent, but the reason that this works
-      //       is elusive, and possibly indicative of a more subtle underlying
-      //       issue
-
-      timedOut = millis() - startMillis >= timeoutIntervalMillis;
-      if(timedOut) {
-        return res; // exit on a timeout
-      }
+// Boyer-Moore-Horspool search for the delimiter in data[from, end). Returns where
+// it starts, or else where a delimiter cut off by the end of the data could start
+static size_t searchFormDelimiter(const FormBuffer& form, bool& found)
+{
+  const uint8_t* text = form.data;
+  const uint8_t* pattern = form.delimiter;
+  size_t last = form.delimiterLength - 1;
+  size_t i = form.from;
+  while (i + last < form.end) {
+    uint8_t c = text[i + last];
+    if (c == pattern[last] && !memcmp(text + i, pattern, last)) {
+      found = true;
+      return i;
+    }
+    i += form.skip[c];
+  }
+  found = false;
+  for (i = form.end - form.from > last ? form.end - last : form.from; i < form.end; i++) {
+    const uint8_t* cr = (const uint8_t*)memchr(text + i, '\r', form.end - i);
+    if (!cr)
+      break;
+    i = cr - text;
+    if (!memcmp(text + i, pattern, form.end - i))
+      return i;
+  }
+  return form.end;
+}
+
+// Moves the next block of part data to the start of the buffer. It ends where the
+// buffer is full or at the delimiter, which sets last and is skipped
+static bool nextFormData(WiFiClient& client, FormBuffer& form, size_t& length, bool& last)
+{
+  for(;;) {
+    compactFormBuffer(form);
+    size_t at = searchFormDelimiter(form, last);
+    if (last || form.end == form.size) {
+      length = at;
+      form.pos = last ? at + form.delimiterLength : at;
+      form.from = form.pos;
+      return true;
     }
+    form.from = at;
+    if (!fillFormBuffer(client, form))
+      return false;
   }
+}
 
-  return res;
+// field values keep the line breaks of a textarea as '\n', like before
+static void appendFormValue(String& value, const uint8_t* data, size_t length)
+{
+  size_t start = 0;
+  for (size_t i = 0; i + 1 < length; i++) {
+    if (data[i] == '\r' && data[i + 1] == '\n') {
+      value.concat((const char*)data + start, i - start);
+      start = ++i;
+    }
+  }
+  value.concat((const char*)data + start, length - start);
 }
 
 bool WebServer::_parseForm(WiFiClient& client, String boundary, uint32_t len){
-  (void) len;
   log_v("Parse Form: Boundary: %s Length: %d", boundary.c_str(), len);
+  String delimiter = "\r\n--" + boundary;
+  if (delimiter.length() > 255 || delimiter.length() * 2 > HTTP_UPLOAD_BUFLEN){
+    log_e("Error: boundary too long: %s", boundary.c_str());
+    return false;
+  }
+  // the handler gets file data in the buffer it was read into
+  _currentUpload.reset(new HTTPUpload());
+  FormBuffer form;
+  form.data = _currentUpload->buf;
+  form.size = HTTP_UPLOAD_BUFLEN;
+  form.pos = form.end = form.from = 0;
+  form.remaining = len ? len : UINT32_MAX;
+  form.delimiter = (const uint8_t*)delimiter.c_str();
+  form.delimiterLength = delimiter.length();
+  memset(form.skip, form.delimiterLength, sizeof(form.skip));
+  for (size_t i = 0; i + 1 < form.delimiterLength; i++)
+    form.skip[form.delimiter[i]] = form.delimiterLength - 1 - i;
+
   String line;
+  bool lineRead;
   int retry = 0;
   do {
-    line = client.readStringUntil('\r');
+    lineRead = readFormLine(client, form, line);
     ++retry;
-  } while (line.length() == 0 && retry < 3);
+  } while (lineRead && line.length() == 0 && retry < 3);
 
-  client.readStringUntil('\n');
   //start reading the form
-  if (line == ("--"+boundary)){
-   if(_postArgs) delete[] _postArgs;
-    _postArgs = new RequestArgument[WEBSERVER_MAX_POST_ARGS];
-    _postArgsLen = 0;
+  if (!lineRead || line != ("--"+boundary)){
+    log_e("Error: line: %s", line.c_str());
+    return false;
+  }
+  if(_postArgs) delete[] _postArgs;
+  _postArgs = new RequestArgument[WEBSERVER_MAX_POST_ARGS];
+  _postArgsLen = 0;
+  while(1){
+    String argName;
+    String argValue;
+    String argType;
+    String argFilename;
+    bool argIsFile = false;
+    bool argIsNamed = false;
+    size_t length;
+    bool last;
+
+    using namespace mime;
+    argType = FPSTR(mimeTable[txt].mimeType);
+    //part headers up to the empty line
     while(1){
-      String argName;
-      String argValue;
-      String argType;
-      String argFilename;
-      bool argIsFile = false;
-
-      line = client.readStringUntil('\r');
-      client.readStringUntil('\n');
+      if (!readFormLine(client, form, line)) return false;
+      if (line.length() == 0) break;
       if (line.length() > 19 && line.substring(0, 19).equalsIgnoreCase(F("Content-Disposition"))){
         int nameStart = line.indexOf('=');
         if (nameStart != -1){
+          argIsNamed = true;
           argName = line.substring(nameStart+2);
           nameStart = argName.indexOf('=');
           if (nameStart == -1){
@@ -393,162 +697,83 @@ bool WebServer::_parseForm(WiFiClient& client, String boundary, uint32_t len){
               argFilename = arg(FPSTR(filename));
           }
           log_v("PostArg Name: %s", argName.c_str());
-          using namespace mime;
-          argType = FPSTR(mimeTable[txt].mimeType);
-          line = client.readStringUntil('\r');
-          client.readStringUntil('\n');
-          if (line.length() > 12 && line.substring(0, 12).equalsIgnoreCase(FPSTR(Content_Type))){
-            argType = line.substring(line.indexOf(':')+2);
-            //skip next line
-            client.readStringUntil('\r');
-            client.readStringUntil('\n');
-          }
-          log_v("PostArg Type: %s", argType.c_str());
-          if (!argIsFile){
-            while(1){
-              line = client.readStringUntil('\r');
-              client.readStringUntil('\n');
-              if (line.startsWith("--"+boundary)) break;
-              if (argValue.length() > 0) argValue += "\n";
-              argValue += line;
-            }
-            log_v("PostArg Value: %s", argValue.c_str());
-
-            RequestArgument& arg = _postArgs[_postArgsLen++];
-            arg.key = argName;
-            arg.value = argValue;
-
-            if (line == ("--"+boundary+"--")){
-              log_v("Done Parsing POST");
-              break;
-            } else if (_postArgsLen >= WEBSERVER_MAX_POST_ARGS) {
-              log_e("Too many PostArgs (max: %d) in request.", WEBSERVER_MAX_POST_ARGS);
-              return false;
-            }
-          } else {
-            _currentUpload.reset(new HTTPUpload());
-            _currentUpload->status = UPLOAD_FILE_START;
-            _currentUpload->name = argName;
-            _currentUpload->filename = argFilename;
-            _currentUpload->type = argType;
-            _currentUpload->totalSize = 0;
-            _currentUpload->currentSize = 0;
-            log_v("Start File: %s Type: %s", _currentUpload->filename.c_str(), _currentUpload->type.c_str());
-            if(_currentHandler && _currentHandler->canUpload(_currentUri))
-              _currentHandler->upload(*this, _currentUri, *_currentUpload);
-            _currentUpload->status = UPLOAD_FILE_WRITE;
-            int argByte = _uploadReadByte(client);
-readfile:
-
-            while(argByte != 0x0D){
-                if(argByte < 0) return _parseFormUploadAborted();
-                _uploadWriteByte(argByte);
-                argByte = _uploadReadByte(client);
-            }
-
-            argByte = _uploadReadByte(client);
-            if(argByte < 0) return _parseFormUploadAborted();
-            if (argByte == 0x0A){
-              argByte = _uploadReadByte(client);
-              if(argByte < 0) return _parseFormUploadAborted();
-              if ((char)argByte != '-'){
-                //continue reading the file
-                _uploadWriteByte(0x0D);
-                _uploadWriteByte(0x0A);
-                goto readfile;
-              } else {
-                argByte = _uploadReadByte(client);
-                if(argByte < 0) return _parseFormUploadAborted();
-                if ((char)argByte != '-'){
-                  //continue reading the file
-                  _uploadWriteByte(0x0D);
-                  _uploadWriteByte(0x0A);
-                  _uploadWriteByte((uint8_t)('-'));
-                  goto readfile;
-                }
-              }
-
-              uint8_t endBuf[boundary.length()];
-              uint32_t i = 0;
-              while(i < boundary.length()){
-                argByte = _uploadReadByte(client);
-                if(argByte < 0) return _parseFormUploadAborted();
-                if ((char)argByte == 0x0D){
-                  _uploadWriteByte(0x0D);
-                  _uploadWriteByte(0x0A);
-                  _uploadWriteByte((uint8_t)('-'));
-                  _uploadWriteByte((uint8_t)('-'));
-                  uint32_t j = 0;
-                  while(j < i){
-                    _uploadWriteByte(endBuf[j++]);
-                  }
-                  goto readfile;
-                }
-                endBuf[i++] = (uint8_t)argByte;
-              }
-
-              if (strstr((const char*)endBuf, boundary.c_str()) != NULL){
-                if(_currentHandler && _currentHandler->canUpload(_currentUri))
-                  _currentHandler->upload(*this, _currentUri, *_currentUpload);
-                _currentUpload->totalSize += _currentUpload->currentSize;
-                _currentUpload->status = UPLOAD_FILE_END;
-                if(_currentHandler && _currentHandler->canUpload(_currentUri))
-                  _currentHandler->upload(*this, _currentUri, *_currentUpload);
-                log_v("End File: %s Type: %s Size: %d", _currentUpload->filename.c_str(), _currentUpload->type.c_str(), _currentUpload->totalSize);
-                line = client.readStringUntil(0x0D);
-                client.readStringUntil(0x0A);
-                if (line == "--"){
-                  log_v("Done Parsing POST");
-                  break;
-                }
-                continue;
-              } else {
-                _uploadWriteByte(0x0D);
-                _uploadWriteByte(0x0A);
-                _uploadWriteByte((uint8_t)('-'));
-                _uploadWriteByte((uint8_t)('-'));
-                uint32_t i = 0;
-                while(i < boundary.length()){
-                  _uploadWriteByte(endBuf[i++]);
-                }
-                argByte = _uploadReadByte(client);
-                goto readfile;
-              }
-            } else {
-              _uploadWriteByte(0x0D);
-              goto readfile;
-            }
-            break;
-          }
         }
+      } else if (line.length() > 12 && line.substring(0, 12).equalsIgnoreCase(FPSTR(Content_Type))){
+        argType = line.substring(line.indexOf(':')+2);
       }
     }
-
-    int iarg;
-    int totalArgs = ((WEBSERVER_MAX_POST_ARGS - _postArgsLen) < _currentArgCount)?(WEBSERVER_MAX_POST_ARGS - _postArgsLen):_currentArgCount;
-    for (iarg = 0; iarg < totalArgs; iarg++){
-      RequestArgument& arg = _postArgs[_postArgsLen++];
-      arg.key = _currentArgs[iarg].key;
-      arg.value = _currentArgs[iarg].value;
-    }
-    if (_currentArgs) delete[] _currentArgs;
-    _currentArgs = new RequestArgument[_postArgsLen];
-    for (iarg = 0; iarg < _postArgsLen; iarg++){
-      RequestArgument& arg = _currentArgs[iarg];
-      arg.key = _postArgs[iarg].key;
-      arg.value = _postArgs[iarg].value;
+    log_v("PostArg Type: %s", argType.c_str());
+
+    if (argIsFile){
+      _currentUpload->status = UPLOAD_FILE_START;
+      _staticGeneration++;
+      _currentUpload->name = argName;
+      _currentUpload->filename = argFilename;
+      _currentUpload->type = argType;
+      _currentUpload->totalSize = 0;
+      _currentUpload->currentSize = 0;
+      log_v("Start File: %s Type: %s", _currentUpload->filename.c_str(), _currentUpload->type.c_str());
+      if(_currentHandler && _currentHandler->canUpload(_currentUri))
+        _currentHandler->upload(*this, _currentUri, *_currentUpload);
+      _currentUpload->status = UPLOAD_FILE_WRITE;
+      do {
+        if (!nextFormData(client, form, length, last)) return _parseFormUploadAborted();
+        _currentUpload->currentSize = length;
+        if(_currentHandler && _currentHandler->canUpload(_currentUri))
+          _currentHandler->upload(*this, _currentUri, *_currentUpload);
+        _currentUpload->totalSize += length;
+      } while (!last);
+      _currentUpload->status = UPLOAD_FILE_END;
+      if(_currentHandler && _currentHandler->canUpload(_currentUri))
+        _currentHandler->upload(*this, _currentUri, *_currentUpload);
+      log_v("End File: %s Type: %s Size: %d", _currentUpload->filename.c_str(), _currentUpload->type.c_str(), _currentUpload->totalSize);
+    } else {
+      do {
+        if (!nextFormData(client, form, length, last)) return false;
+        appendFormValue(argValue, form.data, length);
+      } while (!last);
+      if (argIsNamed){
+        log_v("PostArg Value: %s", argValue.c_str());
+        RequestArgument& arg = _postArgs[_postArgsLen++];
+        arg.key = argName;
+        arg.value = argValue;
+      }
     }
-    _currentArgCount = iarg;
-    if (_postArgs) {
-      delete[] _postArgs;
-      _postArgs=nullptr;
-      _postArgsLen = 0;
+
+    //the rest of the delimiter line, "--" after the last part
+    if (!readFormLine(client, form, line)) return false;
+    if (line == "--"){
+      log_v("Done Parsing POST");
+      break;
+    } else if (_postArgsLen >= WEBSERVER_MAX_POST_ARGS) {
+      log_e("Too many PostArgs (max: %d) in request.", WEBSERVER_MAX_POST_ARGS);
+      return false;
     }
-    return true;
   }
-  log_e("Error: line: %s", line.c_str());
-  return false;
+
+  int iarg;
+  int totalArgs = ((WEBSERVER_MAX_POST_ARGS - _postArgsLen) < _currentArgCount)?(WEBSERVER_MAX_POST_ARGS - _postArgsLen):_currentArgCount;
+  for (iarg = 0; iarg < totalArgs; iarg++){
+    RequestArgument& arg = _postArgs[_postArgsLen++];
+    arg.key = _currentArgs[iarg].key;
+    arg.value = _currentArgs[iarg].value;
+  }
+  if (_currentArgs) delete[] _currentArgs;
+  _currentArgs = new RequestArgument[_postArgsLen];
+  for (iarg = 0; iarg < _postArgsLen; iarg++){
+    RequestArgument& arg = _currentArgs[iarg];
+    arg.key = _postArgs[iarg].key;
+    arg.value = _postArgs[iarg].value;
+  }
+  _currentArgCount = iarg;
+  if (_postArgs) {
+    delete[] _postArgs;
+    _postArgs=nullptr;
+    _postArgsLen = 0;
+  }
+  return true;
 }
+#endif
 
 String WebServer::urlDecode(const String& text)
 {
@@ -581,6 +806,27 @@ String WebServer::urlDecode(const String& text)
 	return decoded;
 }
 
+// urlDecode() over the text itself, the decoded text is never longer
+size_t WebServer::_urlDecodeInPlace(char* text, size_t length)
+{
+  char temp[] = "0x00";
+  size_t decoded = 0;
+  size_t i = 0;
+  while (i < length) {
+    char encodedChar = text[i++];
+    if ((encodedChar == '%') && (i + 1 < length)) {
+      temp[2] = text[i++];
+      temp[3] = text[i++];
+      text[decoded++] = strtol(temp, NULL, 16);
+    } else if (encodedChar == '+') {
+      text[decoded++] = ' ';
+    } else {
+      text[decoded++] = encodedChar;  // normal ascii char
+    }
+  }
+  return decoded;
+}
+
 bool WebServer::_parseFormUploadAborted(){
   _currentUpload->status = UPLOAD_FILE_ABORTED;
   if(_currentHandler && _currentHandler->canUpload(_currentUri))
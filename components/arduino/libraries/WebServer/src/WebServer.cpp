@@ -1,6 +1,7 @@
 /*
   WebServer.cpp - Dead simple web-server.
-  Supports only one simultaneous client, knows how to handle GET and POST.
+  Supports one simultaneous client, or several after enableConcurrency(),
+  knows how to handle GET and POST.
 
   Copyright (c) 2014 Ivan Grokhotkov. All rights reserved.
 
@@ -30,14 +31,68 @@
 #include "FS.h"
 #include "detail/RequestHandlersImpl.h"
 #include "mbedtls/md5.h"
+#include <lwip/sockets.h>
+
+#undef write
+#undef close
 
 
 static const char AUTHORIZATION_HEADER[] = "Authorization";
+static const char RANGE_HEADER[] = "Range";
+static const char IF_NONE_MATCH_HEADER[] = "If-None-Match";
+// collected after the user's keys and left out of headers(), header(int) and headerName(int)
+static const int INTERNAL_HEADER_KEYS = 2;
 static const char qop_auth[] PROGMEM = "qop=auth";
 static const char qop_auth_quoted[] PROGMEM = "qop=\"auth\"";
 static const char WWW_Authenticate[] = "WWW-Authenticate";
 static const char Content_Length[] = "Content-Length";
 
+// A client slot's connection with the bytes its arena already took off the
+// socket in front, for requests the String parser reads
+class ArenaClient : public WiFiClient {
+public:
+  ArenaClient(const WiFiClient& client, const char* data, size_t length)
+  : WiFiClient(client)
+  , _data(data)
+  , _length(length)
+  {
+  }
+
+  int available() override {
+    return _length + WiFiClient::available();
+  }
+
+  int read() override {
+    if (!_length)
+      return WiFiClient::read();
+    _length--;
+    return (uint8_t)*_data++;
+  }
+
+  int read(uint8_t* buf, size_t size) override {
+    if (!_length)
+      return WiFiClient::read(buf, size);
+    size_t length = size < _length ? size : _length;
+    memcpy(buf, _data, length);
+    _data += length;
+    _length -= length;
+    return length;
+  }
+
+  int peek() override {
+    return _length ? (uint8_t)*_data : WiFiClient::peek();
+  }
+
+  void flush() override {
+    _length = 0;
+    WiFiClient::flush();
+  }
+
+private:
+  const char* _data;
+  size_t _length;
+};
+
 
 WebServer::WebServer(IPAddress addr, int port)
 : _corsEnabled(false)
@@ -58,6 +113,18 @@ WebServer::WebServer(IPAddress addr, int port)
 , _currentHeaders(nullptr)
 , _contentLength(0)
 , _chunked(false)
+, _persistent(false)
+, _keepAlive(false)
+, _slots(nullptr)
+, _slotCount(0)
+, _nextSlot(0)
+, _slotsLock(NULL)
+, _requestLock(NULL)
+, _arena(nullptr)
+, _plainArg(-1)
+, _headerViews(nullptr)
+, _streamBuffer(nullptr)
+, _staticGeneration(0)
 {
   log_v("WebServer::Webserver(addr=%s, port=%d)", addr.toString().c_str(), port);
 }
@@ -81,6 +148,18 @@ WebServer::WebServer(int port)
 , _currentHeaders(nullptr)
 , _contentLength(0)
 , _chunked(false)
+, _persistent(false)
+, _keepAlive(false)
+, _slots(nullptr)
+, _slotCount(0)
+, _nextSlot(0)
+, _slotsLock(NULL)
+, _requestLock(NULL)
+, _arena(nullptr)
+, _plainArg(-1)
+, _headerViews(nullptr)
+, _streamBuffer(nullptr)
+, _staticGeneration(0)
 {
   log_v("WebServer::Webserver(port=%d)", port);
 }
@@ -89,12 +168,20 @@ WebServer::~WebServer() {
   _server.close();
   if (_currentHeaders)
     delete[]_currentHeaders;
+  if (_headerViews)
+    delete[]_headerViews;
+  free(_streamBuffer);
   RequestHandler* handler = _firstHandler;
   while (handler) {
     RequestHandler* next = handler->next();
     delete handler;
     handler = next;
   }
+  if (_slotCount) {
+    delete[] _slots;
+    vSemaphoreDelete(_slotsLock);
+    vSemaphoreDelete(_requestLock);
+  }
 }
 
 void WebServer::begin() {
@@ -282,6 +369,14 @@ void WebServer::serveStatic(const char* uri, FS& fs, const char* path, const cha
 }
 
 void WebServer::handleClient() {
+  if (_slotCount) {
+    ClientSlot* slot = _selectClient();
+    if (slot) {
+      _serveClient(*slot);
+    }
+    return;
+  }
+
   if (_currentStatus == HC_NONE) {
     WiFiClient client = _server.available();
     if (!client) {
@@ -350,9 +445,257 @@ void WebServer::handleClient() {
   }
 }
 
+// Waits for a slot holding a complete request and claims it for the calling task.
+// Connections still sending their request stay parked in their slots, so a slow
+// client never holds up the others.
+WebServer::ClientSlot* WebServer::_selectClient() {
+  fd_set readable;
+  FD_ZERO(&readable);
+  int maxFd = -1;
+  bool accepting = false;
+  unsigned long now = millis();
+
+  xSemaphoreTake(_slotsLock, portMAX_DELAY);
+  ClientSlot* claimed = _claimClient();
+  if (claimed) {
+    xSemaphoreGive(_slotsLock);
+    return claimed;
+  }
+  for (uint8_t i = 0; i < _slotCount; i++) {
+    ClientSlot& slot = _slots[i];
+    if (slot.status == SLOT_WAIT_READ && now - slot.statusChange > HTTP_MAX_DATA_WAIT) {
+      log_v("client slot %u timed out", i);
+      _releaseClient(slot, false);
+    }
+    if (slot.status == SLOT_FREE || (slot.status == SLOT_WAIT_READ && slot.requests && !slot.received)) {
+      accepting = true;
+    }
+    if (slot.status == SLOT_WAIT_READ) {
+      int fd = slot.client.fd();
+      FD_SET(fd, &readable);
+      if (fd > maxFd)
+        maxFd = fd;
+    }
+  }
+  // with every slot in the middle of a request new connections wait in the backlog
+  int listenFd = _server.fd();
+  if (accepting && listenFd >= 0) {
+    FD_SET(listenFd, &readable);
+    if (listenFd > maxFd)
+      maxFd = listenFd;
+  }
+  xSemaphoreGive(_slotsLock);
+
+  if (maxFd < 0) {
+    if (_nullDelay) {
+      delay(1);
+    }
+    return nullptr;
+  }
+  struct timeval tv;
+  tv.tv_sec = 0;
+  tv.tv_usec = _nullDelay ? 1000 : 0;
+  if (select(maxFd + 1, &readable, NULL, NULL, &tv) <= 0) {
+    return nullptr;
+  }
+
+  xSemaphoreTake(_slotsLock, portMAX_DELAY);
+  for (uint8_t i = 0; i < _slotCount; i++) {
+    ClientSlot& slot = _slots[i];
+    if (slot.status == SLOT_WAIT_READ && FD_ISSET(slot.client.fd(), &readable) && _pollClient(slot)) {
+      slot.status = SLOT_READY;
+    }
+  }
+  if (listenFd >= 0 && FD_ISSET(listenFd, &readable)) {
+    _acceptClient();
+  }
+  claimed = _claimClient();
+  xSemaphoreGive(_slotsLock);
+  return claimed;
+}
+
+// Round robin over the ready slots so a busy connection can't starve the rest
+WebServer::ClientSlot* WebServer::_claimClient() {
+  for (uint8_t n = 0; n < _slotCount; n++) {
+    uint8_t i = (_nextSlot + n) % _slotCount;
+    if (_slots[i].status == SLOT_READY) {
+      _slots[i].status = SLOT_BUSY;
+      _nextSlot = (i + 1) % _slotCount;
+      return &_slots[i];
+    }
+  }
+  return nullptr;
+}
+
+// Takes a pending connection into a free slot. When all slots are taken the
+// connection idle the longest between two requests makes room.
+void WebServer::_acceptClient() {
+  ClientSlot* slot = nullptr;
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < _slotCount; i++) {
+    ClientSlot& candidate = _slots[i];
+    if (candidate.status == SLOT_FREE) {
+      slot = &candidate;
+      break;
+    }
+    if (candidate.status == SLOT_WAIT_READ && candidate.requests && !candidate.received &&
+        (!slot || now - candidate.statusChange > now - slot->statusChange)) {
+      slot = &candidate;
+    }
+  }
+  if (!slot) {
+    return;
+  }
+  WiFiClient client = _server.available();
+  if (!client) {
+    return;
+  }
+  if (slot->status != SLOT_FREE) {
+    log_v("closing idle client to make room");
+    _releaseClient(*slot, false);
+  }
+
+  log_v("New client: client.localIP()=%s", client.localIP().toString().c_str());
+
+  slot->client = client;
+  slot->status = SLOT_WAIT_READ;
+  slot->statusChange = now;
+  slot->received = 0;
+  slot->requests = 0;
+  // the request usually comes with the connection
+  if (_pollClient(*slot)) {
+    slot->status = SLOT_READY;
+  }
+}
+
+// Reads what the client sent since the last call into the slot arena, the
+// socket stays in the select set until the request is complete
+bool WebServer::_pollClient(ClientSlot& slot) {
+  if (slot.received < HTTP_HEAD_BUFLEN) {
+    int length = recv(slot.client.fd(), slot.head + slot.received, HTTP_HEAD_BUFLEN - slot.received, MSG_DONTWAIT);
+    if (length <= 0) {
+      if (length < 0 && (errno == EWOULDBLOCK || errno == EAGAIN)) {
+        return false;
+      }
+      _releaseClient(slot, false);
+      return false;
+    }
+    slot.received += length;
+  }
+  return _requestReady(slot);
+}
+
+// A request is ready once its head and a body that fits the arena are all
+// there. Requests that fit and are not multipart are parsed in the arena, the
+// rest go to the String parser, which reads the arena before the socket.
+bool WebServer::_requestReady(ClientSlot& slot) {
+  slot.requestLength = 0;
+  size_t length = slot.received;
+  const char* head = slot.head;
+  const char* end = (const char*)memmem(head, length, "\r\n\r\n", 4);
+  if (!end) {
+    return length == HTTP_HEAD_BUFLEN;
+  }
+  size_t headLength = end + 4 - head;
+  size_t contentLength = 0;
+  bool multipart = false;
+  for (const char* line = head; line < end; ) {
+    const char* next = (const char*)memchr(line, '\n', end - line);
+    if (!next) {
+      break;
+    }
+    line = next + 1;
+    if (!strncasecmp(line, Content_Length, sizeof(Content_Length) - 1) && line[sizeof(Content_Length) - 1] == ':') {
+      contentLength = strtoul(line + sizeof(Content_Length), NULL, 10);
+    } else if (!strncasecmp(line, "Content-Type:", 13)) {
+      const char* value = line + 13;
+      while (*value == ' ')
+        value++;
+      multipart = !strncasecmp(value, "multipart/", 10);
+    }
+  }
+  if (headLength + contentLength > HTTP_HEAD_BUFLEN) {
+    return true;
+  }
+  if (length < headLength + contentLength) {
+    return false;
+  }
+  if (!multipart) {
+    slot.requestLength = headLength + contentLength;
+  }
+  return true;
+}
+
+void WebServer::_serveClient(ClientSlot& slot) {
+  bool keep = false;
+  size_t length = slot.requestLength;
+  // the terminator takes the place of the first byte of a pipelined request until the handler is done
+  char next = slot.head[length];
+
+  xSemaphoreTake(_requestLock, portMAX_DELAY);
+  _currentClient = slot.client;
+  _keepAlive = false;
+  bool parsed;
+  if (length) {
+    slot.head[length] = '\0';
+    parsed = _parseArena(slot.head, length);
+  } else {
+    ArenaClient client(slot.client, slot.head, slot.received);
+    parsed = _parseRequest(client);
+  }
+  if (parsed) {
+    _currentClient.setTimeout(HTTP_MAX_SEND_WAIT / 1000);
+    _contentLength = CONTENT_LENGTH_NOT_SET;
+    _handleRequest();
+    keep = _keepAlive && _currentClient.connected();
+  }
+  _currentClient = WiFiClient();
+  _currentUpload.reset();
+  _arena = nullptr;
+  xSemaphoreGive(_requestLock);
+
+  // what came after an arena request stays for the next one, the String parser flushed the rest
+  size_t leftover = 0;
+  if (keep && length) {
+    slot.head[length] = next;
+    leftover = slot.received - length;
+    memmove(slot.head, slot.head + length, leftover);
+  }
+
+  xSemaphoreTake(_slotsLock, portMAX_DELAY);
+  _releaseClient(slot, keep);
+  slot.received = leftover;
+  if (leftover && _requestReady(slot)) {
+    slot.status = SLOT_READY;
+  }
+  xSemaphoreGive(_slotsLock);
+}
+
+// Called with _slotsLock held
+void WebServer::_releaseClient(ClientSlot& slot, bool keep) {
+  if (keep) {
+    slot.status = SLOT_WAIT_READ;
+    slot.requests++;
+  } else {
+    slot.client.stop();
+    slot.status = SLOT_FREE;
+    slot.requests = 0;
+  }
+  slot.statusChange = millis();
+  slot.received = 0;
+}
+
 void WebServer::close() {
   _server.close();
   _currentStatus = HC_NONE;
+  if (_slotCount) {
+    xSemaphoreTake(_slotsLock, portMAX_DELAY);
+    for (uint8_t i = 0; i < _slotCount; i++) {
+      if (_slots[i].status != SLOT_BUSY)
+        _releaseClient(_slots[i], false);
+    }
+    xSemaphoreGive(_slotsLock);
+  }
   if(!_headerKeysCount)
     collectHeaders(0, 0);
 }
@@ -383,6 +726,15 @@ void WebServer::enableDelay(boolean value) {
   _nullDelay = value;
 }
 
+void WebServer::enableConcurrency(uint8_t maxClients) {
+  if (_slotCount || !maxClients)
+    return;
+  _slotsLock = xSemaphoreCreateMutex();
+  _requestLock = xSemaphoreCreateMutex();
+  _slots = new ClientSlot[maxClients];
+  _slotCount = maxClients;
+}
+
 void WebServer::enableCORS(boolean value) {
   _corsEnabled = value;
 }
@@ -418,7 +770,13 @@ void WebServer::_prepareHeader(String& response, int code, const char* content_t
 	sendHeader(String(FPSTR("Access-Control-Allow-Methods")), String("*"));
 	sendHeader(String(FPSTR("Access-Control-Allow-Headers")), String("*"));
     }
-    sendHeader(String(F("Connection")), String(F("close")));
+    if (_slotCount && _persistent && (_contentLength != CONTENT_LENGTH_UNKNOWN || _chunked)) {
+      _keepAlive = true;
+      sendHeader(String(F("Connection")), String(F("keep-alive")));
+    } else {
+      _keepAlive = false;
+      sendHeader(String(F("Connection")), String(F("close")));
+    }
 
     response += _responseHeaders;
     response += "\r\n";
@@ -515,7 +873,7 @@ void WebServer::sendContent_P(PGM_P content, size_t size) {
 }
 
 
-void WebServer::_streamFileCore(const size_t fileSize, const String & fileName, const String & contentType)
+void WebServer::_streamFileCore(const size_t fileSize, const String & fileName, const String & contentType, const int code)
 {
   using namespace mime;
   setContentLength(fileSize);
@@ -524,7 +882,142 @@ void WebServer::_streamFileCore(const size_t fileSize, const String & fileName,
       contentType != String(FPSTR(mimeTable[none].mimeType))) {
     sendHeader(F("Content-Encoding"), F("gzip"));
   }
-  send(200, contentType, "");
+  send(code, contentType, "");
+}
+
+// A single "bytes=first-last", "bytes=first-" or "bytes=-suffix" range gives 206,
+// one past the end 416. Anything else is ignored and the whole file is sent
+static int rangeRequest(const String& range, size_t fileSize, size_t& start, size_t& length)
+{
+  if (!range.startsWith(F("bytes=")) || range.indexOf(',') != -1)
+    return 200;
+  const char* first = range.c_str() + 6;
+  char* end;
+  if (*first == '-') {
+    unsigned long suffix = strtoul(first + 1, &end, 10);
+    if (end == first + 1 || *end)
+      return 200;
+    if (!suffix || !fileSize)
+      return 416;
+    length = suffix < fileSize ? suffix : fileSize;
+    start = fileSize - length;
+    return 206;
+  }
+  unsigned long firstByte = strtoul(first, &end, 10);
+  if (end == first || *end != '-')
+    return 200;
+  const char* last = end + 1;
+  unsigned long lastByte = fileSize - 1;
+  if (*last) {
+    lastByte = strtoul(last, &end, 10);
+    if (*end || lastByte < firstByte)
+      return 200;
+  }
+  if (firstByte >= fileSize)
+    return 416;
+  start = firstByte;
+  length = (lastByte < fileSize ? lastByte + 1 : fileSize) - firstByte;
+  return 206;
+}
+
+size_t WebServer::streamFile(fs::File &file, const String& contentType)
+{
+  size_t fileSize = file.size();
+  size_t start = 0;
+  size_t length = fileSize;
+  String range = header(FPSTR(RANGE_HEADER));
+  range.trim();
+  int code = range.length() ? rangeRequest(range, fileSize, start, length) : 200;
+  if (code == 416) {
+    sendHeader(F("Content-Range"), String(F("bytes */")) + fileSize);
+    send(416);
+    return 0;
+  }
+  sendHeader(F("Accept-Ranges"), F("bytes"));
+  if (code == 206)
+    sendHeader(F("Content-Range"), String(F("bytes ")) + start + '-' + (start + length - 1) + '/' + fileSize);
+  _streamFileCore(length, file.name(), contentType, code);
+  if (!length)
+    return 0;
+  size_t written = (start && !file.seek(start)) ? 0 : _streamFileBlocks(file, start, length);
+  // fewer bytes than the head announced leave the connection out of step
+  if (written < length)
+    _keepAlive = false;
+  return written;
+}
+
+// Reads start at block boundaries of the file, so the file system can hand over whole
+// blocks. While the socket cannot take more of one buffer, the next block is read into
+// the other one instead of waiting for the send to finish first
+size_t WebServer::_streamFileBlocks(fs::File &file, size_t start, size_t length)
+{
+  int fd = _currentClient.fd();
+  if (fd < 0)
+    return 0;
+  if (!_streamBuffer)
+    _streamBuffer = (uint8_t*)malloc(2 * HTTP_STREAM_BUFLEN);
+  if (!_streamBuffer)
+    return 0;
+  uint8_t* buffers[2] = { _streamBuffer, _streamBuffer + HTTP_STREAM_BUFLEN };
+  size_t filled[2] = { 0, 0 };
+  int sending = 0;
+  size_t sent = 0;       // of buffers[sending]
+  size_t unread = length;
+  size_t block = HTTP_STREAM_BUFLEN - start % HTTP_STREAM_BUFLEN;
+  size_t written = 0;
+  unsigned long lastProgress = millis();
+
+  auto readBlock = [&](int i) {
+    size_t read = file.read(buffers[i], unread < block ? unread : block);
+    if (!read) {
+      log_e("short read of %s at %u", file.name(), (unsigned)(start + length - unread));
+      return false;
+    }
+    filled[i] = read;
+    unread -= read;
+    block = HTTP_STREAM_BUFLEN;
+    return true;
+  };
+
+  while (written < length) {
+    if (!filled[sending] && !readBlock(sending))
+      break;
+    int res = ::send(fd, buffers[sending] + sent, filled[sending] - sent, MSG_DONTWAIT);
+    if (res > 0) {
+      sent += res;
+      written += res;
+      lastProgress = millis();
+      if (sent == filled[sending]) {
+        filled[sending] = 0;
+        sent = 0;
+        sending = !sending;
+      }
+      continue;
+    }
+    if (res < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+      log_e("send failed on fd %d, errno: %d", fd, errno);
+      break;
+    }
+    // the socket is still busy with this block, read the next one meanwhile
+    if (!filled[!sending] && unread) {
+      if (!readBlock(!sending))
+        break;
+      continue;
+    }
+    unsigned long waited = millis() - lastProgress;
+    if (waited >= HTTP_MAX_SEND_WAIT) {
+      log_e("send timeout after %u of %u bytes", (unsigned)written, (unsigned)length);
+      break;
+    }
+    fd_set writable;
+    FD_ZERO(&writable);
+    FD_SET(fd, &writable);
+    struct timeval tv;
+    tv.tv_sec = (HTTP_MAX_SEND_WAIT - waited) / 1000;
+    tv.tv_usec = ((HTTP_MAX_SEND_WAIT - waited) % 1000) * 1000;
+    select(fd + 1, NULL, &writable, NULL, &tv);
+  }
+  return written;
 }
 
 String WebServer::pathArg(unsigned int i) {
@@ -534,6 +1027,13 @@ String WebServer::pathArg(unsigned int i) {
 }
 
 String WebServer::arg(String name) {
+  if (_arena) {
+    for (int i = 0; i < _currentArgCount; ++i) {
+      if (_argNameEquals(i, name))
+        return _viewString(_argViews[i].value);
+    }
+    return "";
+  }
   for (int j = 0; j < _postArgsLen; ++j) {
 	    if ( _postArgs[j].key == name )
 	      return _postArgs[j].value;
@@ -546,12 +1046,19 @@ String WebServer::arg(String name) {
 }
 
 String WebServer::arg(int i) {
+  if (_arena)
+    return i < _currentArgCount ? _viewString(_argViews[i].value) : String();
   if (i < _currentArgCount)
     return _currentArgs[i].value;
   return "";
 }
 
 String WebServer::argName(int i) {
+  if (_arena) {
+    if (i == _plainArg)
+      return F("plain");
+    return i < _currentArgCount ? _viewString(_argViews[i].key) : String();
+  }
   if (i < _currentArgCount)
     return _currentArgs[i].key;
   return "";
@@ -562,6 +1069,13 @@ int WebServer::args() {
 }
 
 bool WebServer::hasArg(String  name) {
+  if (_arena) {
+    for (int i = 0; i < _currentArgCount; ++i) {
+      if (_argNameEquals(i, name))
+        return true;
+    }
+    return false;
+  }
   for (int j = 0; j < _postArgsLen; ++j) {
 	    if (_postArgs[j].key == name)
 	      return true;
@@ -577,47 +1091,55 @@ bool WebServer::hasArg(String  name) {
 String WebServer::header(String name) {
   for (int i = 0; i < _headerKeysCount; ++i) {
     if (_currentHeaders[i].key.equalsIgnoreCase(name))
-      return _currentHeaders[i].value;
+      return _arena ? _viewString(_headerViews[i]) : _currentHeaders[i].value;
   }
   return "";
 }
 
 void WebServer::collectHeaders(const char* headerKeys[], const size_t headerKeysCount) {
-  _headerKeysCount = headerKeysCount + 1;
+  _headerKeysCount = headerKeysCount + 1 + INTERNAL_HEADER_KEYS;
   if (_currentHeaders)
      delete[]_currentHeaders;
   _currentHeaders = new RequestArgument[_headerKeysCount];
+  if (_headerViews)
+     delete[]_headerViews;
+  _headerViews = new RequestView[_headerKeysCount];
+  // Authorization and the user's keys keep the indices they always had
   _currentHeaders[0].key = FPSTR(AUTHORIZATION_HEADER);
-  for (int i = 1; i < _headerKeysCount; i++){
+  for (int i = 1; i < _headerKeysCount - INTERNAL_HEADER_KEYS; i++){
     _currentHeaders[i].key = headerKeys[i-1];
   }
+  _currentHeaders[_headerKeysCount - 2].key = FPSTR(RANGE_HEADER);
+  _currentHeaders[_headerKeysCount - 1].key = FPSTR(IF_NONE_MATCH_HEADER);
 }
 
 String WebServer::header(int i) {
-  if (i < _headerKeysCount)
-    return _currentHeaders[i].value;
+  if (i < headers())
+    return _arena ? _viewString(_headerViews[i]) : _currentHeaders[i].value;
   return "";
 }
 
 String WebServer::headerName(int i) {
-  if (i < _headerKeysCount)
+  if (i < headers())
     return _currentHeaders[i].key;
   return "";
 }
 
 int WebServer::headers() {
-  return _headerKeysCount;
+  return _headerKeysCount ? _headerKeysCount - INTERNAL_HEADER_KEYS : 0;
 }
 
 bool WebServer::hasHeader(String name) {
   for (int i = 0; i < _headerKeysCount; ++i) {
-    if ((_currentHeaders[i].key.equalsIgnoreCase(name)) &&  (_currentHeaders[i].value.length() > 0))
+    if ((_currentHeaders[i].key.equalsIgnoreCase(name)) &&  ((_arena ? _headerViews[i].length : _currentHeaders[i].value.length()) > 0))
       return true;
   }
   return false;
 }
 
 String WebServer::hostHeader() {
+  if (_arena)
+    return _viewString(_hostView);
   return _hostHeader;
 }
 
@@ -652,6 +1174,9 @@ void WebServer::_handleRequest() {
   if (handled) {
     _finalizeResponse();
   }
+  // a DELETE may have removed a file serveStatic() answers from, uploads are counted as they start
+  if (_currentMethod == HTTP_DELETE)
+    _staticGeneration++;
   _currentUri = "";
 }
 
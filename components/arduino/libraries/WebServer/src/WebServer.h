@@ -1,6 +1,7 @@
 /*
   WebServer.h - Dead simple web-server.
-  Supports only one simultaneous client, knows how to handle GET and POST.
+  Supports one simultaneous client, or several after enableConcurrency(),
+  knows how to handle GET and POST.
 
   Copyright (c) 2014 Ivan Grokhotkov. All rights reserved.
 
@@ -37,6 +38,14 @@ enum HTTPAuthMethod { BASIC_AUTH, DIGEST_AUTH };
 
 #define HTTP_DOWNLOAD_UNIT_SIZE 1436
 
+#ifndef HTTP_STREAM_BUFLEN
+#define HTTP_STREAM_BUFLEN 4096 //file block streamFile() reads at once, one is sent while the next is read
+#endif
+
+#ifndef HTTP_STATIC_CACHE_SIZE
+#define HTTP_STATIC_CACHE_SIZE 16 //files per serveStatic() whose path, type, size and ETag are kept
+#endif
+
 #ifndef HTTP_UPLOAD_BUFLEN
 #define HTTP_UPLOAD_BUFLEN 1436
 #endif
@@ -46,6 +55,18 @@ enum HTTPAuthMethod { BASIC_AUTH, DIGEST_AUTH };
 #define HTTP_MAX_SEND_WAIT 5000 //ms to wait for data chunk to be ACKed
 #define HTTP_MAX_CLOSE_WAIT 2000 //ms to wait for the client to close the connection
 
+#ifndef WEBSERVER_MAX_CLIENTS
+#define WEBSERVER_MAX_CLIENTS 4 //connections served at once after enableConcurrency()
+#endif
+
+#ifndef HTTP_HEAD_BUFLEN
+#define HTTP_HEAD_BUFLEN 1436 //request arena of a client slot, larger or multipart requests go through the String parser
+#endif
+
+#ifndef WEBSERVER_MAX_ARGS
+#define WEBSERVER_MAX_ARGS 32 //arguments of a request parsed in its arena
+#endif
+
 #define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
 #define CONTENT_LENGTH_NOT_SET ((size_t) -2)
 
@@ -58,13 +79,14 @@ typedef struct {
   String  type;
   size_t  totalSize;    // file size
   size_t  currentSize;  // size of data currently in buf
-  uint8_t buf[HTTP_UPLOAD_BUFLEN];
+  uint8_t buf[HTTP_UPLOAD_BUFLEN + 1]; // one spare byte, String::concat() reads past what it appends
 } HTTPUpload;
 
 #include "detail/RequestHandler.h"
 
 namespace fs {
 class FS;
+class File;
 }
 
 class WebServer
@@ -90,6 +112,8 @@ public:
   void on(const Uri &uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn);
   void addHandler(RequestHandler* handler);
   void serveStatic(const char* uri, fs::FS& fs, const char* path, const char* cache_header = NULL );
+  void invalidateStatic() { _staticGeneration++; } // files behind serveStatic() changed, look them up again
+  uint32_t staticGeneration() { return _staticGeneration; }
   void onNotFound(THandlerFunction fn);  //called when handler is not assigned
   void onFileUpload(THandlerFunction fn); //handle file uploads
 
@@ -124,6 +148,11 @@ public:
   void send_P(int code, PGM_P content_type, PGM_P content, size_t contentLength);
 
   void enableDelay(boolean value);
+  // serve up to maxClients keep-alive connections from one select() in handleClient(),
+  // call before begin(). handleClient() may then also be called from several tasks,
+  // they read requests side by side but run the handlers one at a time, so a slow
+  // download through streamFile() still holds up every other task until it is sent
+  void enableConcurrency(uint8_t maxClients = WEBSERVER_MAX_CLIENTS);
   void enableCORS(boolean value = true);
   void enableCrossOrigin(boolean value = true);
 
@@ -138,9 +167,16 @@ public:
 
   template<typename T>
   size_t streamFile(T &file, const String& contentType) {
-    _streamFileCore(file.size(), file.name(), contentType);
-    return _currentClient.write(file);
+    size_t size = file.size();
+    _streamFileCore(size, file.name(), contentType);
+    size_t written = _currentClient.write(file);
+    // fewer bytes than the head announced leave the connection out of step
+    if (written < size)
+      _keepAlive = false;
+    return written;
   }
+  // files are read in aligned blocks ahead of the socket, a Range request gets 206
+  size_t streamFile(fs::File &file, const String& contentType);
 
 protected:
   virtual size_t _currentClientWrite(const char* b, size_t l) { return _currentClient.write( b, l ); }
@@ -158,7 +194,49 @@ protected:
   void _prepareHeader(String& response, int code, const char* content_type, size_t contentLength);
   bool _collectHeader(const char* headerName, const char* headerValue);
 
-  void _streamFileCore(const size_t fileSize, const String & fileName, const String & contentType);
+  void _streamFileCore(const size_t fileSize, const String & fileName, const String & contentType, const int code = 200);
+  size_t _streamFileBlocks(fs::File &file, size_t start, size_t length);
+
+  enum ClientSlotStatus { SLOT_FREE, SLOT_WAIT_READ, SLOT_READY, SLOT_BUSY };
+
+  struct ClientSlot {
+    WiFiClient       client;
+    ClientSlotStatus status = SLOT_FREE;
+    unsigned long    statusChange = 0;
+    size_t           received = 0; // bytes read into the arena, the next request and any pipelined after it
+    size_t           requestLength = 0; // head and body when _parseArena() can take them
+    uint32_t         requests = 0; // served on this connection
+    char             head[HTTP_HEAD_BUFLEN + 1]; // request arena, one spare byte for the terminator
+  };
+
+  // (offset, length) of a token in the request arena, url decoded in place on first use
+  struct RequestView {
+    uint16_t offset;
+    uint16_t length;
+    bool     decoded;
+  };
+
+  struct ArgumentView {
+    RequestView key;
+    RequestView value;
+  };
+
+  ClientSlot* _selectClient();
+  ClientSlot* _claimClient();
+  void _acceptClient();
+  bool _pollClient(ClientSlot& slot);
+  bool _requestReady(ClientSlot& slot);
+  void _serveClient(ClientSlot& slot);
+  void _releaseClient(ClientSlot& slot, bool keep);
+  bool _parseArena(char* arena, size_t length);
+  void _parseArgumentViews(size_t offset, size_t length);
+  bool _collectHeaderView(const char* headerName, size_t nameLength, const char* value, size_t length);
+  RequestView _makeView(const char* start, size_t length, bool decoded);
+  const char* _viewText(RequestView& view);
+  String _viewString(RequestView& view);
+  bool _viewEquals(RequestView& view, const String& text);
+  bool _argNameEquals(int i, const String& name);
+  static size_t _urlDecodeInPlace(char* text, size_t length);
 
   String _getRandomHexString();
   // for extracting Auth parameters
@@ -201,6 +279,24 @@ protected:
   String           _hostHeader;
   bool             _chunked;
 
+  bool             _persistent; // the request lets the connection stay open
+  bool             _keepAlive;  // the response told the client it stays open
+
+  ClientSlot*      _slots;
+  uint8_t          _slotCount;
+  uint8_t          _nextSlot;
+  SemaphoreHandle_t _slotsLock;   // slots and accept
+  SemaphoreHandle_t _requestLock; // the _current* request state while a handler runs
+
+  char*            _arena;      // request parsed by _parseArena(), the views below point into it
+  ArgumentView     _argViews[WEBSERVER_MAX_ARGS];
+  int              _plainArg;   // index of the "plain" body argument or -1
+  RequestView*     _headerViews; // values of the collected headers
+  RequestView      _hostView;
+
+  uint8_t*         _streamBuffer; // two HTTP_STREAM_BUFLEN blocks of streamFile()
+  uint32_t         _staticGeneration; // serveStatic() handlers drop what they cached before a change
+
   String           _snonce;  // Store noance and opaque for future comparison
   String           _sopaque;
   String           _srealm;  // Store the Auth realm between Calls
@@ -89,37 +89,58 @@ public:
 
         log_v("StaticRequestHandler::handle: request=%s _uri=%s\r\n", requestUri.c_str(), _uri.c_str());
 
-        String path(_path);
+        if (!_isFile && requestUri.endsWith("/"))
+            requestUri += "index.htm";
+
+        // a file seen since the last change is answered from what was kept of it,
+        // a matching If-None-Match without touching the file system at all
+        CachedFile* cached = _cached(requestUri, server.staticGeneration());
+        if (cached && _notModified(server, *cached))
+            return true;
+
+        File f;
+        if (cached) {
+            f = _fs.open(cached->path, "r");
+            // written behind our back, the size is all that can be compared for free
+            if (f && f.size() != cached->size)
+                cached = _cache(requestUri, cached->path, cached->contentType, f, server.staticGeneration());
+        } else {
+            String path(_path);
 
-        if (!_isFile) {
             // Base URI doesn't point to a file.
-            // If a directory is requested, look for index file.
-            if (requestUri.endsWith("/")) 
-              requestUri += "index.htm";
-
             // Append whatever follows this URI in request to get the file path.
-            path += requestUri.substring(_baseUriLength);
-        }
-        log_v("StaticRequestHandler::handle: path=%s, isFile=%d\r\n", path.c_str(), _isFile);
-
-        String contentType = getContentType(path);
+            if (!_isFile)
+                path += requestUri.substring(_baseUriLength);
+            log_v("StaticRequestHandler::handle: path=%s, isFile=%d\r\n", path.c_str(), _isFile);
+
+            String contentType = getContentType(path);
+
+            // look for gz file, only if the original specified path is not a gz.  So part only works to send gzip via content encoding when a non compressed is asked for
+            // if you point the the path to gzip you will serve the gzip as content type "application/x-gzip", not text or javascript etc...
+            if (!path.endsWith(FPSTR(mimeTable[gz].endsWith)) && !_fs.exists(path))  {
+                String pathWithGz = path + FPSTR(mimeTable[gz].endsWith);
+                if(_fs.exists(pathWithGz))
+                    path += FPSTR(mimeTable[gz].endsWith);
+            }
 
-        // look for gz file, only if the original specified path is not a gz.  So part only works to send gzip via content encoding when a non compressed is asked for
-        // if you point the the path to gzip you will serve the gzip as content type "application/x-gzip", not text or javascript etc...
-        if (!path.endsWith(FPSTR(mimeTable[gz].endsWith)) && !_fs.exists(path))  {
-            String pathWithGz = path + FPSTR(mimeTable[gz].endsWith);
-            if(_fs.exists(pathWithGz))
-                path += FPSTR(mimeTable[gz].endsWith);
+            f = _fs.open(path, "r");
+            if (f) {
+                cached = _cache(requestUri, path, contentType, f, server.staticGeneration());
+                if (_notModified(server, *cached))
+                    return true;
+            }
         }
-
-        File f = _fs.open(path, "r");
         if (!f || !f.available())
             return false;
 
         if (_cache_header.length() != 0)
             server.sendHeader("Cache-Control", _cache_header);
+        if (cached->eTag.length()) {
+            server.sendHeader("ETag", cached->eTag);
+            server.sendHeader("Last-Modified", cached->lastModified);
+        }
 
-        server.streamFile(f, contentType);
+        server.streamFile(f, cached->contentType);
         return true;
     }
 
@@ -139,12 +160,79 @@ public:
     }
 
 protected:
+    struct CachedFile {
+        String uri;          // as requested, with index.htm appended
+        String path;         // the file sent, ending in .gz when only that one exists
+        String contentType;  // of the uncompressed name
+        size_t size;
+        String eTag;         // empty when the file system keeps no write times
+        String lastModified;
+        uint32_t generation;
+    };
+
+    bool _notModified(WebServer& server, const CachedFile& file) {
+        if (!file.eTag.length())
+            return false;
+        String ifNoneMatch = server.header("If-None-Match");
+        if (ifNoneMatch != "*" && (!ifNoneMatch.length() || ifNoneMatch.indexOf(file.eTag) == -1))
+            return false;
+        server.sendHeader("ETag", file.eTag);
+        if (_cache_header.length() != 0)
+            server.sendHeader("Cache-Control", _cache_header);
+        server.send(304);
+        return true;
+    }
+
+    CachedFile* _cached(const String& uri, uint32_t generation) {
+        for (CachedFile& entry : _files) {
+            if (entry.generation == generation && entry.uri == uri)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    CachedFile* _cache(const String& uri, const String& path, const String& contentType, File& f, uint32_t generation) {
+        CachedFile* entry = nullptr;
+        for (CachedFile& old : _files) {
+            if (old.uri == uri)
+                entry = &old;
+        }
+        if (!entry && _files.size() < HTTP_STATIC_CACHE_SIZE) {
+            // entries are handed out by pointer, the vector must not move them
+            _files.reserve(HTTP_STATIC_CACHE_SIZE);
+            _files.emplace_back();
+            entry = &_files.back();
+        }
+        if (!entry) {
+            entry = &_files[_nextFile];
+            _nextFile = (_nextFile + 1) % HTTP_STATIC_CACHE_SIZE;
+        }
+        entry->uri = uri;
+        entry->path = path;
+        entry->contentType = contentType;
+        entry->size = f.size();
+        entry->generation = generation;
+        entry->eTag = "";
+        entry->lastModified = "";
+        time_t lastWrite = f.getLastWrite();
+        if (lastWrite > 0) {
+            char date[32];
+            struct tm tm;
+            strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", gmtime_r(&lastWrite, &tm));
+            entry->lastModified = date;
+            entry->eTag = String("\"") + String(entry->size, HEX) + '-' + String((uint32_t)lastWrite, HEX) + '"';
+        }
+        return entry;
+    }
+
     FS _fs;
     String _uri;
     String _path;
     String _cache_header;
     bool _isFile;
     size_t _baseUriLength;
+    std::vector<CachedFile> _files; // up to HTTP_STATIC_CACHE_SIZE, replaced round robin
+    size_t _nextFile = 0;
 };
 
 
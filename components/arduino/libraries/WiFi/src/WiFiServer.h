@@ -62,6 +62,7 @@ class WiFiServer : public Server {
     void close();
     void stop();
     operator bool(){return _listening;}
+    int fd() const {return sockfd;}
     int setTimeout(uint32_t seconds);
     void stopAll();
 };
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdint.h>
+
+/* keyframe bits */
+#define FRAME_LEFT          (1 << 0)
+#define FRAME_MIDDLE        (1 << 1)
+#define FRAME_RIGHT         (1 << 2)
+#define FRAME_RGB_KEEP      (1 << 3)    /* light the currently active rgb color */
+#define FRAME_RGB_SWITCH    (1 << 4)    /* advance to the next rgb color and light it */
+
+#define FRAME_BAR_MASK      (FRAME_LEFT | FRAME_MIDDLE | FRAME_RIGHT)
+#define FRAME_RGB_MASK      (FRAME_RGB_KEEP | FRAME_RGB_SWITCH)
+
+typedef uint8_t keyframe_t;
+
+/* animation lengths (in ticks) */
+#define PUMP_LENGTH     5
+#define WORM_LENGTH     8
+#define SNAKE_LENGTH    8
+#define WAVE_LENGTH     6
+
+/**
+ * @brief Builds a keyframe out of single led states
+ *
+ */
+constexpr keyframe_t keyframe(bool left, bool middle, bool right, bool keep, bool change) {
+    return (left ? FRAME_LEFT : 0) | (middle ? FRAME_MIDDLE : 0) | (right ? FRAME_RIGHT : 0) |
+           (change ? FRAME_RGB_SWITCH : (keep ? FRAME_RGB_KEEP : 0));
+}
+
+/*
+ * Per-tick frame generators, evaluated at compile time.
+ * Pump never clears the rgb led, so every tick keeps the active color.
+ */
+constexpr keyframe_t pump_frame(int tick) {
+    return keyframe(tick>0, tick>1, tick>2, true, tick==4);
+}
+
+constexpr keyframe_t worm_frame(int tick) {
+    return keyframe(tick==0 or tick==7, tick==1 or tick==6, tick==2 or tick==5, tick==4, tick==3);
+}
+
+constexpr keyframe_t snake_frame(int tick) {
+    return keyframe(tick==0 or tick==1 or tick==7, tick==1 or tick==2 or tick==6 or tick==7,
+                    tick==2 or tick==3 or tick==5 or tick==6, tick==4 or tick==5, tick==3);
+}
+
+constexpr keyframe_t wave_frame(int tick) {
+    return keyframe(tick==1 or tick==4, tick==0 or tick==5, tick==0 or tick==5, tick==4, tick==1);
+}
+
+/* keyframe tables */
+constexpr keyframe_t pump_frames[PUMP_LENGTH] = {
+    pump_frame(0), pump_frame(1), pump_frame(2), pump_frame(3), pump_frame(4)
+};
+
+constexpr keyframe_t worm_frames[WORM_LENGTH] = {
+    worm_frame(0), worm_frame(1), worm_frame(2), worm_frame(3),
+    worm_frame(4), worm_frame(5), worm_frame(6), worm_frame(7)
+};
+
+constexpr keyframe_t snake_frames[SNAKE_LENGTH] = {
+    snake_frame(0), snake_frame(1), snake_frame(2), snake_frame(3),
+    snake_frame(4), snake_frame(5), snake_frame(6), snake_frame(7)
+};
+
+constexpr keyframe_t wave_frames[WAVE_LENGTH] = {
+    wave_frame(0), wave_frame(1), wave_frame(2), wave_frame(3), wave_frame(4), wave_frame(5)
+};
+
+/* sanity checks of the generated tables */
+static_assert(pump_frames[4] == (FRAME_BAR_MASK | FRAME_RGB_SWITCH), "pump: all bars lit and color switch on the last tick");
+static_assert(worm_frames[3] == FRAME_RGB_SWITCH, "worm: color switch in the middle of the animation");
+static_assert(snake_frames[1] == (FRAME_LEFT | FRAME_MIDDLE), "snake: two bars lit at once");
+static_assert(wave_frames[0] == (FRAME_MIDDLE | FRAME_RIGHT), "wave: starts on the right side");
+
+/* animation rate of the plain speed */
+#define ANIMATION_RATE_ONE 256
+
+struct animation {
+    const keyframe_t* frames;
+    uint8_t length;
+    /* frame rate relative to the speed, ANIMATION_RATE_ONE runs at the speed itself */
+    uint16_t rate;
+};
+
+typedef struct animation animation_t;
+
+/* indexed by the `animations` enum */
+constexpr animation_t animation_table[] = {
+    { pump_frames,  PUMP_LENGTH,  ANIMATION_RATE_ONE },
+    { worm_frames,  WORM_LENGTH,  ANIMATION_RATE_ONE },
+    { snake_frames, SNAKE_LENGTH, ANIMATION_RATE_ONE },
+    { wave_frames,  WAVE_LENGTH,  ANIMATION_RATE_ONE },
+};
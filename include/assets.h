@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Static file embedded into flash by tools/embed_assets.py,
+ * every variant is a complete HTTP response
+ * 
+ */
+struct asset {
+    const char* path;
+    /* strong entity tag, quoted */
+    const char* etag;
+    /* 200 responses with the gzip compressed and the plain body */
+    const uint8_t* gzip_response;
+    size_t gzip_response_length;
+    const uint8_t* identity_response;
+    size_t identity_response_length;
+    /* bodyless 304 response */
+    const uint8_t* not_modified_response;
+    size_t not_modified_response_length;
+};
+
+typedef struct asset asset_t;
+
+/* embedded assets, generated into src/assets.cpp */
+extern const asset_t assets[];
+extern const size_t asset_count;
+
+/**
+ * @brief Looks up an embedded asset
+ * 
+ * @param path request path
+ * @return the asset or NULL
+ */
+const asset_t* asset_find(const char* path);
+
+/**
+ * @brief Checks an If-None-Match header value against the asset
+ * 
+ * @param asset embedded asset
+ * @param if_none_match header value, may be empty
+ * @return true when the client's copy is current
+ */
+bool asset_not_modified(const asset_t* asset, const char* if_none_match);
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+
+/* frame rates are given in frames per 1000 s, 1000 is one frame per second */
+#define FRAME_RATE_SCALE    1000
+/* phase of one frame, a microsecond at rate 1 advances the phase by 1 */
+#define FRAME_CLOCK_ONE     1000000000ULL
+
+/* disciplining, errors are slewed out over 2 s by trimming the rate */
+#define FRAME_CLOCK_SLEW_TIME   2000000
+/* rate trim limit in ppm, 2 % stays invisible */
+#define FRAME_CLOCK_MAX_TRIM    20000
+/* errors of more than two frames are stepped instead of slewed */
+#define FRAME_CLOCK_STEP_LIMIT  (2 * FRAME_CLOCK_ONE)
+
+/**
+ * @brief Time based frame clock, the phase accumulates elapsed time
+ * times rate in integers, so no fraction of a frame is ever lost
+ * and rate changes keep the phase
+ * 
+ */
+struct frame_clock {
+    /* time of the last update in microseconds */
+    int64_t time;
+    /* progress towards the next frame, FRAME_CLOCK_ONE is a whole frame */
+    uint64_t phase;
+    uint32_t rate;
+    /* frames advanced since the start, the position is frame * FRAME_CLOCK_ONE + phase */
+    uint64_t frame;
+    /* rate correction in ppm and the part of it learned from past errors */
+    int32_t trim;
+    int32_t trim_integral;
+};
+
+typedef struct frame_clock frame_clock_t;
+
+/**
+ * @brief Starts the clock, the first advance returns a frame right away
+ * 
+ * @param rate frames per 1000 s
+ * @param now current time in microseconds
+ */
+void frame_clock_init(frame_clock_t* clock, uint32_t rate, int64_t now);
+
+/**
+ * @brief Changes the rate, the time until now still counts at the old rate
+ * 
+ * @param rate frames per 1000 s
+ * @param now current time in microseconds
+ */
+void frame_clock_set_rate(frame_clock_t* clock, uint32_t rate, int64_t now);
+
+/**
+ * @brief Advances the clock to `now`
+ * 
+ * @param now current time in microseconds
+ * @return number of frames elapsed since the last advance
+ */
+uint32_t frame_clock_advance(frame_clock_t* clock, int64_t now);
+
+/**
+ * @brief Position of the clock at `now`, frames since the start
+ * times FRAME_CLOCK_ONE plus the phase
+ * 
+ * @param now current time in microseconds
+ */
+uint64_t frame_clock_position(frame_clock_t* clock, int64_t now);
+
+/**
+ * @brief Steers the clock towards a reference position, small errors
+ * are slewed out through the rate trim (PI loop), large ones are stepped
+ * 
+ * @param reference position of the reference clock at `time`
+ * @param time time the reference position was taken in microseconds
+ * @param now current time in microseconds
+ * @return true when the clock was stepped
+ */
+bool frame_clock_discipline(frame_clock_t* clock, uint64_t reference, int64_t time, int64_t now);
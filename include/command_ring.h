@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+/* ring capacity, has to be a power of two */
+#define COMMAND_RING_SIZE 16
+
+static_assert((COMMAND_RING_SIZE & (COMMAND_RING_SIZE - 1)) == 0, "command ring size has to be a power of two");
+
+struct command_ring_slot {
+    std::atomic<uint32_t> sequence;
+    void* command;
+};
+
+/**
+ * @brief Bounded lock-free multi-producer multi-consumer ring
+ * of command pointers, every slot carries a sequence number telling
+ * whether it is ready to be written or read in the current lap
+ * 
+ */
+struct command_ring {
+    command_ring_slot slots[COMMAND_RING_SIZE];
+    std::atomic<uint32_t> enqueue_position;
+    std::atomic<uint32_t> dequeue_position;
+};
+
+typedef struct command_ring command_ring_t;
+
+/**
+ * @brief Resets the ring, must not race with push/pop
+ * 
+ */
+void command_ring_init(command_ring_t* ring);
+
+/**
+ * @brief Pushes a command, never blocks
+ * 
+ * @return false when the ring is full
+ */
+bool command_ring_push(command_ring_t* ring, void* command);
+
+/**
+ * @brief Pops the oldest command, never blocks
+ * 
+ * @return the command or NULL when the ring is empty
+ */
+void* command_ring_pop(command_ring_t* ring);
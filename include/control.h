@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* fields carried by a state update */
+#define CONTROL_ANIMATION   (1 << 0)
+#define CONTROL_SPEED       (1 << 1)
+#define CONTROL_COLORS      (1 << 2)
+#define CONTROL_BRIGHTNESS  (1 << 3)
+#define CONTROL_RATE        (1 << 4)
+#define CONTROL_FIELDS      (CONTROL_ANIMATION | CONTROL_SPEED | CONTROL_COLORS | CONTROL_BRIGHTNESS | CONTROL_RATE)
+
+/* longest rgb color sequence */
+#define CONTROL_MAX_COLORS      7
+/* state updates in a single request */
+#define CONTROL_MAX_UPDATES     8
+/* timed updates waiting on the device */
+#define CONTROL_MAX_SCHEDULED   16
+/* latest accepted delay of a timed update (1 hour, ms) */
+#define CONTROL_MAX_DELAY       3600000
+/* highest frame rate, frames per 1000 s, the tick runs at 100 Hz */
+#define CONTROL_MAX_RATE        100000
+
+/*
+ * binary payload, all numbers little endian
+ *   header: 'L' 'C' version count
+ *   count records of CONTROL_RECORD_SIZE bytes:
+ *     u32 delay, u8 fields, u8 animation, u8 speed, u8 brightness,
+ *     u8 color count, u8 colors[CONTROL_MAX_COLORS], u32 frame rate
+ */
+#define CONTROL_BINARY_VERSION  2
+#define CONTROL_HEADER_SIZE     4
+#define CONTROL_RECORD_SIZE     20
+
+/**
+ * @brief A set of state fields applied together, values are
+ * the `animations`, `speed` and `rgb_colors` enums, a frame rate
+ * replaces the speed preset
+ * 
+ */
+struct state_update {
+    /* ms after the request arrived, 0 applies right away */
+    uint32_t delay;
+    uint8_t fields;
+    uint8_t animation_type;
+    uint8_t animation_speed;
+    uint8_t brightness;
+    uint8_t color_count;
+    uint8_t colors[CONTROL_MAX_COLORS];
+    /* frames per 1000 s */
+    uint32_t frame_rate;
+};
+
+typedef struct state_update state_update_t;
+
+struct control_request {
+    uint8_t count;
+    state_update_t updates[CONTROL_MAX_UPDATES];
+};
+
+typedef struct control_request control_request_t;
+
+/* names used by the JSON payload, indexed by the enums */
+extern const char* const control_animation_names[];
+extern const char* const control_speed_names[];
+extern const char* const control_color_names[];
+
+/**
+ * @brief Parses a JSON payload, either a single update object or an
+ * array of them, e.g. {"animation":"worm","speed":"high",
+ * "colors":["red","green"],"brightness":128,"delay":500}, "fps":2.5
+ * sets a frame rate instead of "speed"
+ * 
+ * @return false when the payload is malformed or out of range
+ */
+bool control_parse_json(const char* body, size_t length, control_request_t* request);
+
+/**
+ * @brief Parses a binary payload, see the layout above
+ * 
+ * @return false when the payload is malformed or out of range
+ */
+bool control_parse_binary(const uint8_t* body, size_t length, control_request_t* request);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "driver/gpio.h"
+
+/**
+ * @brief Output backend of the frame layer, receives the pins
+ * to be set and the pins to be cleared in a single call
+ * 
+ */
+struct frame_backend {
+    void (*write)(uint32_t set_mask, uint32_t clear_mask);
+};
+
+typedef struct frame_backend frame_backend_t;
+
+/* writes straight to the W1TS/W1TC gpio output registers */
+extern const frame_backend_t gpio_frame_backend;
+
+/**
+ * @brief Selects the pins driven by the frame layer and its backend,
+ * all pins have to be below GPIO_NUM_32
+ * 
+ * @param pin_mask mask of the driven pins
+ * @param backend output backend, `gpio_frame_backend` on the device
+ */
+void frame_init(uint32_t pin_mask, const frame_backend_t* backend);
+
+/**
+ * @brief Stages the level of a single pin for the next commit
+ * 
+ */
+void frame_set_level(gpio_num_t pin, bool level);
+
+/**
+ * @brief Stages the levels of all pins for the next commit,
+ * pins set in `levels` go high, the rest go low
+ * 
+ */
+void frame_set(uint32_t levels);
+
+/**
+ * @brief Applies the staged frame with one set/clear write,
+ * nothing is written when the frame did not change
+ * 
+ */
+void frame_commit(void);
+
+/**
+ * @brief Forces the next commit to write every pin, for
+ * when the outputs were driven past the frame layer
+ * 
+ */
+void frame_invalidate(void);
+
+/**
+ * @brief Returns levels of the last committed frame
+ * 
+ */
+uint32_t frame_committed(void);
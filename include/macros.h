@@ -1,8 +1,17 @@
+#pragma once
+
 /* stack size */
 #define STACK_SIZE 2048
+/* server task, select and printf need more than the default */
+#define SERVER_STACK_SIZE 4096
+
+/* period of the tick timer driving the frame clock (100 Hz) */
+#define TICK_PERIOD 10000
 
-/* ports */
+/* ports, the simulator serves on its own */
+#ifndef HTTP_PORT
 #define HTTP_PORT 80
+#endif
 
 /* pin macros */
 #define RGB_LED_RED     GPIO_NUM_14
@@ -12,69 +21,58 @@
 #define MIDDLE_LED      GPIO_NUM_25
 #define LEFT_LED        GPIO_NUM_26
 
+/* gpio output mask of every led pin */
+#define LED_PIN_MASK ((1UL << RGB_LED_RED) | (1UL << RGB_LED_BLUE) | (1UL << RGB_LED_GREEN) | \
+                      (1UL << RIGHT_LED) | (1UL << MIDDLE_LED) | (1UL << LEFT_LED))
+
+/* led output, 1 crossfades the frames through LEDC pwm, 0 switches the pins on/off */
+#define PWM_OUTPUT      0
+/* pwm duty resolution in bits (8-13) */
+#define PWM_RESOLUTION  10
+/* led output, 1 draws the leds onto a WS2812/SK6812 strip through RMT, takes precedence over pwm */
+#define PIXEL_OUTPUT    0
+#define PIXEL_PIN       GPIO_NUM_13
+#define PIXEL_COUNT     60
+
+/* frame sync between controllers over udp multicast, a follower shows
+   the leader's animation, rate and colors in step with it */
+#define SYNC_OFF        0
+#define SYNC_LEADER     1
+#define SYNC_FOLLOWER   2
+#ifndef SYNC_ROLE
+#define SYNC_ROLE       SYNC_OFF
+#endif
+
+/* live input, 1 listens for Art-Net dmx frames, a running stream replaces the animation */
+#define STREAM_INPUT    0
+#define STREAM_UNIVERSE 0
+/* first dmx channel of the outputs, 1 based */
+#define STREAM_FIRST_CHANNEL 1
+
 /* currently active color on rgb led */
 enum rgb_colors { NONE, RED, BLUE, GREEN };
 
 /* animation aliases */
-enum animations { PUMP_ANIMATION, WORM_ANIMATION, SNAKE_ANIMATION, WAVE_ANIMATION };
+enum animations { PUMP_ANIMATION, WORM_ANIMATION, SNAKE_ANIMATION, WAVE_ANIMATION, ANIMATION_COUNT };
 
 /* animation speed aliases */
-enum speed { SLOW_SPEED, MEDIUM_SPEED, HIGH_SPEED };
+enum speed { SLOW_SPEED, MEDIUM_SPEED, HIGH_SPEED, CUSTOM_SPEED, SPEED_COUNT };
 
 /* mdns macros */
 #define MDNS_DEVICE_NAME "esp32-led-controller"
 
 
-char* html_start = "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n\r\n" \
-"<!DOCTYPE html>" \
+/* followed by the length of the page and an empty line */
+static const char* const html_header = "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: ";
+
+static const char* const html_start = "<!DOCTYPE html>" \
 "<html>\n" \
 "    <head>\n" \
 "        <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0, user-scalable=no\">\n" \
 "        <link rel=\"icon\" href=\"data:;base64,=\">" \
 "        <title>ESP32 LED control</title>\n" \
-"        <style>\n" \
-"            html { \n" \
-"                font-family: Helvetica; \n" \
-"                margin: 0px 0px; \n" \
-"                width: 100vw;\n" \
-"                height: 100vh;\n" \
-"                overflow: auto;" \
-"            }\n" \
-"            body { \n" \
-"                margin-top: 50px;\n" \
-"            } \n" \
-"            h2 { \n" \
-"                margin: 50px auto 30px;\n" \
-"            } \n" \
-"            h4 {\n" \
-"                margin-bottom: 50px;\n" \
-"            }\n" \
-"            p {\n" \
-"                font-size: 14px;\n" \
-"            }\n" \
-"            .buttons {\n" \
-"                display: flex; \n" \
-"                width: 70vh; \n" \
-"            }\n" \
-"            .button {\n" \
-"                display: block;\n" \
-"                width: 70px;\n" \
-"                border: none;\n" \
-"                color: white;\n" \
-"                padding: 10px 20px;\n" \
-"                text-decoration: none;\n" \
-"                font-size: 20px;\n" \
-"                margin: 0px 20px 35px;\n" \
-"                cursor: pointer;\n" \
-"                border-radius: 4px;\n" \
-"            }\n" \
-"            .off { \n" \
-"                background-color: #3498db;\n" \
-"            }\n" \
-"            .on { \n" \
-"                background-color: blue;\n" \
-"            }\n" \
-"        </style>\n" \
+"        <link rel=\"stylesheet\" href=\"/style.css\">\n" \
+"        <script src=\"/live.js\" defer></script>\n" \
 "    </head>\n" \
 "    <body>\n" \
 "        <div class=\"content\">\n" \
@@ -82,17 +80,26 @@ char* html_start = "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n\r\n" \
 "            <h4>Change the animation speed</h2>\n" \
 "            <div class=\"buttons\">\n";
 
-char* html_animation_buttons = "</div>\n<h2>Change the animation</h2>\n" \
+static const char* const html_animation_buttons = "</div>\n<h2>Change the animation</h2>\n" \
 "               <div class=\"buttons\">\n";
 
 
-char* second_row = "</div>\n" \
+static const char* const second_row = "</div>\n" \
 "               <div class=\"buttons\">\n";
 
 
-char* html_end = "</div>\n" \
+static const char* const html_end = "</div>\n" \
 "        </div>\n" \
 "    </body>\n" \
 "</html>\r\n\r\n";
 
-char* page_404 = "HTTP/1.1 404 Not Found\r\n\r\n";
+static const char* const page_404 = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+
+static const char* const bad_request = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n";
+
+static const char* const service_unavailable = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\n\r\n";
+
+static const char* const method_not_allowed = "HTTP/1.1 405 Method Not Allowed\r\nAllow: GET, POST\r\nContent-Length: 0\r\n\r\n";
+
+/* server-sent events, the connection stays open */
+static const char* const event_stream_header = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n\r\n";
@@ -1,5 +1,34 @@
+#pragma once
+
+#include <atomic>
+
+#include "control.h"
+
 struct change_animation_message {
-    char res[20];
+    /* request path, a view into the connection's request line, valid until the response is built */
+    const char* path;
+    /* parsed payload of /control requests */
+    control_request_t control;
+    /* uploaded program of /program/<id> requests, verified and still in the connection's body */
+    const uint8_t* program;
+    size_t program_length;
+    /* set by the state task once the message is handled */
+    std::atomic<bool> handled;
+    /* time the message was pushed into the command ring */
+    int64_t queued;
+    /* response code, its kind (`route_response`) and the state after the change, filled by the state task */
+    int status;
+    int response;
+    int animation_type;
+    int animation_speed;
+    uint32_t frame_rate;
+    /* running program, -1 for the animation */
+    int program_id;
+    uint8_t brightness;
+    uint8_t color_count;
+    uint8_t colors[CONTROL_MAX_COLORS];
+    /* timed updates still waiting */
+    int scheduled;
 };
 
 typedef struct change_animation_message change_animation_message_t;
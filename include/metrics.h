@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * log-linear histograms of microsecond durations, 0-7 us get a bucket each,
+ * every power of two above is split into METRICS_SUB_BUCKETS buckets,
+ * durations from 2^METRICS_MAX_EXPONENT us (16.7 s) on only show in +Inf
+ */
+#define METRICS_LINEAR          8
+#define METRICS_SUB_BUCKETS     4
+#define METRICS_MIN_EXPONENT    3
+#define METRICS_MAX_EXPONENT    24
+#define METRICS_BUCKETS         (METRICS_LINEAR + (METRICS_MAX_EXPONENT - METRICS_MIN_EXPONENT) * METRICS_SUB_BUCKETS)
+
+/* recorded durations */
+enum metrics_histogram_id {
+    /* tick start behind its period, missed periods excluded */
+    METRICS_TICK_LATENESS,
+    METRICS_TICK_DURATION,
+    /* first byte of a request until it is complete */
+    METRICS_REQUEST_PARSE,
+    /* command ring push until the state task pops it */
+    METRICS_QUEUE_WAIT,
+    /* first until last byte of a response */
+    METRICS_RESPONSE_WRITE,
+    METRICS_HISTOGRAM_COUNT
+};
+
+/* counted events */
+enum metrics_counter_id {
+    /* tick periods dropped by skip_unhandled_events */
+    METRICS_MISSED_TICKS,
+    /* state changes staged for nvs and the writes they ended up in */
+    METRICS_STATE_CHANGES,
+    METRICS_FLASH_WRITES,
+    METRICS_COUNTER_COUNT
+};
+
+/**
+ * @brief Records a duration, allocation free and
+ * safe to call from any task including the timer task
+ * 
+ * @param duration duration in microseconds, negative ones count as 0
+ */
+void metrics_record(metrics_histogram_id histogram, int64_t duration);
+
+/**
+ * @brief Adds to a counter, safe to call from any task
+ * 
+ */
+void metrics_count(metrics_counter_id counter, uint32_t count);
+
+/**
+ * @brief Renders all metrics in the Prometheus text format,
+ * histograms list their non-empty buckets only
+ * 
+ * @param buffer output buffer
+ * @param size size of the output buffer
+ * @return length of the text, metrics that don't fit the buffer are
+ * left out whole, never in part
+ */
+size_t metrics_render(char* buffer, size_t size);
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "control.h"
+
+/* nvs namespace and key of the state blob */
+#define PERSIST_NAMESPACE   "led"
+#define PERSIST_KEY         "state"
+#define PERSIST_VERSION     2
+/* nvs key of a stored program, followed by its id */
+#define PERSIST_PROGRAM_KEY "prog"
+/* staged changes are written after 2 s without another change */
+#define PERSIST_QUIET_TIME  2000000
+/* or as soon as 32 changes are staged, so a steady stream of changes still gets saved */
+#define PERSIST_MAX_CHANGES 32
+
+/**
+ * @brief State kept across reboots, written as one blob
+ * 
+ */
+struct persisted_state {
+    uint8_t version;
+    uint8_t animation_type;
+    uint8_t animation_speed;
+    /* saved along, but changes of the color cycle alone are not worth a write */
+    uint8_t active_rgb;
+    uint8_t brightness;
+    uint8_t color_count;
+    uint8_t colors[CONTROL_MAX_COLORS];
+    /* running program, -1 for the animation */
+    int8_t program;
+    uint32_t frame_rate;
+};
+
+typedef struct persisted_state persisted_state_t;
+
+/**
+ * @brief Opens the nvs namespace and reads the stored state
+ * 
+ * @param state stored state, untouched when there is none
+ * @return true when a state of the current version was stored
+ */
+bool persist_begin(persisted_state_t* state);
+
+/**
+ * @brief Stages the current state in RAM, nothing is written yet
+ * 
+ * @param now current time in microseconds
+ */
+void persist_stage(const persisted_state_t* state, int64_t now);
+
+/**
+ * @brief Writes the staged state once the changes went quiet
+ * or too many of them piled up
+ * 
+ * @param now current time in microseconds
+ * @return microseconds until the staged state is due, -1 when nothing is staged
+ */
+int64_t persist_poll(int64_t now);
+
+
+/**
+ * @brief Writes a program right away, programs are stored rarely
+ * 
+ * @param id program slot
+ * @return false when the write failed
+ */
+bool persist_save_program(int id, const uint8_t* program, size_t length);
+
+/**
+ * @brief Reads a stored program, it still has to be verified
+ * 
+ * @param id program slot
+ * @param program buffer of `size` bytes
+ * @return length of the program, 0 when there is none
+ */
+size_t persist_load_program(int id, uint8_t* program, size_t size);
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/* rmt tick, the 80 MHz APB clock divided by 4 */
+#define PIXEL_TICK_NS       50
+/* WS2812/SK6812 bit timings in rmt ticks */
+#define PIXEL_T0H           8       /* 0.40 us */
+#define PIXEL_T0L           17      /* 0.85 us */
+#define PIXEL_T1H           16      /* 0.80 us */
+#define PIXEL_T1L           9       /* 0.45 us */
+/* low time latching the frame (80 us), covers SK6812 and newer WS2812 */
+#define PIXEL_RESET         1600
+
+#define PIXEL_BIT_NS        ((PIXEL_T0H + PIXEL_T0L) * PIXEL_TICK_NS)
+
+static_assert(PIXEL_T0H + PIXEL_T0L == PIXEL_T1H + PIXEL_T1L, "both bits have to last the same time");
+
+/*
+ * rmt_data_t layout: duration0:15, level0:1, duration1:15, level1:1,
+ * every bit is sent high first, then low
+ */
+#define PIXEL_SYMBOL(high, low)     ((uint32_t)(high) | (1UL << 15) | ((uint32_t)(low) << 16))
+#define PIXEL_ZERO                  PIXEL_SYMBOL(PIXEL_T0H, PIXEL_T0L)
+#define PIXEL_ONE                   PIXEL_SYMBOL(PIXEL_T1H, PIXEL_T1L)
+/* both halves low */
+#define PIXEL_RESET_SYMBOL          ((uint32_t)(PIXEL_RESET / 2) | ((uint32_t)(PIXEL_RESET / 2) << 16))
+
+/* symbols of a single byte, most significant bit first */
+#define PIXEL_BIT(value, bit)       ((((value) >> (bit)) & 1) ? PIXEL_ONE : PIXEL_ZERO)
+#define PIXEL_BYTE(value)           { PIXEL_BIT(value, 7), PIXEL_BIT(value, 6), PIXEL_BIT(value, 5), PIXEL_BIT(value, 4), \
+                                      PIXEL_BIT(value, 3), PIXEL_BIT(value, 2), PIXEL_BIT(value, 1), PIXEL_BIT(value, 0) }
+#define PIXEL_ROW(high)             PIXEL_BYTE(high + 0x0), PIXEL_BYTE(high + 0x1), PIXEL_BYTE(high + 0x2), PIXEL_BYTE(high + 0x3), \
+                                    PIXEL_BYTE(high + 0x4), PIXEL_BYTE(high + 0x5), PIXEL_BYTE(high + 0x6), PIXEL_BYTE(high + 0x7), \
+                                    PIXEL_BYTE(high + 0x8), PIXEL_BYTE(high + 0x9), PIXEL_BYTE(high + 0xa), PIXEL_BYTE(high + 0xb), \
+                                    PIXEL_BYTE(high + 0xc), PIXEL_BYTE(high + 0xd), PIXEL_BYTE(high + 0xe), PIXEL_BYTE(high + 0xf)
+
+/* byte -> its 8 rmt symbols, lives in flash */
+constexpr uint32_t pixel_symbols[256][8] = {
+    PIXEL_ROW(0x00), PIXEL_ROW(0x10), PIXEL_ROW(0x20), PIXEL_ROW(0x30),
+    PIXEL_ROW(0x40), PIXEL_ROW(0x50), PIXEL_ROW(0x60), PIXEL_ROW(0x70),
+    PIXEL_ROW(0x80), PIXEL_ROW(0x90), PIXEL_ROW(0xa0), PIXEL_ROW(0xb0),
+    PIXEL_ROW(0xc0), PIXEL_ROW(0xd0), PIXEL_ROW(0xe0), PIXEL_ROW(0xf0),
+};
+
+/* sanity checks of the generated table */
+static_assert(pixel_symbols[0x80][0] == PIXEL_ONE and pixel_symbols[0x80][1] == PIXEL_ZERO, "most significant bit goes first");
+static_assert(pixel_symbols[0x01][7] == PIXEL_ONE and pixel_symbols[0xfe][7] == PIXEL_ZERO, "least significant bit goes last");
+
+/**
+ * @brief Encodes a GRB frame into rmt symbols, one table lookup per byte,
+ * the frame is closed by a reset symbol
+ * 
+ * @param data GRB bytes
+ * @param length number of bytes
+ * @param symbols output, 8 * length + 1 symbols
+ * @return number of written symbols
+ */
+inline size_t pixel_encode(const uint8_t* data, size_t length, uint32_t* symbols) {
+
+    for (size_t i = 0; i < length; i++) {
+        memcpy(symbols + i * 8, pixel_symbols[data[i]], sizeof(pixel_symbols[0]));
+    }
+    symbols[length * 8] = PIXEL_RESET_SYMBOL;
+    return length * 8 + 1;
+
+}
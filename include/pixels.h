@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "driver/gpio.h"
+
+#include "frame.h"
+
+/* bytes per pixel, green red blue */
+#define PIXEL_BYTES         3
+
+/* frame backend drawing the six leds onto the strip, the bars are
+   thirds of the strip lit in the color of the rgb led */
+extern const frame_backend_t pixel_frame_backend;
+
+/**
+ * @brief Sets up the RMT channel and both symbol buffers,
+ * a frame of `count` pixels needs 2 * 96 * count bytes
+ * 
+ * @param pin data pin of the strip
+ * @param count number of pixels
+ * @return false when the channel or the buffers can't be allocated
+ */
+bool pixel_strip_init(gpio_num_t pin, uint16_t count);
+
+/**
+ * @brief Sets a pixel of the frame being drawn
+ * 
+ */
+void pixel_set(uint16_t index, uint8_t red, uint8_t green, uint8_t blue);
+
+/**
+ * @brief Sets a run of pixels of the frame being drawn
+ * 
+ */
+void pixel_fill(uint16_t first, uint16_t count, uint8_t red, uint8_t green, uint8_t blue);
+
+/**
+ * @brief Scales the colors of the following frames
+ * 
+ * @param brightness 0 (off) - 255 (full)
+ */
+void pixel_set_brightness(uint8_t brightness);
+
+/**
+ * @brief Encodes the drawn frame into the back buffer while the
+ * previous frame is still being sent. The frame starts right away when
+ * the wire is free, otherwise a one-shot timer starts it as soon as the
+ * previous frame is out, and a newer frame shown meanwhile replaces it.
+ * Never waits, has to be called from the esp_timer task
+ * 
+ */
+void pixel_show(void);
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "animations.h"
+
+/* stored programs, selected by id */
+#define PROGRAM_SLOTS       8
+/* largest program including the header */
+#define PROGRAM_MAX_SIZE    128
+/* nesting depth of loops */
+#define PROGRAM_MAX_DEPTH   4
+/* instructions a single frame may take, the rest runs in the next frame */
+#define PROGRAM_BUDGET      32
+
+/*
+ * program: 'L' 'P' version, followed by instructions of an opcode and
+ * at most one operand byte, the program starts over after the last one
+ *   FRAME k    shows keyframe k (FRAME_* bits) and ends the frame
+ *   LOOP n     runs the instructions up to the matching END n times (1-255),
+ *              every loop has to show at least one frame
+ *   END        end of the innermost loop
+ *   COLOR c    makes color c (`rgb_colors`) the active rgb color
+ *   RANDOM     makes a random color of the rgb sequence the active one
+ *   FADE f     crossfades the following frames (1) or switches them (0),
+ *              only the pwm output fades
+ */
+#define PROGRAM_VERSION     1
+#define PROGRAM_HEADER_SIZE 3
+
+enum program_opcode { PROGRAM_FRAME = 1, PROGRAM_LOOP, PROGRAM_END, PROGRAM_COLOR, PROGRAM_RANDOM, PROGRAM_FADE };
+
+/**
+ * @brief Execution state of a running program
+ * 
+ */
+struct program_state {
+    uint8_t pc;
+    uint8_t depth;
+    uint8_t loop_start[PROGRAM_MAX_DEPTH];
+    uint8_t loop_left[PROGRAM_MAX_DEPTH];
+    /* xorshift state of RANDOM, never 0 */
+    uint32_t random;
+};
+
+typedef struct program_state program_state_t;
+
+/**
+ * @brief Output of a single frame
+ * 
+ */
+struct program_frame {
+    keyframe_t frame;
+    /* new active color, -1 keeps it */
+    int8_t color;
+    /* new index into the rgb sequence, -1 keeps it */
+    int8_t sequence_index;
+    /* new fade mode, -1 keeps it */
+    int8_t fade;
+};
+
+typedef struct program_frame program_frame_t;
+
+/**
+ * @brief Checks a program before it is stored or run, after that
+ * the interpreter needs no checks of its own
+ * 
+ * @return false when the program is malformed
+ */
+bool program_verify(const uint8_t* program, size_t length);
+
+/**
+ * @brief Starts a program from the beginning
+ * 
+ * @param seed seed of RANDOM
+ */
+void program_start(program_state_t* state, uint32_t seed);
+
+/**
+ * @brief Runs a verified program up to its next frame, at most
+ * PROGRAM_BUDGET instructions
+ * 
+ * @param color_count length of the rgb sequence RANDOM picks from
+ * @param frame output of the frame, color and fade changes are set either way
+ * @param executed executed instructions, may be NULL
+ * @return false when the budget ran out before a frame
+ */
+bool program_step(const uint8_t* program, size_t length, program_state_t* state, uint8_t color_count,
+                  program_frame_t* frame, int* executed);
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "driver/gpio.h"
+
+#include "frame.h"
+
+/* pwm carrier frequency, low enough for 13 bit duty on the 80 MHz APB clock */
+#define PWM_FREQUENCY       5000
+/* supported duty resolutions */
+#define PWM_MIN_RESOLUTION  8
+#define PWM_MAX_RESOLUTION  13
+/* maximum number of pwm driven pins */
+#define PWM_MAX_CHANNELS    8
+
+/* frame backend crossfading the committed frames through LEDC,
+   it and the other duty writers run in the tick only */
+extern const frame_backend_t pwm_frame_backend;
+
+/**
+ * @brief Routes the pin through a LEDC channel, every pin gets
+ * its own LEDC timer, so the resolution can differ per pin
+ * 
+ * @param pin led pin
+ * @param resolution duty resolution in bits, clamped to 8-13
+ * @return true on success, false when all channels are taken
+ */
+bool pwm_attach(gpio_num_t pin, uint8_t resolution);
+
+/**
+ * @brief Detaches all pins from LEDC
+ * 
+ */
+void pwm_detach_all(void);
+
+/**
+ * @brief Advances the running crossfade to `now` and applies a new
+ * brightness, called on every tick, LEDC is only written while a
+ * crossfade runs or after the brightness changed
+ * 
+ * @param now esp_timer time of the tick
+ */
+void pwm_fade(int64_t now);
+
+/**
+ * @brief Sets the duration of the crossfade between two frames,
+ * 0 switches frames immediately
+ * 
+ * @param time fade duration in microseconds
+ */
+void pwm_set_fade_time(uint64_t time);
+
+/**
+ * @brief Sets the brightness of lit pins, taking effect on the next tick
+ * 
+ * @param brightness 0 (off) - 255 (full)
+ */
+void pwm_set_brightness(uint8_t brightness);
+
+/**
+ * @brief Jumps a single pin to a level, a running crossfade of
+ * the pin is dropped, the next frame fades from this level
+ * 
+ * @param pin led pin
+ * @param level 0 (off) - 255 (full)
+ */
+void pwm_set_level(gpio_num_t pin, uint8_t level);
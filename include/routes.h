@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "message.h"
+
+/* longest route name, the request path without query and id */
+#define ROUTE_NAME_SIZE     20
+
+/* how the client task answers a handled route */
+enum route_response { ROUTE_PAGE, ROUTE_JSON };
+
+/**
+ * @brief Parts of a request path besides the route name,
+ * /program/3?seed=7 is the route /program/ with id 3 and query seed=7
+ * 
+ */
+struct route_args {
+    /* query behind '?' without it, empty when there is none */
+    const char* query;
+    /* numeric last path segment, -1 when there is none */
+    long id;
+    /* value of the matched route */
+    int value;
+};
+
+typedef struct route_args route_args_t;
+
+typedef void (*route_handler_t)(change_animation_message_t* message, const route_args_t* args);
+
+/**
+ * @brief Entry of a route table, names ending in '/' besides the root
+ * take a numeric id, `value` is handed to the handler so routes can share one
+ * 
+ */
+struct route {
+    const char* name;
+    route_handler_t handler;
+    route_response response;
+    int value;
+};
+
+typedef struct route route_t;
+
+
+constexpr int route_compare(const char* a, const char* b) {
+
+    return (*a != *b or *a == '\0') ? (unsigned char)*a - (unsigned char)*b : route_compare(a + 1, b + 1);
+
+}
+
+
+/**
+ * @brief Checks at compile time that a route table is strictly sorted,
+ * route_find relies on it
+ * 
+ */
+constexpr bool route_table_sorted(const route_t* routes, size_t count) {
+
+    return count < 2 or (route_compare(routes[0].name, routes[1].name) < 0 and route_table_sorted(routes + 1, count - 1));
+
+}
+
+
+/**
+ * @brief Finds the route of a request path, works on the path itself
+ * 
+ * @param routes route table, sorted by name
+ * @param path request path
+ * @param args id and query of the path, `value` of the route
+ * @return matching route, NULL when there is none
+ */
+const route_t* route_match(const route_t* routes, size_t count, const char* path, route_args_t* args);
+
+/**
+ * @brief Finds a numeric query parameter, key=value pairs are separated by '&'
+ * 
+ * @param value parsed value
+ * @return false when the key is missing or its value is not a number
+ */
+bool route_query_long(const char* query, const char* key, long* value);
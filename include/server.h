@@ -0,0 +1,154 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "message.h"
+#include "command_ring.h"
+
+/* connections served at once, lwip has 10 sockets in total */
+#define SERVER_MAX_CONNECTIONS  6
+/* longest request line, longer ones are answered with 414 */
+#define SERVER_REQUEST_LINE_SIZE 96
+/* request line, kept for the method and path views, and a single header line, longer header lines are skipped */
+#define SERVER_LINE_SIZE        (SERVER_REQUEST_LINE_SIZE + 128)
+/* longest request path, longer ones are answered with 414 */
+#define SERVER_PATH_SIZE        64
+/* longest request method */
+#define SERVER_METHOD_SIZE      8
+/* longest kept If-None-Match value */
+#define SERVER_ETAG_SIZE        48
+/* largest accepted request body */
+#define SERVER_BODY_SIZE        256
+/* small replies built per request by the handler, fits the longest control response */
+#define SERVER_REPLY_SIZE       320
+/* requests served on one persistent connection */
+#define SERVER_MAX_REQUESTS     100
+/* connections without progress are closed after 5 s */
+#define SERVER_IDLE_TIMEOUT     5000000
+/* select timeout while requests wait for the state task (ms) */
+#define SERVER_PENDING_POLL     1
+/* event streams open at once, the other slots stay free for requests */
+#define SERVER_MAX_EVENT_STREAMS 3
+/* select timeout while event streams are open (ms) */
+#define SERVER_EVENT_POLL       20
+/* quiet event streams get a comment after 15 s, so dead viewers are noticed */
+#define SERVER_EVENT_HEARTBEAT  15000000
+
+static_assert(SERVER_MAX_CONNECTIONS <= COMMAND_RING_SIZE, "every pending connection has to fit into the command ring");
+
+/* connection states */
+enum connection_state { CONNECTION_CLOSED, CONNECTION_READING, CONNECTION_READING_BODY, CONNECTION_PENDING, CONNECTION_WRITING, CONNECTION_EVENTS };
+
+struct connection {
+    int fd;
+    connection_state state;
+    /* time of the last progress, drives the idle timeout */
+    int64_t last_activity;
+    /* requests answered on this connection */
+    int requests;
+    /* arrival of the first byte of the current request and start of its response, 0 until then */
+    int64_t request_start;
+    int64_t write_start;
+    /* parsed request line, followed by the head line received so far */
+    char line[SERVER_LINE_SIZE];
+    size_t line_length;
+    /* length of the request line in front of the line buffer, 0 until it is parsed */
+    size_t head_length;
+    /* the rest of an oversized header line is dropped */
+    bool skip_line;
+    /* views into the request line, NULL until it arrives */
+    const char* method;
+    const char* path;
+    size_t path_length;
+    bool keep_alive;
+    bool accepts_gzip;
+    bool binary_body;
+    char if_none_match[SERVER_ETAG_SIZE];
+    /* request body, Content-Length bytes long */
+    uint8_t body[SERVER_BODY_SIZE];
+    size_t content_length;
+    size_t body_length;
+    /* request handed to the state task */
+    change_animation_message_t message;
+    /* buffer for replies built per request */
+    char reply[SERVER_REPLY_SIZE];
+    /* response, owned by the handler, and the part of it already sent */
+    const char* response;
+    size_t response_length;
+    size_t response_offset;
+    /* server-sent event stream, waits for events instead of requests after the response */
+    bool event_stream;
+    /* owned by the event handler, what the stream has already been sent */
+    uint32_t event_cursor[2];
+};
+
+typedef struct connection connection_t;
+
+/**
+ * @brief Method and path of a request line, views into the line itself
+ * 
+ */
+struct server_request_line {
+    const char* method;
+    size_t method_length;
+    const char* path;
+    size_t path_length;
+    /* HTTP/1.1, older clients have to ask for a persistent connection */
+    bool http11;
+};
+
+typedef struct server_request_line server_request_line_t;
+
+/**
+ * @brief Request handlers of the server, called from the server task
+ * 
+ */
+struct server_handler {
+    /* request head and body complete, either hands connection->message over to the state task
+       and returns true, or points connection->response at a reply and returns false */
+    bool (*request)(connection_t* connection);
+    /* connection->message was handled, points connection->response at a buffer
+       that stays valid until the response is sent */
+    void (*respond)(connection_t* connection);
+    /* event stream is idle, writes the next event into connection->reply
+       and returns its length, 0 when there is nothing new */
+    size_t (*event)(connection_t* connection);
+};
+
+typedef struct server_handler server_handler_t;
+
+/**
+ * @brief Splits a request line in place, method and path end up
+ * NUL terminated inside the line, nothing is copied
+ * 
+ * @param line request line without the line break
+ * @param length length of the line
+ * @return 200 for a valid line, 400 when it is malformed, 414 when the line or the path is too long
+ */
+int server_parse_request_line(char* line, size_t length, server_request_line_t* request);
+
+/**
+ * @brief Opens the non-blocking listening socket
+ * 
+ * @param port tcp port
+ * @return false when the socket can't be set up
+ */
+bool server_begin(uint16_t port);
+
+/**
+ * @brief Turns the connection into a server-sent event stream once
+ * the response head is sent, called by the request handler
+ * 
+ * @return false when SERVER_MAX_EVENT_STREAMS streams are open
+ */
+bool server_event_stream(connection_t* connection);
+
+/**
+ * @brief Serves all connections from a single select loop, never returns.
+ * The loop blocks in select while nothing happens, so an idle server
+ * costs no cpu time
+ * 
+ * @param handler request handlers
+ */
+void server_run(const server_handler_t* handler);
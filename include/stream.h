@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Art-Net udp port */
+#define STREAM_PORT             6454
+/* without frames for 2 s the animation takes over again */
+#define STREAM_TIMEOUT          2000000
+/* a frame up to 20 sequence numbers behind the last one arrived out of order */
+#define STREAM_SEQUENCE_WINDOW  20
+/* channels of a dmx universe */
+#define STREAM_UNIVERSE_SIZE    512
+
+/*
+ * ArtDmx packet, the header is read in place
+ *   "Art-Net\0", u16 opcode 0x5000 (little endian), u16 protocol version (big endian),
+ *   u8 sequence, u8 physical, u16 universe (little endian), u16 length (big endian),
+ *   length channel values
+ */
+#define STREAM_HEADER_SIZE      18
+#define STREAM_OPCODE_DMX       0x5000
+#define STREAM_PROTOCOL         14
+
+/**
+ * @brief Dmx frame parsed out of a packet, the channels
+ * point into the packet buffer
+ * 
+ */
+struct stream_frame {
+    const uint8_t* channels;
+    uint16_t count;
+    uint16_t universe;
+    /* 0 when the sender doesn't number its frames */
+    uint8_t sequence;
+};
+
+typedef struct stream_frame stream_frame_t;
+
+/**
+ * @brief Frame counters since the start
+ * 
+ */
+struct stream_stats {
+    /* frames of our universe */
+    uint32_t received;
+    /* frames written to the outputs */
+    uint32_t shown;
+    /* frames replaced by a newer one before the next tick */
+    uint32_t superseded;
+    /* frames dropped for an old sequence number */
+    uint32_t out_of_order;
+    /* packets which aren't ArtDmx */
+    uint32_t invalid;
+};
+
+typedef struct stream_stats stream_stats_t;
+
+/**
+ * @brief Parses an ArtDmx packet without copying it
+ * 
+ * @return false when the packet isn't a valid ArtDmx packet
+ */
+bool stream_parse(const uint8_t* data, size_t length, stream_frame_t* frame);
+
+/**
+ * @brief Starts listening for dmx frames
+ * 
+ * @return true on success
+ */
+bool stream_begin(void);
+
+/**
+ * @brief Writes the latest frame to the outputs, called by the tick
+ * in place of the animation frame
+ * 
+ * @param now current time in microseconds
+ * @return true while a stream is running, the animation must not be shown
+ */
+bool stream_tick(int64_t now);
+
+/**
+ * @brief Copies the frame counters
+ * 
+ */
+void stream_get_stats(stream_stats_t* stats);
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* multicast group and port shared by all controllers in a room */
+#define SYNC_GROUP_ADDRESS  239, 255, 76, 83
+#define SYNC_PORT           4483
+/* the leader sends one beacon per beat, 4 per second */
+#define SYNC_BEACON_PERIOD  250000
+
+/*
+ * beacon, all numbers little endian
+ *   'L' 'S' version animation rgb-index active-rgb
+ *   u32 frame rate, u64 position of the leader's frame clock
+ */
+#define SYNC_VERSION        1
+#define SYNC_BEACON_SIZE    18
+
+/**
+ * @brief State the leader shares with its followers
+ * 
+ */
+struct sync_beacon {
+    /* frame clock position, FRAME_CLOCK_ONE per frame */
+    uint64_t position;
+    /* leader: time the position was taken, follower: time the beacon arrived */
+    int64_t time;
+    uint32_t frame_rate;
+    uint8_t animation_type;
+    uint8_t rgb_sequence_index;
+    uint8_t active_rgb;
+};
+
+typedef struct sync_beacon sync_beacon_t;
+
+/**
+ * @brief Joins the multicast group, followers start listening for beacons
+ * 
+ * @return true on success
+ */
+bool sync_begin(void);
+
+/**
+ * @brief Tells the leader whether the next beacon is due
+ * 
+ * @param now current time in microseconds
+ */
+bool sync_due(int64_t now);
+
+/**
+ * @brief Multicasts a beacon to the followers
+ * 
+ */
+void sync_send(const sync_beacon_t* beacon);
+
+/**
+ * @brief Takes the latest beacon which arrived since the last call,
+ * older ones are superseded
+ * 
+ * @return true when there was one
+ */
+bool sync_receive(sync_beacon_t* beacon);
+
+/**
+ * @brief Packs a beacon into SYNC_BEACON_SIZE bytes
+ * 
+ */
+void sync_encode(const sync_beacon_t* beacon, uint8_t* data);
+
+/**
+ * @brief Unpacks a beacon, the receive time is left to the caller
+ * 
+ * @return false when the data is no beacon
+ */
+bool sync_decode(const uint8_t* data, size_t length, sync_beacon_t* beacon);
@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <random>
+
+#include "driver/gpio.h"
+#include "macros.h"
+#include "animations.h"
+
+/*
+ * Replays the keyframe tables the way show_frame maps them onto the pins and
+ * compares every tick with the gpio levels the per-animation functions they
+ * replaced used to set, one animation at a time and with random switches
+ * between animations.
+ *   animation_test [switching ticks]
+ */
+
+/* levels written by the previous animation functions */
+static uint32_t levels = 0;
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level) {
+
+    levels = level ? (levels | (1UL << pin)) : (levels & ~(1UL << pin));
+    return ESP_OK;
+
+}
+
+
+/*
+ * The animation functions as they were before the keyframe tables, unchanged
+ */
+static int active_rgb = NONE;
+
+
+void switch_rgb_led_color(void) {
+
+    switch (active_rgb) {
+        case RED: {
+            gpio_set_level(RGB_LED_RED, false);
+            gpio_set_level(RGB_LED_BLUE, true);
+            active_rgb = BLUE;
+        } break;
+        case BLUE: {
+            gpio_set_level(RGB_LED_BLUE, false);
+            gpio_set_level(RGB_LED_GREEN, true);
+            active_rgb = GREEN;
+        } break;
+        case GREEN: {
+            gpio_set_level(RGB_LED_GREEN, false);
+            gpio_set_level(RGB_LED_RED, true);
+            active_rgb = RED;
+        } break;
+        case NONE:
+        default: {
+            gpio_set_level(RGB_LED_RED, true);
+            active_rgb = RED;
+        }
+    }
+
+}
+
+
+void keep_rgb_led_color(void) {
+
+    switch (active_rgb) {
+        case RED: {
+            gpio_set_level(RGB_LED_RED, true);
+        } break;
+        case GREEN: {
+            gpio_set_level(RGB_LED_GREEN, true);
+        } break;
+        case BLUE: {
+            gpio_set_level(RGB_LED_BLUE, true);
+        } break;
+        case NONE:
+        default: {}
+    }
+
+}
+
+
+void unset_rgb_led(void) {
+
+    gpio_set_level(RGB_LED_RED, false);
+    gpio_set_level(RGB_LED_GREEN, false);
+    gpio_set_level(RGB_LED_BLUE, false);
+
+}
+
+
+void animation_pump(void) {
+
+    static int tick = 0, animation_length = 5;
+
+    gpio_set_level(LEFT_LED, tick>0);
+    gpio_set_level(MIDDLE_LED, tick>1);
+    gpio_set_level(RIGHT_LED, tick>2);
+    if (tick==4) { switch_rgb_led_color(); }
+    keep_rgb_led_color();
+    tick++;
+    tick = tick % animation_length;
+}
+
+
+void animation_worm(void) {
+
+    static int tick = 0, animation_length = 8;
+
+    unset_rgb_led();
+    gpio_set_level(LEFT_LED, tick==0 or tick==7);
+    gpio_set_level(MIDDLE_LED, tick==1 or tick==6);
+    gpio_set_level(RIGHT_LED, tick==2 or tick==5);
+    if (tick==3) { switch_rgb_led_color(); }
+    if (tick==4) { keep_rgb_led_color(); }
+    tick++;
+    tick = tick % animation_length;
+
+}
+
+
+void animation_snake(void) {
+
+    static int tick = 0, animation_length = 8;
+
+    unset_rgb_led();
+    gpio_set_level(LEFT_LED, tick==0 or tick==1 or tick==7);
+    gpio_set_level(MIDDLE_LED, tick==1 or tick==2 or tick==6 or tick==7);
+    gpio_set_level(RIGHT_LED, tick==2 or tick==3 or tick==5 or tick==6);
+    if (tick==3) { switch_rgb_led_color(); }
+    if (tick==4 or tick==5) { keep_rgb_led_color(); }
+    tick++;
+    tick = tick % animation_length;
+
+}
+
+
+void animation_wave(void) {
+
+    static int tick = 0, animation_length = 6;
+
+    unset_rgb_led();
+    gpio_set_level(LEFT_LED, tick==1 or tick==4);
+    gpio_set_level(MIDDLE_LED, tick==0 or tick==5);
+    gpio_set_level(RIGHT_LED, tick==0 or tick==5);
+    if (tick==1) { switch_rgb_led_color(); }
+    if (tick==4) { keep_rgb_led_color(); }
+    tick++;
+    tick = tick % animation_length;
+
+}
+
+
+static void (* const animation_functions[ANIMATION_COUNT])(void) = {
+    animation_pump, animation_worm, animation_snake, animation_wave
+};
+
+
+/*
+ * The keyframe side, the pin mapping of show_frame with the default color sequence
+ */
+static const uint32_t bar_pins[FRAME_BAR_MASK + 1] = {
+    0,
+    (1UL << LEFT_LED),
+    (1UL << MIDDLE_LED),
+    (1UL << LEFT_LED) | (1UL << MIDDLE_LED),
+    (1UL << RIGHT_LED),
+    (1UL << LEFT_LED) | (1UL << RIGHT_LED),
+    (1UL << MIDDLE_LED) | (1UL << RIGHT_LED),
+    (1UL << LEFT_LED) | (1UL << MIDDLE_LED) | (1UL << RIGHT_LED),
+};
+
+static const uint32_t rgb_pins[] = { 0, (1UL << RGB_LED_RED), (1UL << RGB_LED_BLUE), (1UL << RGB_LED_GREEN) };
+
+static const uint8_t rgb_sequence[] = { RED, BLUE, GREEN };
+
+static uint8_t frame_index[ANIMATION_COUNT] = { 0 };
+static int table_rgb = NONE;
+static int rgb_sequence_index = 0;
+
+
+static uint32_t table_frame(int type) {
+
+    const animation_t& animation = animation_table[type];
+    keyframe_t frame = animation.frames[frame_index[type]];
+    frame_index[type] = (frame_index[type] + 1) % animation.length;
+
+    if (frame & FRAME_RGB_SWITCH) {
+        rgb_sequence_index = (table_rgb == NONE) ? 0 : (rgb_sequence_index + 1) % sizeof(rgb_sequence);
+        table_rgb = rgb_sequence[rgb_sequence_index];
+    }
+    return bar_pins[frame & FRAME_BAR_MASK] | ((frame & FRAME_RGB_MASK) ? rgb_pins[table_rgb] : 0);
+
+}
+
+
+/**
+ * @brief Runs one tick on both sides
+ *
+ * @return true when the pins are the same
+ */
+static bool compare_tick(int type, long tick) {
+
+    animation_functions[type]();
+    uint32_t expected = levels;
+    uint32_t shown = table_frame(type);
+    if (shown != expected) {
+        printf("animation %d, tick %ld: table sets %08x, functions set %08x\n",
+               type, tick, (unsigned)shown, (unsigned)expected);
+        return false;
+    }
+    return true;
+
+}
+
+
+int main(int argc, char** argv) {
+
+    long ticks = argc > 1 ? atol(argv[1]) : 100000;
+    int failures = 0;
+
+    static_assert(sizeof(animation_table) / sizeof(animation_table[0]) == ANIMATION_COUNT, "a table per animation");
+    for (int type = 0; type < ANIMATION_COUNT; type++) {
+        if (animation_table[type].rate != ANIMATION_RATE_ONE) {
+            printf("animation %d: runs at %u/%u of the speed, the functions ran once per tick\n",
+                   type, animation_table[type].rate, ANIMATION_RATE_ONE);
+            failures++;
+        }
+    }
+
+    /* three full color cycles of every animation on its own, all positions and colors start over for each */
+    for (int type = 0; type < ANIMATION_COUNT; type++) {
+        int length = animation_table[type].length;
+        for (long tick = 0; tick < 3 * 3 * length; tick++) {
+            failures += not compare_tick(type, tick);
+        }
+        /* the next animation starts out of the position this one stopped at */
+        levels = 0;
+        active_rgb = table_rgb = NONE;
+    }
+
+    /* switching animations keeps the positions of each and the shared color */
+    std::mt19937 random(1);
+    int type = PUMP_ANIMATION;
+    for (long tick = 0; tick < ticks and failures < 10; tick++) {
+        if (random() % 7 == 0) { type = random() % ANIMATION_COUNT; }
+        failures += not compare_tick(type, tick);
+    }
+
+    printf("animation tables: %d ticks differ\n", failures);
+    return failures ? 1 : 0;
+
+}
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <random>
+
+#include "esp_timer.h"
+#include "macros.h"
+#include "clock.h"
+
+/*
+ * Runs the frame clock against a fake esp_timer_get_time the test moves by
+ * hand: exact frame counts over long runs with jittery and late ticks, phase
+ * kept across rate changes, and a follower on an oscillator off by ±500 ppm
+ * disciplined towards a leader through beacons, as sync.cpp does.
+ *   clock_test
+ */
+
+/* microseconds on the fake timer, every read returns it unchanged */
+static int64_t fake_time = 0;
+
+int64_t esp_timer_get_time(void) {
+
+    return fake_time;
+
+}
+
+
+static int failures = 0;
+
+
+static void expect(bool condition, const char* what) {
+
+    if (not condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+
+}
+
+
+/**
+ * @brief Frames a clock started at 0 has to have advanced by `elapsed`
+ * at a constant rate, the first one comes right away
+ */
+static uint64_t exact_frames(int64_t elapsed, uint32_t rate) {
+
+    return (FRAME_CLOCK_ONE + (uint64_t)elapsed * rate) / FRAME_CLOCK_ONE;
+
+}
+
+
+/**
+ * @brief Ticks every TICK_PERIOD with up to 3 ms of jitter and now and
+ * then a late one, the frame count has to match the elapsed time exactly
+ */
+static void check_jittery_run(uint32_t rate, long ticks) {
+
+    std::mt19937 random(rate);
+    frame_clock_t clock;
+    fake_time = 0;
+    frame_clock_init(&clock, rate, esp_timer_get_time());
+
+    uint64_t frames = 0;
+    uint64_t most = 0;
+    for (long i = 1; i <= ticks; i++) {
+        int64_t jitter = (int64_t)(random() % 6001) - 3000;
+        if (random() % 500 == 0) { jitter += 80000; }
+        fake_time = i * TICK_PERIOD + jitter;
+        uint32_t advanced = frame_clock_advance(&clock, esp_timer_get_time());
+        frames += advanced;
+        if (advanced > most) { most = advanced; }
+        /* a tick running behind the previous one leaves the clock where it was */
+        if (frames != exact_frames(clock.time, rate)) {
+            printf("rate %u, tick %ld: %llu frames after %lld us, expected %llu\n", (unsigned)rate, i,
+                   (unsigned long long)frames, (long long)clock.time, (unsigned long long)exact_frames(clock.time, rate));
+            failures++;
+            return;
+        }
+    }
+    expect(clock.frame == frames, "clock.frame counts the frames returned");
+    /* a late tick catches up at once instead of spreading the frames out */
+    if (rate >= 10000) { expect(most >= 2, "a late tick returns the frames it missed"); }
+
+}
+
+
+static void check_rate_change(void) {
+
+    frame_clock_t clock;
+    fake_time = 1000;
+    frame_clock_init(&clock, 1000, esp_timer_get_time());
+    expect(frame_clock_advance(&clock, esp_timer_get_time()) == 1, "first frame right away");
+
+    /* half a frame at 1 fps, then 2 fps, the other half takes 250 ms */
+    fake_time += 500000;
+    expect(frame_clock_advance(&clock, esp_timer_get_time()) == 0, "no frame after half of it");
+    frame_clock_set_rate(&clock, 2000, esp_timer_get_time());
+    fake_time += 249999;
+    expect(frame_clock_advance(&clock, esp_timer_get_time()) == 0, "the phase reached is kept");
+    fake_time += 1;
+    expect(frame_clock_advance(&clock, esp_timer_get_time()) == 1, "frame due when the rest of the phase ran out");
+
+    /* setting the same time twice changes nothing, a clock going back is ignored */
+    frame_clock_set_rate(&clock, 2000, esp_timer_get_time());
+    uint64_t position = frame_clock_position(&clock, esp_timer_get_time());
+    expect(frame_clock_position(&clock, esp_timer_get_time() - 5000) == position, "time never runs backwards");
+
+    /* rate 0 stops the clock where it is */
+    frame_clock_set_rate(&clock, 0, esp_timer_get_time());
+    fake_time += 10000000;
+    expect(frame_clock_advance(&clock, esp_timer_get_time()) == 0, "rate 0 holds the frame");
+    expect(frame_clock_position(&clock, esp_timer_get_time()) == position, "rate 0 holds the phase");
+
+}
+
+
+/**
+ * @brief Follower oscillator off by `ppm`, one beacon per second arrives
+ * without delay, the error has to settle below 1 ms within 30 s and
+ * stay there, frames are neither skipped nor repeated
+ */
+static void check_discipline(int ppm, uint32_t rate) {
+
+    std::mt19937 random(ppm + 1000);
+    frame_clock_t leader, follower;
+    const int64_t start = 1000000;
+    frame_clock_init(&leader, rate, start);
+    fake_time = start + start * ppm / 1000000;
+    frame_clock_init(&follower, rate, esp_timer_get_time());
+    /* the follower starts on the leader's frame */
+    frame_clock_discipline(&follower, frame_clock_position(&leader, start), esp_timer_get_time(), esp_timer_get_time());
+
+    int64_t worst = 0;
+    uint64_t leader_frames = 0, follower_frames = 0;
+    uint32_t leader_most = 0, most = 0;
+    for (long i = 1; i <= 60000; i++) {
+        /* true time, both devices tick with their own jitter */
+        int64_t now = start + i * TICK_PERIOD + (int64_t)(random() % 2001) - 1000;
+        uint32_t leader_advanced = frame_clock_advance(&leader, now);
+        leader_frames += leader_advanced;
+        if (leader_advanced > leader_most) { leader_most = leader_advanced; }
+
+        fake_time = now + now * ppm / 1000000;
+        if (i % 100 == 0) {
+            uint64_t reference = frame_clock_position(&leader, now);
+            expect(not frame_clock_discipline(&follower, reference, esp_timer_get_time(), esp_timer_get_time()),
+                   "small errors are slewed, not stepped");
+        }
+        uint32_t advanced = frame_clock_advance(&follower, esp_timer_get_time());
+        follower_frames += advanced;
+        if (advanced > most) { most = advanced; }
+
+        if (i > 3000) {
+            int64_t error = (int64_t)(frame_clock_position(&leader, now) - frame_clock_position(&follower, esp_timer_get_time()));
+            int64_t microseconds = llabs(error) / rate;
+            if (microseconds > worst) { worst = microseconds; }
+        }
+    }
+
+    printf("%+5d ppm follower at %u: worst error %lld us after 30 s, trim %d ppm\n",
+           ppm, (unsigned)rate, (long long)worst, (int)follower.trim);
+    expect(worst < 1000, "follower stays within 1 ms of the leader");
+    expect(llabs((long long)follower_frames - (long long)leader_frames) <= 1, "follower shows as many frames as the leader");
+    expect(most <= leader_most, "slewing never skips a frame");
+    expect(abs(follower.trim + ppm) < 50, "trim settles on the oscillator offset");
+
+}
+
+
+static void check_step_and_clamp(void) {
+
+    frame_clock_t clock;
+    fake_time = 0;
+    frame_clock_init(&clock, 2000, esp_timer_get_time());
+    frame_clock_advance(&clock, esp_timer_get_time());
+
+    /* more than two frames off is stepped onto the reference */
+    uint64_t reference = 10 * FRAME_CLOCK_ONE + 123;
+    expect(frame_clock_discipline(&clock, reference, esp_timer_get_time(), esp_timer_get_time()), "large error steps");
+    expect(clock.frame == 10 and clock.phase == 123 and clock.trim == 0, "step lands on the reference");
+
+    /* the reference kept running since it was taken */
+    fake_time = 1000;
+    expect(frame_clock_discipline(&clock, reference, 0, esp_timer_get_time()) == false, "aged reference is no error");
+    expect(clock.trim == 0, "no trim without an error");
+
+    /* just under the step limit, the trim is clamped */
+    reference = frame_clock_position(&clock, esp_timer_get_time()) + FRAME_CLOCK_STEP_LIMIT - 1;
+    expect(not frame_clock_discipline(&clock, reference, esp_timer_get_time(), esp_timer_get_time()), "error under the limit slews");
+    expect(clock.trim == FRAME_CLOCK_MAX_TRIM, "trim clamped ahead");
+    reference = frame_clock_position(&clock, esp_timer_get_time()) - (FRAME_CLOCK_STEP_LIMIT - 1);
+    for (int i = 0; i < 100; i++) { frame_clock_discipline(&clock, reference, esp_timer_get_time(), esp_timer_get_time()); }
+    expect(clock.trim == -FRAME_CLOCK_MAX_TRIM and clock.trim_integral == -FRAME_CLOCK_MAX_TRIM, "trim and integral clamped behind");
+
+    /* a stopped clock can only be stepped */
+    frame_clock_set_rate(&clock, 0, esp_timer_get_time());
+    expect(frame_clock_discipline(&clock, 5 * FRAME_CLOCK_ONE, esp_timer_get_time(), esp_timer_get_time()), "rate 0 steps");
+
+}
+
+
+int main(void) {
+
+    /* the speed presets, the highest rate and an odd one, 10000 s each */
+    for (uint32_t rate : { 1000u, 2000u, 4000u, 7u, 33333u, (uint32_t)100000 }) {
+        check_jittery_run(rate, 1000000);
+    }
+    check_rate_change();
+    check_discipline(500, 2000);
+    check_discipline(-500, 2000);
+    check_discipline(500, 100000);
+    check_step_and_clamp();
+
+    printf("frame clock: %d checks failed\n", failures);
+    return failures ? 1 : 0;
+
+}
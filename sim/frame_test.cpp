@@ -0,0 +1,160 @@
+#include <stdio.h>
+
+#include <vector>
+
+#include "soc/gpio_struct.h"
+#include "frame.h"
+
+/*
+ * Commits frames through a recording backend and checks the set/clear masks
+ * of every write, that unchanged frames are not written, that invalidated ones
+ * are and that pins outside the mask are never touched. The gpio backend is
+ * checked against the output registers of its own.
+ *   frame_test
+ */
+
+struct write_record {
+    uint32_t set_mask;
+    uint32_t clear_mask;
+};
+
+static std::vector<write_record> writes;
+
+
+static void record_write(uint32_t set_mask, uint32_t clear_mask) {
+
+    writes.push_back({ set_mask, clear_mask });
+
+}
+
+static const frame_backend_t recording_backend = {
+    .write = &record_write
+};
+
+
+/* the output registers behind gpio_frame_backend */
+sim_gpio GPIO;
+static uint32_t register_levels = 0;
+static int register_writes = 0;
+
+sim_gpio_set& sim_gpio_set::operator=(uint32_t mask) {
+
+    register_levels |= mask;
+    register_writes++;
+    return *this;
+
+}
+
+sim_gpio_clear& sim_gpio_clear::operator=(uint32_t mask) {
+
+    register_levels &= ~mask;
+    register_writes++;
+    return *this;
+
+}
+
+
+static int failures = 0;
+
+
+static void expect(bool condition, const char* what) {
+
+    if (not condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+
+}
+
+
+/**
+ * @brief Checks that the last commit wrote exactly one set/clear pair
+ */
+static void expect_write(size_t before, uint32_t set_mask, uint32_t clear_mask, const char* what) {
+
+    bool right = writes.size() == before + 1 and writes.back().set_mask == set_mask
+                 and writes.back().clear_mask == clear_mask;
+    if (not right and writes.size() > before) {
+        printf("%s: wrote set %08x clear %08x, expected set %08x clear %08x\n", what,
+               (unsigned)writes.back().set_mask, (unsigned)writes.back().clear_mask,
+               (unsigned)set_mask, (unsigned)clear_mask);
+    }
+    expect(right, what);
+
+}
+
+
+int main(void) {
+
+    const uint32_t pins = (1UL << 4) | (1UL << 5) | (1UL << 14) | (1UL << 27);
+    size_t before;
+
+    frame_init(pins, &recording_backend);
+
+    /* the first commit drives every pin, even to the levels the pins are thought to have */
+    before = writes.size();
+    frame_commit();
+    expect_write(before, 0, pins, "first commit clears every pin");
+
+    before = writes.size();
+    frame_commit();
+    expect(writes.size() == before, "unchanged frame is not written");
+
+    before = writes.size();
+    frame_set((1UL << 4) | (1UL << 27));
+    frame_commit();
+    expect_write(before, (1UL << 4) | (1UL << 27), (1UL << 5) | (1UL << 14), "one write sets and clears together");
+    expect(frame_committed() == ((1UL << 4) | (1UL << 27)), "committed levels follow the write");
+
+    /* pins outside the mask are neither set nor cleared */
+    before = writes.size();
+    frame_set((1UL << 4) | (1UL << 27) | (1UL << 2) | (1UL << 31));
+    frame_commit();
+    expect(writes.size() == before, "pins outside the mask do not make a change");
+    frame_set((1UL << 5) | (1UL << 3));
+    frame_commit();
+    expect_write(before, (1UL << 5), pins & ~(1UL << 5), "only masked pins are written");
+    expect(frame_committed() == (1UL << 5), "committed levels leave out unmasked pins");
+
+    /* single pins are staged on top of the pending frame */
+    before = writes.size();
+    frame_set_level(GPIO_NUM_14, true);
+    frame_set_level(GPIO_NUM_5, false);
+    frame_set_level(GPIO_NUM_5, true);
+    expect(writes.size() == before, "staging does not write");
+    frame_commit();
+    expect_write(before, (1UL << 5) | (1UL << 14), pins & ~((1UL << 5) | (1UL << 14)), "staged levels commit at once");
+
+    before = writes.size();
+    frame_set_level(GPIO_NUM_14, false);
+    frame_set_level(GPIO_NUM_14, true);
+    frame_commit();
+    expect(writes.size() == before, "a pin set back before the commit is no change");
+
+    /* invalidate forces the next commit only */
+    before = writes.size();
+    frame_invalidate();
+    frame_commit();
+    expect_write(before, (1UL << 5) | (1UL << 14), pins & ~((1UL << 5) | (1UL << 14)), "invalidated frame is written");
+    before = writes.size();
+    frame_commit();
+    expect(writes.size() == before, "invalidate holds for one commit");
+
+    /* a new init starts dark and dirty */
+    before = writes.size();
+    frame_init(pins, &recording_backend);
+    frame_commit();
+    expect_write(before, 0, pins, "init forgets the previous frame");
+
+    /* the gpio backend writes the set and the clear register once each */
+    frame_init(pins, &gpio_frame_backend);
+    register_levels = (1UL << 2) | (1UL << 14);
+    frame_set((1UL << 4) | (1UL << 5));
+    frame_commit();
+    expect(register_writes == 2, "gpio backend writes two registers");
+    expect(register_levels == ((1UL << 2) | (1UL << 4) | (1UL << 5)), "gpio backend leaves other pins alone");
+
+    printf("frame commits: %d checks failed\n", failures);
+    return failures ? 1 : 0;
+
+}
@@ -0,0 +1,225 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "lwip/sockets.h"
+
+#include "server.h"
+
+/*
+ * Measures the cpu time and wakeups of the server while nothing happens, with
+ * no connections and with keep-alive connections left open, and compares them
+ * with the loop it replaced: client_task spinning on a non-blocking accept and
+ * one task per connection polling for data every 1 ms. select is wrapped at
+ * link time to count the wakeups of server_run.
+ *   idle_bench [seconds per run] [port]
+ */
+
+#define IDLE_CONNECTIONS 4
+
+static std::atomic<long> wakeups(0);
+
+extern "C" int __real_select(int count, fd_set* read_set, fd_set* write_set, fd_set* error_set, struct timeval* timeout);
+
+extern "C" int __wrap_select(int count, fd_set* read_set, fd_set* write_set, fd_set* error_set, struct timeval* timeout) {
+
+    int ready = __real_select(count, read_set, write_set, error_set, timeout);
+    wakeups++;
+    return ready;
+
+}
+
+static const char ok[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+
+
+static bool answer(connection_t* connection) {
+
+    connection->response = ok;
+    connection->response_length = sizeof(ok) - 1;
+    return false;
+
+}
+
+
+static void respond(connection_t* connection) {
+
+}
+
+
+static size_t no_events(connection_t* connection) {
+
+    return 0;
+
+}
+
+
+static const server_handler_t handler = { &answer, &respond, &no_events };
+
+
+static int connect_to(int port) {
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        perror("connect");
+        exit(1);
+    }
+    return fd;
+
+}
+
+
+static double cpu_seconds(void) {
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+
+}
+
+
+typedef struct {
+    double cpu_share;
+    double wakeups;
+} idle_result;
+
+
+/**
+ * @brief Sleeps `seconds` and reports the cpu time used meanwhile as a
+ * share of one core and the wakeups counted per second
+ */
+static idle_result measure(double seconds, std::atomic<long>* counter) {
+
+    long woken = counter->load();
+    double cpu = cpu_seconds();
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return { (cpu_seconds() - cpu) / elapsed, (counter->load() - woken) / elapsed };
+
+}
+
+
+/*
+ * The replaced loop, client_task handed accepted connections to connection
+ * tasks which waited for their request with delay(1)
+ */
+static std::atomic<bool> polling(true);
+static std::atomic<long> polls(0);
+
+
+static void polling_connection(int fd) {
+
+    while (polling) {
+        char byte;
+        int received = recv(fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (received == 0 or (received < 0 and errno != EAGAIN and errno != EWOULDBLOCK)) { break; }
+        if (received > 0) { break; }
+        usleep(1000);
+        polls++;
+    }
+    close(fd);
+
+}
+
+
+static void polling_accept(int listen_fd, std::vector<std::thread>* tasks) {
+
+    while (polling) {
+        polls++;
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) { continue; }
+        tasks->emplace_back(polling_connection, fd);
+    }
+
+}
+
+
+static void print_result(const char* loop, const char* state, idle_result result) {
+
+    fprintf(stderr, "%-8s %-24s %9.2f %% %12.0f\n", loop, state, result.cpu_share * 100, result.wakeups);
+
+}
+
+
+int main(int argc, char** argv) {
+
+    double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+    int port = argc > 2 ? atoi(argv[2]) : 18081;
+
+    /* the server logs every request */
+    if (freopen("/dev/null", "w", stdout) == NULL) { return 1; }
+    if (not server_begin(port)) {
+        fprintf(stderr, "can't listen on port %d\n", port);
+        return 1;
+    }
+    std::thread([] { server_run(&handler); }).detach();
+    /* let the loop reach its first select */
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    fprintf(stderr, "%-8s %-24s %11s %12s\n", "loop", "connections", "cpu", "wakeups/s");
+    idle_result select_idle = measure(seconds, &wakeups);
+    print_result("select", "none", select_idle);
+
+    /* keep-alive connections after one request each, they stay open for SERVER_IDLE_TIMEOUT */
+    int fds[IDLE_CONNECTIONS];
+    char response[sizeof(ok)];
+    const char* text = "GET / HTTP/1.1\r\nHost: led\r\n\r\n";
+    for (int& fd : fds) {
+        fd = connect_to(port);
+        send(fd, text, strlen(text), 0);
+        recv(fd, response, sizeof(response) - 1, MSG_WAITALL);
+    }
+    idle_result select_open = measure(seconds, &wakeups);
+    print_result("select", "4 idle keep-alive", select_open);
+    for (int fd : fds) { close(fd); }
+
+    /* the replaced loop on a socket of its own */
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int enable = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port + 1);
+    if (bind(listen_fd, (struct sockaddr*)&address, sizeof(address)) < 0 or listen(listen_fd, 8) < 0) {
+        fprintf(stderr, "can't listen on port %d\n", port + 1);
+        return 1;
+    }
+    fcntl(listen_fd, F_SETFL, O_NONBLOCK);
+    std::vector<std::thread> tasks;
+    tasks.reserve(IDLE_CONNECTIONS);
+    std::thread accepting(polling_accept, listen_fd, &tasks);
+
+    idle_result polling_idle = measure(seconds, &polls);
+    print_result("polling", "none", polling_idle);
+    for (int& fd : fds) { fd = connect_to(port + 1); }
+    idle_result polling_open = measure(seconds, &polls);
+    print_result("polling", "4 waiting for a request", polling_open);
+
+    polling = false;
+    accepting.join();
+    for (std::thread& task : tasks) { task.join(); }
+    for (int fd : fds) { close(fd); }
+    close(listen_fd);
+
+    /* the select loop sleeps through idle time, open connections only wake it for their timeout */
+    bool quiet = select_idle.cpu_share < 0.01 and select_idle.wakeups < 1 and
+                 select_open.cpu_share < 0.01 and select_open.wakeups < 1;
+    return quiet ? 0 : 1;
+
+}
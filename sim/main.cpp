@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Arduino.h"
+
+#include "sim.h"
+
+extern "C" void app_main(void);
+
+
+/**
+ * @brief Runs the firmware on the host
+ * 
+ * usage: led_sim [trace file] [seconds]
+ *   the trace records every change of the led outputs, without
+ *   a duration the simulator runs until it is killed
+ */
+int main(int argc, char** argv) {
+
+    FILE* trace = NULL;
+    if (argc > 1) {
+        trace = fopen(argv[1], "w");
+        if (trace == NULL) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+    int seconds = argc > 2 ? atoi(argv[2]) : 0;
+
+    sim_trace_begin(trace);
+    app_main();
+
+    if (seconds == 0) {
+        while (true) { delay(1000); }
+    }
+    delay(seconds * 1000);
+    /* the tasks never return, the output is flushed and the process ends under them */
+    fflush(NULL);
+    _Exit(0);
+
+}
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <new>
+
+#include "Arduino.h"
+
+#include "message.h"
+#include "macros.h"
+
+/*
+ * Serves the status page of every speed and animation from the page cache and
+ * renders it per request the way the firmware did before, and reports the heap
+ * allocations and time per request of both. malloc and friends are wrapped at
+ * link time. The host String grows like std::string, so the rendered count is
+ * not the one of the Arduino String, the cached one has to be 0 on both.
+ *   page_bench [requests]
+ */
+
+void render_page(String& response, int speed, int type);
+const String& write_response(const change_animation_message_t* message);
+
+static std::atomic<long> allocations(0);
+
+extern "C" void* __real_malloc(size_t size);
+extern "C" void* __real_calloc(size_t count, size_t size);
+extern "C" void* __real_realloc(void* pointer, size_t size);
+
+extern "C" void* __wrap_malloc(size_t size) { allocations++; return __real_malloc(size); }
+extern "C" void* __wrap_calloc(size_t count, size_t size) { allocations++; return __real_calloc(count, size); }
+extern "C" void* __wrap_realloc(void* pointer, size_t size) { allocations++; return __real_realloc(pointer, size); }
+
+void* operator new(size_t size) { allocations++; return __real_malloc(size); }
+void* operator new[](size_t size) { allocations++; return __real_malloc(size); }
+void operator delete(void* pointer) noexcept { free(pointer); }
+void operator delete[](void* pointer) noexcept { free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { free(pointer); }
+
+#define PAGE_STATES (CUSTOM_SPEED * ANIMATION_COUNT)
+
+
+typedef struct {
+    double microseconds;
+    double allocations;
+    size_t bytes;
+} page_result;
+
+
+static void state_of(long request, change_animation_message_t* message) {
+
+    message->status = 200;
+    message->animation_speed = request % CUSTOM_SPEED;
+    message->animation_type = (request / CUSTOM_SPEED) % ANIMATION_COUNT;
+
+}
+
+
+/**
+ * @brief Renders a new page for every request, as the firmware did before the cache
+ */
+static page_result rendered(long requests) {
+
+    change_animation_message_t message;
+    size_t bytes = 0;
+    long before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < requests; i++) {
+        state_of(i, &message);
+        String response;
+        render_page(response, message.animation_speed, message.animation_type);
+        bytes += response.length();
+    }
+    double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return { elapsed / requests, (double)(allocations.load() - before) / requests, bytes / requests };
+
+}
+
+
+static page_result cached(long requests) {
+
+    change_animation_message_t message;
+    size_t bytes = 0;
+    long before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < requests; i++) {
+        state_of(i, &message);
+        bytes += write_response(&message).length();
+    }
+    double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return { elapsed / requests, (double)(allocations.load() - before) / requests, bytes / requests };
+
+}
+
+
+int main(int argc, char** argv) {
+
+    long requests = argc > 1 ? atol(argv[1]) : 1000000;
+
+    /* the firmware logs every response */
+    if (freopen("/dev/null", "w", stdout) == NULL) { return 1; }
+
+    /* the cache has to hand out the very page a render makes */
+    int wrong = 0;
+    for (long state = 0; state < PAGE_STATES; state++) {
+        change_animation_message_t message;
+        state_of(state, &message);
+        String page;
+        render_page(page, message.animation_speed, message.animation_type);
+        if (not (write_response(&message) == page)) {
+            fprintf(stderr, "speed %d, animation %d: cached page differs\n", message.animation_speed, message.animation_type);
+            wrong++;
+        }
+    }
+
+    page_result render = rendered(requests);
+    page_result cache = cached(requests);
+    fprintf(stderr, "%-10s %10s %16s %12s\n", "page", "us/request", "allocations/req", "bytes/req");
+    fprintf(stderr, "%-10s %10.3f %16.3f %12zu\n", "rendered", render.microseconds, render.allocations, render.bytes);
+    fprintf(stderr, "%-10s %10.3f %16.3f %12zu\n", "cached", cache.microseconds, cache.allocations, cache.bytes);
+    return wrong == 0 and cache.allocations == 0 ? 0 : 1;
+
+}
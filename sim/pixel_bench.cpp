@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "esp_timer.h"
+
+#include "macros.h"
+#include "pixel_encoder.h"
+#include "pixels.h"
+#include "sim.h"
+
+/*
+ * Measures the frames per second pixels.cpp gets onto the strip and the time
+ * pixel_show takes, for 60, 300 and 1000 pixels, shown on the 100 Hz tick and
+ * as fast as a 100 us timer calls it. The wire is the emulated rmt channel of
+ * the shims: a write lasts as long as its symbols do, nothing is clocked out.
+ * Fails when a frame starts while the previous one is still on the wire or
+ * the last frame shown is not the last one sent.
+ *   pixel_bench [seconds per run]
+ */
+
+#define FAST_PERIOD 100
+
+static esp_timer_handle_t show_timer;
+static std::atomic<long> shown(0);
+static std::atomic<long> show_ns(0);
+static std::atomic<long> show_most_ns(0);
+static uint16_t strip_pixels;
+
+
+/**
+ * @brief Draws a frame of its own every call, the first pixel holds the
+ * frame number
+ */
+static void show(void* arg) {
+
+    long frame = shown.load();
+    pixel_fill(0, strip_pixels, frame & 0xff, (frame >> 8) & 0xff, 0x55);
+    pixel_set(0, frame & 0xff, (frame >> 8) & 0xff, (frame >> 16) & 0xff);
+
+    auto start = std::chrono::steady_clock::now();
+    pixel_show();
+    long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    show_ns += ns;
+    if (ns > show_most_ns) { show_most_ns = ns; }
+    shown++;
+
+}
+
+
+/**
+ * @brief Runs in a process of its own, the strip can only be set up once
+ */
+static int run(uint16_t pixels, uint64_t period, const char* driven, double seconds) {
+
+    strip_pixels = pixels;
+    if (not pixel_strip_init(PIXEL_PIN, pixels)) {
+        fprintf(stderr, "can't set up %u pixels\n", (unsigned)pixels);
+        return 1;
+    }
+    const esp_timer_create_args_t timer_args = {
+        .callback = &show,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "show",
+        .skip_unhandled_events = true
+    };
+    esp_timer_create(&timer_args, &show_timer);
+
+    auto start = std::chrono::steady_clock::now();
+    esp_timer_start_periodic(show_timer, period);
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    esp_timer_stop(show_timer);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    /* the frame waiting for the wire goes out */
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    sim_rmt_stats_t stats = sim_rmt_stats();
+    double wire_ms = stats.frames ? stats.wire_ns / 1e6 / stats.frames : 0;
+    fprintf(stderr, "%7u %-12s %9.2f %10.0f %10.0f %9.1f %9.1f %9llu\n", (unsigned)pixels, driven, wire_ms,
+            shown / elapsed, stats.frames / elapsed, show_ns / 1e3 / shown, show_most_ns / 1e3,
+            (unsigned long long)stats.overlaps);
+
+    /* the newest frame shown has to be the one on the strip */
+    size_t length = (size_t)pixels * PIXEL_BYTES * 8 + 1;
+    std::vector<uint32_t> sent(length), expected(length);
+    long last = shown - 1;
+    std::vector<uint8_t> data((size_t)pixels * PIXEL_BYTES);
+    for (size_t i = 0; i < pixels; i++) {
+        data[i * 3] = (last >> 8) & 0xff;
+        data[i * 3 + 1] = last & 0xff;
+        data[i * 3 + 2] = 0x55;
+    }
+    data[2] = (last >> 16) & 0xff;
+    pixel_encode(data.data(), data.size(), expected.data());
+    bool newest = sim_rmt_last_frame(sent.data(), length) == length and sent == expected;
+    if (not newest) { fprintf(stderr, "%u pixels: the last frame shown was not sent\n", (unsigned)pixels); }
+
+    return stats.overlaps == 0 and newest ? 0 : 1;
+
+}
+
+
+int main(int argc, char** argv) {
+
+    double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+
+    fprintf(stderr, "%7s %-12s %9s %10s %10s %9s %9s %9s\n",
+            "pixels", "shown", "wire ms", "shown/s", "sent/s", "show us", "most us", "overlaps");
+    int failed = 0;
+    for (uint16_t pixels : { 60, 300, 1000 }) {
+        for (bool fast : { false, true }) {
+            /* a process per run, the strip and its timer are set up once */
+            pid_t child = fork();
+            if (child == 0) { _exit(run(pixels, fast ? FAST_PERIOD : TICK_PERIOD, fast ? "every 100 us" : "on the tick", seconds)); }
+            int status;
+            waitpid(child, &status, 0);
+            if (not WIFEXITED(status) or WEXITSTATUS(status) != 0) { failed++; }
+        }
+    }
+    return failed ? 1 : 0;
+
+}
@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "esp32-hal-rmt.h"
+#include "pixel_encoder.h"
+
+/*
+ * Renders the symbols of pixel_encode as the line level every 50 ns and
+ * compares them with a waveform built from the WS2812B datasheet timings
+ * alone, then decodes the line back into bytes the way a pixel samples it.
+ * Every byte value, and frames of random bytes of several strip lengths.
+ *   pixel_test
+ */
+
+/* WS2812B datasheet, ns */
+#define REFERENCE_T0H           400
+#define REFERENCE_T0L           850
+#define REFERENCE_T1H           800
+#define REFERENCE_T1L           450
+#define REFERENCE_TOLERANCE     150
+/* SK6812 needs the longest low time to latch */
+#define REFERENCE_RESET         80000
+/* a pixel reads the bit this long after the rising edge */
+#define REFERENCE_SAMPLE        625
+#define SAMPLE_NS               50
+
+static int failures = 0;
+
+
+static void expect(bool condition, const char* what) {
+
+    if (not condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+
+}
+
+
+static void append(std::vector<uint8_t>* line, uint8_t level, int ns) {
+
+    line->insert(line->end(), ns / SAMPLE_NS, level);
+
+}
+
+
+/**
+ * @brief The line a strip has to see for `data`, most significant bit
+ * first, closed by the reset low time
+ */
+static std::vector<uint8_t> reference_line(const uint8_t* data, size_t length) {
+
+    std::vector<uint8_t> line;
+    for (size_t i = 0; i < length; i++) {
+        for (int bit = 7; bit >= 0; bit--) {
+            bool one = (data[i] >> bit) & 1;
+            append(&line, 1, one ? REFERENCE_T1H : REFERENCE_T0H);
+            append(&line, 0, one ? REFERENCE_T1L : REFERENCE_T0L);
+        }
+    }
+    append(&line, 0, REFERENCE_RESET);
+    return line;
+
+}
+
+
+/**
+ * @brief The line the rmt channel drives for `symbols` at PIXEL_TICK_NS
+ * per tick, read through the rmt_data_t layout of the hal
+ */
+static std::vector<uint8_t> rendered_line(const uint32_t* symbols, size_t length) {
+
+    std::vector<uint8_t> line;
+    for (size_t i = 0; i < length; i++) {
+        rmt_data_t symbol;
+        symbol.val = symbols[i];
+        append(&line, symbol.level0, symbol.duration0 * PIXEL_TICK_NS);
+        append(&line, symbol.level1, symbol.duration1 * PIXEL_TICK_NS);
+    }
+    return line;
+
+}
+
+
+/**
+ * @brief Decodes the line like a pixel does, checks every high pulse
+ * against the datasheet and the final low time against the reset
+ */
+static std::vector<uint8_t> decode_line(const std::vector<uint8_t>& line) {
+
+    std::vector<uint8_t> data;
+    uint8_t byte = 0;
+    int bits = 0;
+    size_t i = 0;
+    while (i < line.size()) {
+        if (line[i] == 0) { i++; continue; }
+        size_t high = 0, low = 0;
+        while (i + high < line.size() and line[i + high] == 1) { high++; }
+        while (i + high + low < line.size() and line[i + high + low] == 0) { low++; }
+        int high_ns = high * SAMPLE_NS;
+        int low_ns = low * SAMPLE_NS;
+
+        bool one = line[i + REFERENCE_SAMPLE / SAMPLE_NS] == 1;
+        int expected = one ? REFERENCE_T1H : REFERENCE_T0H;
+        expect(abs(high_ns - expected) <= REFERENCE_TOLERANCE, "high time within the datasheet tolerance");
+        bool last = i + high + low == line.size();
+        if (not last) {
+            expect(abs(low_ns - (one ? REFERENCE_T1L : REFERENCE_T0L)) <= REFERENCE_TOLERANCE, "low time within the datasheet tolerance");
+        }
+
+        byte = (byte << 1) | one;
+        if (++bits == 8) {
+            data.push_back(byte);
+            bits = 0;
+        }
+        i += high + low;
+    }
+    expect(bits == 0, "whole bytes on the line");
+    return data;
+
+}
+
+
+static void check_frame(const uint8_t* data, size_t length) {
+
+    std::vector<uint32_t> symbols(length * 8 + 1);
+    size_t written = pixel_encode(data, length, symbols.data());
+    expect(written == symbols.size(), "8 symbols per byte and the reset");
+
+    std::vector<uint8_t> line = rendered_line(symbols.data(), written);
+    std::vector<uint8_t> reference = reference_line(data, length);
+    if (line != reference) {
+        printf("frame of %zu bytes: rendered line differs from the reference\n", length);
+        failures++;
+        return;
+    }
+
+    /* trailing low time, the last bit's low half counts towards it */
+    size_t low = 0;
+    while (low < line.size() and line[line.size() - 1 - low] == 0) { low++; }
+    expect(low * SAMPLE_NS >= REFERENCE_RESET, "frame latched by the reset low time");
+
+    std::vector<uint8_t> decoded = decode_line(line);
+    expect(decoded.size() == length and std::equal(decoded.begin(), decoded.end(), data), "line decodes to the frame");
+
+}
+
+
+int main(void) {
+
+    uint8_t every[256];
+    for (int value = 0; value < 256; value++) { every[value] = value; }
+    check_frame(every, sizeof(every));
+    check_frame(every, 0);
+
+    std::mt19937 random(13);
+    for (size_t pixels : { 1, 60, 300, 1000 }) {
+        std::vector<uint8_t> frame(pixels * 3);
+        for (uint8_t& byte : frame) { byte = random(); }
+        check_frame(frame.data(), frame.size());
+    }
+
+    printf("pixel encoder: %d checks failed\n", failures);
+    return failures ? 1 : 0;
+
+}
@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+#if defined(__x86_64__) or defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "macros.h"
+#include "program.h"
+
+/*
+ * Measures the interpreter per frame for typical programs.
+ *   program_bench [frames]
+ * Cycles are read from the time stamp counter on x86 and left out elsewhere.
+ */
+
+struct bench_program {
+    const char* name;
+    std::vector<uint8_t> code;
+};
+
+static const bench_program programs[] = {
+    /* the pump animation as a program */
+    { "pump", { 'L', 'P', PROGRAM_VERSION,
+                PROGRAM_FRAME, FRAME_RGB_KEEP,
+                PROGRAM_FRAME, FRAME_LEFT | FRAME_RGB_KEEP,
+                PROGRAM_FRAME, FRAME_LEFT | FRAME_MIDDLE | FRAME_RGB_KEEP,
+                PROGRAM_FRAME, FRAME_BAR_MASK | FRAME_RGB_KEEP,
+                PROGRAM_FRAME, FRAME_BAR_MASK | FRAME_RGB_SWITCH } },
+    /* blinks in random colors */
+    { "random blink", { 'L', 'P', PROGRAM_VERSION,
+                        PROGRAM_RANDOM, PROGRAM_FRAME, FRAME_RGB_KEEP, PROGRAM_FRAME, 0 } },
+    /* nested loops with fades and fixed colors */
+    { "nested loops", { 'L', 'P', PROGRAM_VERSION,
+                        PROGRAM_FADE, 1,
+                        PROGRAM_LOOP, 4,
+                            PROGRAM_COLOR, RED,
+                            PROGRAM_LOOP, 3, PROGRAM_FRAME, FRAME_LEFT | FRAME_RGB_KEEP, PROGRAM_FRAME, FRAME_RIGHT, PROGRAM_END,
+                            PROGRAM_COLOR, BLUE,
+                            PROGRAM_FRAME, FRAME_MIDDLE | FRAME_RGB_KEEP,
+                        PROGRAM_END,
+                        PROGRAM_FADE, 0,
+                        PROGRAM_FRAME, 0 } },
+};
+
+
+int main(int argc, char** argv) {
+
+    long frames = argc > 1 ? atol(argv[1]) : 10000000;
+
+    printf("%-14s %10s %12s %12s\n", "program", "ns/frame", "cycles/frame", "ops/frame");
+    for (const bench_program& program : programs) {
+        if (not program_verify(program.code.data(), program.code.size())) {
+            fprintf(stderr, "%s does not verify\n", program.name);
+            return 1;
+        }
+
+        program_state_t state;
+        program_start(&state, 1);
+        program_frame_t frame;
+        long operations = 0;
+        unsigned checksum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+#if defined(__x86_64__) or defined(__i386__)
+        unsigned long long cycles_start = __rdtsc();
+#endif
+        for (long i = 0; i < frames; i++) {
+            int executed;
+            program_step(program.code.data(), program.code.size(), &state, 3, &frame, &executed);
+            operations += executed;
+            checksum += frame.frame;
+        }
+#if defined(__x86_64__) or defined(__i386__)
+        double cycles = (double)(__rdtsc() - cycles_start) / frames;
+#else
+        double cycles = 0;
+#endif
+        double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+
+        printf("%-14s %10.2f %12.1f %12.2f   (%u)\n", program.name, nanoseconds, cycles, (double)operations / frames, checksum & 0xff);
+    }
+    return 0;
+
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "macros.h"
+#include "program.h"
+
+/*
+ * Fuzzes the program verifier and interpreter, every program the verifier
+ * accepts has to run without leaving its bounds. Programs are copied into
+ * buffers of their exact size, so SIM_SANITIZE=ON catches any read past the end.
+ *   program_fuzz [iterations] [seed]
+ * With SIM_LIBFUZZER=ON the same check is a libFuzzer target.
+ */
+
+#define FUZZ_FRAMES 256
+#define FUZZ_COLORS 3
+
+static void check(bool condition, const char* what) {
+
+    if (not condition) {
+        fprintf(stderr, "program_fuzz: %s\n", what);
+        abort();
+    }
+
+}
+
+
+/**
+ * @brief Runs a program if the verifier accepts it
+ * 
+ * @return true when it was accepted
+ */
+static bool run(const uint8_t* data, size_t size) {
+
+    std::vector<uint8_t> program(data, data + size);
+    if (not program_verify(program.data(), program.size())) { return false; }
+
+    program_state_t state;
+    program_start(&state, 1);
+    for (int i = 0; i < FUZZ_FRAMES; i++) {
+        program_frame_t frame;
+        int executed;
+        bool shown = program_step(program.data(), program.size(), &state, FUZZ_COLORS, &frame, &executed);
+
+        check(state.depth <= PROGRAM_MAX_DEPTH, "loop depth out of bounds");
+        check(state.pc >= PROGRAM_HEADER_SIZE and state.pc <= program.size(), "pc out of bounds");
+        check(executed >= 1 and executed <= PROGRAM_BUDGET, "budget exceeded");
+        check(not shown or (frame.frame & ~(FRAME_BAR_MASK | FRAME_RGB_MASK)) == 0, "invalid keyframe");
+        check(frame.sequence_index < FUZZ_COLORS, "color outside the sequence");
+        check(frame.color <= GREEN, "invalid color");
+    }
+    return true;
+
+}
+
+
+#ifdef SIM_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+
+    run(data, size);
+    return 0;
+
+}
+
+#else
+
+/* valid programs mutated by the fuzzer */
+static const std::vector<std::vector<uint8_t>> corpus = {
+    { 'L', 'P', PROGRAM_VERSION, PROGRAM_FRAME, 0x01, PROGRAM_FRAME, 0x03, PROGRAM_FRAME, 0x07 },
+    { 'L', 'P', PROGRAM_VERSION, PROGRAM_LOOP, 3, PROGRAM_RANDOM, PROGRAM_FRAME, 0x0f, PROGRAM_END, PROGRAM_FRAME, 0x00 },
+    { 'L', 'P', PROGRAM_VERSION, PROGRAM_FADE, 1, PROGRAM_LOOP, 2, PROGRAM_LOOP, 4, PROGRAM_FRAME, 0x12, PROGRAM_END,
+      PROGRAM_COLOR, 2, PROGRAM_FRAME, 0x08, PROGRAM_END, PROGRAM_RANDOM },
+};
+
+
+int main(int argc, char** argv) {
+
+    long iterations = argc > 1 ? atol(argv[1]) : 1000000;
+    std::mt19937 random(argc > 2 ? atoi(argv[2]) : 1);
+    long accepted = 0;
+
+    for (long i = 0; i < iterations; i++) {
+        std::vector<uint8_t> program;
+        if (i % 2 == 0) {
+            /* random instructions behind a valid header, opcodes near the valid range */
+            program = { 'L', 'P', PROGRAM_VERSION };
+            size_t length = random() % (PROGRAM_MAX_SIZE + 8);
+            for (size_t j = 0; j < length; j++) { program.push_back(random() % 4 ? random() % 8 : random() % 256); }
+        } else {
+            /* a few flipped, inserted or dropped bytes of a valid program */
+            program = corpus[random() % corpus.size()];
+            for (int mutations = 1 + random() % 4; mutations > 0; mutations--) {
+                size_t at = random() % program.size();
+                switch (random() % 3) {
+                    case 0: program[at] ^= 1 << (random() % 8); break;
+                    case 1: program.insert(program.begin() + at, random() % 8); break;
+                    case 2: if (program.size() > 1) { program.erase(program.begin() + at); } break;
+                }
+            }
+        }
+        if (run(program.data(), program.size())) { accepted++; }
+    }
+
+    printf("%ld programs, %ld accepted and run for %d frames each\n", iterations, accepted, FUZZ_FRAMES);
+    return 0;
+
+}
+
+#endif
@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <thread>
+
+#include "lwip/sockets.h"
+
+#include "server.h"
+
+/*
+ * Serves keep-alive requests over loopback and counts the heap allocations
+ * the server makes per request, malloc and friends are wrapped at link time.
+ *   request_bench [requests] [port]
+ */
+
+static std::atomic<long> allocations(0);
+
+extern "C" void* __real_malloc(size_t size);
+extern "C" void* __real_calloc(size_t count, size_t size);
+extern "C" void* __real_realloc(void* pointer, size_t size);
+
+extern "C" void* __wrap_malloc(size_t size) { allocations++; return __real_malloc(size); }
+extern "C" void* __wrap_calloc(size_t count, size_t size) { allocations++; return __real_calloc(count, size); }
+extern "C" void* __wrap_realloc(void* pointer, size_t size) { allocations++; return __real_realloc(pointer, size); }
+
+void* operator new(size_t size) { allocations++; return __real_malloc(size); }
+void* operator new[](size_t size) { allocations++; return __real_malloc(size); }
+void operator delete(void* pointer) noexcept { free(pointer); }
+void operator delete[](void* pointer) noexcept { free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { free(pointer); }
+
+static const char ok[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+
+
+static bool answer(connection_t* connection) {
+
+    connection->response = ok;
+    connection->response_length = sizeof(ok) - 1;
+    return false;
+
+}
+
+
+static void respond(connection_t* connection) {
+
+}
+
+
+static size_t no_events(connection_t* connection) {
+
+    return 0;
+
+}
+
+
+static const server_handler_t handler = { &answer, &respond, &no_events };
+
+
+/**
+ * @brief Sends a request and reads the response up to `length` bytes or the close
+ * 
+ * @return bytes of the response
+ */
+static size_t request(int fd, const char* text, char* response, size_t length) {
+
+    send(fd, text, strlen(text), 0);
+    size_t received = 0;
+    while (received < length) {
+        int part = recv(fd, response + received, length - received, 0);
+        if (part <= 0) { break; }
+        received += part;
+    }
+    response[received] = '\0';
+    return received;
+
+}
+
+
+static int connect_to(int port) {
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        perror("connect");
+        exit(1);
+    }
+    return fd;
+
+}
+
+
+int main(int argc, char** argv) {
+
+    long requests = argc > 1 ? atol(argv[1]) : 100000;
+    int port = argc > 2 ? atoi(argv[2]) : 18080;
+
+    /* the server logs every request */
+    if (freopen("/dev/null", "w", stdout) == NULL) { return 1; }
+    if (not server_begin(port)) {
+        fprintf(stderr, "can't listen on port %d\n", port);
+        return 1;
+    }
+    std::thread([] { server_run(&handler); }).detach();
+
+    char response[256];
+    int fd = connect_to(port);
+    const char* text = "GET /animation_worm HTTP/1.1\r\nHost: led\r\nAccept-Encoding: gzip\r\n\r\n";
+
+    /* buffers of stdio and the like are allocated once */
+    for (int i = 0; i < 10; i++) { request(fd, text, response, sizeof(ok) - 1); }
+    close(fd);
+    fd = connect_to(port);
+
+    long before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    long served = 0;
+    for (long i = 0; i < requests; i++) {
+        /* a connection serves SERVER_MAX_REQUESTS */
+        if (i % SERVER_MAX_REQUESTS == SERVER_MAX_REQUESTS - 1) {
+            close(fd);
+            fd = connect_to(port);
+        }
+        if (request(fd, text, response, sizeof(ok) - 1) == sizeof(ok) - 1) { served++; }
+    }
+    double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / requests;
+    long allocated = allocations.load() - before;
+    close(fd);
+
+    /* a path past the limit is answered instead of truncated */
+    char path[SERVER_PATH_SIZE + 32];
+    memset(path, 'a', sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+    char long_request[sizeof(path) + 32];
+    snprintf(long_request, sizeof(long_request), "GET /%s HTTP/1.1\r\n\r\n", path);
+    fd = connect_to(port);
+    request(fd, long_request, response, sizeof(response) - 1);
+    close(fd);
+
+    fprintf(stderr, "%ld allocations while starting up\n", before);
+    fprintf(stderr, "%ld of %ld requests served, %.1f us/request, %.3f allocations/request\n",
+            served, requests, microseconds, (double)allocated / requests);
+    fprintf(stderr, "long path: %.25s\n", response);
+    return served == requests and allocated == 0 and strncmp(response, "HTTP/1.1 414", 12) == 0 ? 0 : 1;
+
+}
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "server.h"
+
+/*
+ * Fuzzes the request line parser, accepted lines have to yield NUL terminated
+ * views inside the line, everything else a 400 or 414. Lines are copied into
+ * buffers of their exact size, so SIM_SANITIZE=ON catches any access past the end.
+ *   request_fuzz [iterations] [seed]
+ * With SIM_LIBFUZZER=ON the same check is a libFuzzer target.
+ */
+
+static void check(bool condition, const char* what) {
+
+    if (not condition) {
+        fprintf(stderr, "request_fuzz: %s\n", what);
+        abort();
+    }
+
+}
+
+
+/**
+ * @brief Parses a single line, checks the views of accepted ones
+ * 
+ * @return status of the parse
+ */
+static int run(const uint8_t* data, size_t size) {
+
+    std::vector<char> line(data, data + size);
+    server_request_line_t request;
+    int status = server_parse_request_line(line.data(), line.size(), &request);
+    check(status == 200 or status == 400 or status == 414, "unexpected status");
+    if (status != 200) { return status; }
+
+    const char* begin = line.data();
+    const char* end = begin + line.size();
+    check(request.method == begin, "method does not start the line");
+    check(request.method_length > 0 and request.method_length < SERVER_METHOD_SIZE, "method length out of bounds");
+    check(request.method[request.method_length] == '\0', "method not terminated");
+    check(request.path > request.method + request.method_length and request.path + request.path_length < end, "path outside the line");
+    check(request.path_length < SERVER_PATH_SIZE and request.path[0] == '/', "invalid path");
+    check(request.path[request.path_length] == '\0' and strlen(request.path) == request.path_length, "path not terminated");
+    check(line.size() < SERVER_REQUEST_LINE_SIZE, "request line too long");
+    return status;
+
+}
+
+
+#ifdef SIM_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+
+    run(data, size);
+    return 0;
+
+}
+
+#else
+
+int main(int argc, char** argv) {
+
+    long iterations = argc > 1 ? atol(argv[1]) : 1000000;
+    std::mt19937 random(argc > 2 ? atoi(argv[2]) : 1);
+    const char* seeds[] = { "GET / HTTP/1.1", "POST /control HTTP/1.1", "GET /speed?bpm=120 HTTP/1.0", "GET /program/3 HTTP/1.1" };
+    const char alphabet[] = "GETPOST /?=&HTP1.0\r\n\t\x7f\xff-_abc";
+    long counts[3] = { 0 };
+
+    for (long i = 0; i < iterations; i++) {
+        std::string line = seeds[random() % 4];
+        switch (random() % 4) {
+            case 0:
+                /* random bytes */
+                line.clear();
+                for (int length = random() % 128; length > 0; length--) { line += (char)random(); }
+                break;
+            case 1:
+                /* a longer path, around the limits */
+                line.insert(line.find(' ') + 2, std::string(random() % (SERVER_REQUEST_LINE_SIZE + 8), 'a'));
+                break;
+            default:
+                /* a few replaced, inserted or dropped characters */
+                for (int mutations = 1 + random() % 4; mutations > 0; mutations--) {
+                    size_t at = line.empty() ? 0 : random() % line.size();
+                    char c = alphabet[random() % (sizeof(alphabet) - 1)];
+                    switch (random() % 3) {
+                        case 0: if (not line.empty()) { line[at] = c; } break;
+                        case 1: line.insert(line.begin() + at, c); break;
+                        case 2: if (not line.empty()) { line.erase(at, 1); } break;
+                    }
+                }
+                break;
+        }
+        int status = run((const uint8_t*)line.data(), line.size());
+        counts[status == 200 ? 0 : (status == 400 ? 1 : 2)]++;
+    }
+
+    printf("%ld lines, %ld accepted, %ld malformed, %ld too long\n", iterations, counts[0], counts[1], counts[2]);
+    return 0;
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "routes.h"
+
+/*
+ * Measures route dispatch over random valid and invalid request paths,
+ * against the comparison chain it replaced.
+ *   route_bench [lookups]
+ */
+
+static int hits[16];
+
+static void count(change_animation_message_t* message, const route_args_t* args) {
+
+    hits[args->value]++;
+
+}
+
+/* the names of the firmware's table, a value per route */
+constexpr route_t routes[] = {
+    { "/",                  &count, ROUTE_PAGE, 0 },
+    { "/animation_pump",    &count, ROUTE_PAGE, 1 },
+    { "/animation_snake",   &count, ROUTE_PAGE, 2 },
+    { "/animation_wave",    &count, ROUTE_PAGE, 3 },
+    { "/animation_worm",    &count, ROUTE_PAGE, 4 },
+    { "/control",           &count, ROUTE_JSON, 5 },
+    { "/program/",          &count, ROUTE_JSON, 6 },
+    { "/speed",             &count, ROUTE_JSON, 7 },
+    { "/speed_high",        &count, ROUTE_PAGE, 8 },
+    { "/speed_medium",      &count, ROUTE_PAGE, 9 },
+    { "/speed_slow",        &count, ROUTE_PAGE, 10 },
+};
+
+#define ROUTE_COUNT (sizeof(routes) / sizeof(routes[0]))
+
+static_assert(route_table_sorted(routes, ROUTE_COUNT), "routes have to be sorted by name");
+
+
+/**
+ * @brief The former dispatch, compares the whole path against every name
+ * 
+ */
+static void chain(change_animation_message_t* message, const char* path) {
+
+    route_args_t args;
+    for (size_t i = 0; i < ROUTE_COUNT; i++) {
+        if (strcmp(path, routes[i].name) == 0) {
+            args.value = routes[i].value;
+            count(message, &args);
+            return;
+        }
+    }
+    hits[15]++;
+
+}
+
+
+int main(int argc, char** argv) {
+
+    long lookups = argc > 1 ? atol(argv[1]) : 10000000;
+    std::mt19937 random(1);
+
+    /* half valid paths, half near misses and garbage */
+    std::vector<std::string> paths;
+    const char* valid[] = { "/", "/animation_pump", "/animation_snake", "/animation_wave", "/animation_worm", "/control",
+                            "/program/3", "/speed?bpm=120", "/speed_high", "/speed_medium", "/speed_slow" };
+    const char* invalid[] = { "/favicon.ico", "/animation_", "/animation_pumps", "/speed_", "/program/", "/x", "/controller",
+                              "/speed_slow/1", "/ANIMATION_WAVE", "/program/123456789" };
+    for (int i = 0; i < 1024; i++) {
+        paths.push_back(i % 2 ? valid[random() % (sizeof(valid) / sizeof(valid[0]))] : invalid[random() % (sizeof(invalid) / sizeof(invalid[0]))]);
+    }
+
+    change_animation_message_t message;
+    route_args_t args;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < lookups; i++) {
+        const route_t* route = route_match(routes, ROUTE_COUNT, paths[i & 1023].c_str(), &args);
+        if (route != NULL) {
+            route->handler(&message, &args);
+        } else {
+            hits[15]++;
+        }
+    }
+    double table = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / lookups;
+    int table_misses = hits[15];
+
+    memset(hits, 0, sizeof(hits));
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < lookups; i++) { chain(&message, paths[i & 1023].c_str()); }
+    double compare = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / lookups;
+
+    printf("route table  %6.2f ns/lookup, %.1f%% not found\n", table, 100.0 * table_misses / lookups);
+    printf("strcmp chain %6.2f ns/lookup, %.1f%% not found (no query or id support)\n", compare, 100.0 * hits[15] / lookups);
+    return 0;
+
+}
@@ -0,0 +1,555 @@
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "AsyncUDP.h"
+#include "ESPmDNS.h"
+#include "Preferences.h"
+#include "WiFi.h"
+#include "esp32-hal-rmt.h"
+#include "driver/gpio.h"
+#include "soc/gpio_struct.h"
+
+#include "macros.h"
+#include "sim.h"
+
+WiFiClass WiFi;
+MDNSResponder MDNS;
+sim_gpio GPIO;
+
+static const std::chrono::steady_clock::time_point sim_start = std::chrono::steady_clock::now();
+
+
+/* oscillator error of the simulated device, ppm */
+static std::atomic<int32_t> sim_clock_ppm(0);
+
+
+int64_t esp_timer_get_time(void) {
+
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sim_start).count();
+    return elapsed + elapsed * sim_clock_ppm / 1000000;
+
+}
+
+
+void sim_clock_skew(int32_t ppm) {
+
+    sim_clock_ppm = ppm;
+
+}
+
+
+void initArduino(void) {
+
+}
+
+
+void delay(uint32_t ms) {
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+
+}
+
+
+/* tasks */
+
+struct sim_task {
+    TaskFunction_t function;
+    void* arg;
+    std::mutex lock;
+    std::condition_variable notified;
+    uint32_t notifications;
+};
+
+static thread_local sim_task* sim_current_task = NULL;
+
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stack_size,
+                       void* arg, uint32_t priority, TaskHandle_t* handle) {
+
+    sim_task* task = new sim_task();
+    task->function = function;
+    task->arg = arg;
+    task->notifications = 0;
+    if (handle != NULL) { *handle = task; }
+
+    std::thread([task]() {
+        sim_current_task = task;
+        task->function(task->arg);
+    }).detach();
+    return pdPASS;
+
+}
+
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+
+    sim_task* task = sim_current_task;
+    std::unique_lock<std::mutex> lock(task->lock);
+    auto ready = [task]() { return task->notifications != 0; };
+    if (ticks == portMAX_DELAY) {
+        task->notified.wait(lock, ready);
+    } else {
+        task->notified.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+    }
+
+    uint32_t notifications = task->notifications;
+    if (notifications != 0) { task->notifications = clear ? 0 : notifications - 1; }
+    return notifications;
+
+}
+
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+
+    {
+        std::lock_guard<std::mutex> lock(task->lock);
+        task->notifications++;
+    }
+    task->notified.notify_one();
+    return pdPASS;
+
+}
+
+
+void vTaskDelay(TickType_t ticks) {
+
+    delay(ticks);
+
+}
+
+
+/* timers */
+
+struct sim_timer {
+    esp_timer_create_args_t args;
+    std::mutex lock;
+    std::condition_variable stopped;
+    bool running;
+    /* started again after a stop, the thread of the earlier start has to leave */
+    unsigned generation;
+};
+
+/* callbacks of all timers run one at a time like in the esp_timer task */
+static std::mutex sim_timer_task;
+
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+
+    sim_timer* timer = new sim_timer();
+    timer->args = *args;
+    timer->running = false;
+    timer->generation = 0;
+    *handle = timer;
+    return ESP_OK;
+
+}
+
+
+/**
+ * @brief Runs the callback in the timer task unless the timer was
+ * stopped or started again since it expired, a one-shot timer stops
+ * before its callback
+ * 
+ */
+static bool sim_timer_dispatch(sim_timer* timer, unsigned generation, bool once) {
+
+    std::lock_guard<std::mutex> task(sim_timer_task);
+    {
+        std::lock_guard<std::mutex> lock(timer->lock);
+        if (not timer->running or timer->generation != generation) { return false; }
+        if (once) { timer->running = false; }
+    }
+    timer->args.callback(timer->args.arg);
+    return true;
+
+}
+
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period) {
+
+    std::lock_guard<std::mutex> lock(timer->lock);
+    if (timer->running) { return ESP_FAIL; }
+    timer->running = true;
+    unsigned generation = ++timer->generation;
+
+    std::thread([timer, period, generation]() {
+        auto interval = std::chrono::microseconds(period);
+        auto deadline = std::chrono::steady_clock::now() + interval;
+        auto left = [timer, generation]() { return not timer->running or timer->generation != generation; };
+        std::unique_lock<std::mutex> lock(timer->lock);
+        while (not timer->stopped.wait_until(lock, deadline, left)) {
+            lock.unlock();
+            if (not sim_timer_dispatch(timer, generation, false)) { return; }
+            lock.lock();
+
+            deadline += interval;
+            /* late callbacks are dropped, not made up for */
+            auto now = std::chrono::steady_clock::now();
+            if (timer->args.skip_unhandled_events and deadline < now) { deadline = now + interval; }
+        }
+    }).detach();
+    return ESP_OK;
+
+}
+
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout) {
+
+    std::lock_guard<std::mutex> lock(timer->lock);
+    if (timer->running) { return ESP_FAIL; }
+    timer->running = true;
+    unsigned generation = ++timer->generation;
+
+    std::thread([timer, timeout, generation]() {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeout);
+        auto left = [timer, generation]() { return not timer->running or timer->generation != generation; };
+        std::unique_lock<std::mutex> lock(timer->lock);
+        if (timer->stopped.wait_until(lock, deadline, left)) { return; }
+        lock.unlock();
+        sim_timer_dispatch(timer, generation, true);
+    }).detach();
+    return ESP_OK;
+
+}
+
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+
+    {
+        std::lock_guard<std::mutex> lock(timer->lock);
+        if (not timer->running) { return ESP_FAIL; }
+        timer->running = false;
+    }
+    timer->stopped.notify_all();
+    return ESP_OK;
+
+}
+
+
+/* preferences, one file per key: <namespace>.<key>.nvs in the build directory */
+
+bool Preferences::begin(const char* name, bool read_only, const char* partition_label) {
+
+    snprintf(path, sizeof(path), "%s/%s", SIM_NVS_DIR, name);
+    return true;
+
+}
+
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+
+    char file_name[sizeof(path) + 32];
+    snprintf(file_name, sizeof(file_name), "%s.%s.nvs", path, key);
+    FILE* file = fopen(file_name, "wb");
+    if (file == NULL) { return 0; }
+    size_t written = fwrite(value, 1, length, file);
+    fclose(file);
+    return written;
+
+}
+
+
+size_t Preferences::getBytesLength(const char* key) {
+
+    char file_name[sizeof(path) + 32];
+    snprintf(file_name, sizeof(file_name), "%s.%s.nvs", path, key);
+    FILE* file = fopen(file_name, "rb");
+    if (file == NULL) { return 0; }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fclose(file);
+    return length < 0 ? 0 : length;
+
+}
+
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t length) {
+
+    char file_name[sizeof(path) + 32];
+    snprintf(file_name, sizeof(file_name), "%s.%s.nvs", path, key);
+    FILE* file = fopen(file_name, "rb");
+    if (file == NULL) { return 0; }
+    size_t read = fread(buffer, 1, length, file);
+    fclose(file);
+    return read;
+
+}
+
+
+/* gpio and the frame trace */
+
+static std::mutex sim_gpio_lock;
+static uint32_t sim_gpio_levels = 0;
+static uint32_t sim_traced_levels = 0;
+static FILE* sim_trace = NULL;
+
+/* traced pins, in trace column order */
+static const gpio_num_t sim_trace_pins[] = { LEFT_LED, MIDDLE_LED, RIGHT_LED, RGB_LED_RED, RGB_LED_GREEN, RGB_LED_BLUE };
+
+
+void sim_trace_begin(FILE* trace) {
+
+    std::lock_guard<std::mutex> lock(sim_gpio_lock);
+    sim_trace = trace;
+    if (sim_trace != NULL) { fprintf(sim_trace, "# time_us left middle right red green blue\n"); }
+    sim_traced_levels = ~sim_gpio_levels;
+
+}
+
+
+/**
+ * @brief Writes a trace line when the traced pins changed
+ * 
+ */
+static void trace_levels(void) {
+
+    uint32_t mask = LED_PIN_MASK;
+    if (sim_trace == NULL or (sim_gpio_levels & mask) == (sim_traced_levels & mask)) { return; }
+    sim_traced_levels = sim_gpio_levels;
+
+    fprintf(sim_trace, "%lld", (long long)esp_timer_get_time());
+    for (gpio_num_t pin : sim_trace_pins) { fprintf(sim_trace, " %u", (unsigned)((sim_gpio_levels >> pin) & 1)); }
+    fprintf(sim_trace, "\n");
+
+}
+
+
+uint32_t sim_levels(void) {
+
+    std::lock_guard<std::mutex> lock(sim_gpio_lock);
+    return sim_gpio_levels;
+
+}
+
+
+sim_gpio_set& sim_gpio_set::operator=(uint32_t mask) {
+
+    /* the frame backend always follows up with a clear, that one is traced */
+    std::lock_guard<std::mutex> lock(sim_gpio_lock);
+    sim_gpio_levels |= mask;
+    return *this;
+
+}
+
+
+sim_gpio_clear& sim_gpio_clear::operator=(uint32_t mask) {
+
+    std::lock_guard<std::mutex> lock(sim_gpio_lock);
+    sim_gpio_levels &= ~mask;
+    trace_levels();
+    return *this;
+
+}
+
+
+void gpio_pad_select_gpio(uint8_t pin) {
+
+}
+
+
+esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode) {
+
+    return ESP_OK;
+
+}
+
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level) {
+
+    std::lock_guard<std::mutex> lock(sim_gpio_lock);
+    if (level) { sim_gpio_levels |= (1UL << pin); }
+    else { sim_gpio_levels &= ~(1UL << pin); }
+    trace_levels();
+    return ESP_OK;
+
+}
+
+
+/* rmt, a single emulated transmit channel */
+
+struct rmt_obj_s {
+    float tick;
+};
+
+static std::mutex sim_rmt_lock;
+static rmt_obj_s sim_rmt_channel;
+static bool sim_rmt_used = false;
+/* end of the frame on the emulated wire, ns on the host clock */
+static int64_t sim_rmt_busy_until = 0;
+static sim_rmt_stats_t sim_rmt_counters = {};
+static std::vector<uint32_t> sim_rmt_frame;
+
+
+static int64_t sim_rmt_now(void) {
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sim_start).count();
+
+}
+
+
+rmt_obj_t* rmtInit(int pin, bool tx_not_rx, rmt_reserve_memsize_t memsize) {
+
+    std::lock_guard<std::mutex> lock(sim_rmt_lock);
+    if (sim_rmt_used or not tx_not_rx) { return NULL; }
+    sim_rmt_used = true;
+    sim_rmt_channel.tick = 100;
+    return &sim_rmt_channel;
+
+}
+
+
+float rmtSetTick(rmt_obj_t* rmt, float tick) {
+
+    rmt->tick = tick;
+    return tick;
+
+}
+
+
+bool rmtWrite(rmt_obj_t* rmt, rmt_data_t* data, size_t size) {
+
+    std::lock_guard<std::mutex> lock(sim_rmt_lock);
+    int64_t now = sim_rmt_now();
+    /* on the device this restarts the channel in the middle of a frame */
+    if (now < sim_rmt_busy_until) { sim_rmt_counters.overlaps++; }
+
+    uint64_t ticks = 0;
+    for (size_t i = 0; i < size; i++) { ticks += data[i].duration0 + data[i].duration1; }
+    int64_t wire = (int64_t)(ticks * rmt->tick);
+    sim_rmt_busy_until = now + wire;
+
+    sim_rmt_counters.frames++;
+    sim_rmt_counters.wire_ns += wire;
+    sim_rmt_frame.resize(size);
+    for (size_t i = 0; i < size; i++) { sim_rmt_frame[i] = data[i].val; }
+    return true;
+
+}
+
+
+bool rmtDeinit(rmt_obj_t* rmt) {
+
+    std::lock_guard<std::mutex> lock(sim_rmt_lock);
+    sim_rmt_used = false;
+    return true;
+
+}
+
+
+sim_rmt_stats_t sim_rmt_stats(void) {
+
+    std::lock_guard<std::mutex> lock(sim_rmt_lock);
+    return sim_rmt_counters;
+
+}
+
+
+size_t sim_rmt_last_frame(uint32_t* symbols, size_t size) {
+
+    std::lock_guard<std::mutex> lock(sim_rmt_lock);
+    size_t length = sim_rmt_frame.size() < size ? sim_rmt_frame.size() : size;
+    for (size_t i = 0; i < length; i++) { symbols[i] = sim_rmt_frame[i]; }
+    return sim_rmt_frame.size();
+
+}
+
+
+/* udp */
+
+AsyncUDP::~AsyncUDP() {
+
+    if (_fd < 0) { return; }
+    /* wakes the receive thread, it leaves on the 0 byte read */
+    _closing = true;
+    shutdown(_fd, SHUT_RDWR);
+    _receiver.join();
+    close(_fd);
+
+}
+
+
+bool AsyncUDP::listenMulticast(const IPAddress addr, uint16_t port, uint8_t ttl) {
+
+    if (_fd >= 0) { return false; }
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) { return false; }
+
+    /* several simulated controllers on one host share the port */
+    int enable = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    struct ip_mreq group = {};
+    group.imr_multiaddr.s_addr = (uint32_t)addr;
+    group.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+    struct in_addr interface = group.imr_interface;
+    unsigned char hops = ttl;
+    unsigned char loop = 1;
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) < 0 or
+        setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &group, sizeof(group)) < 0 or
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &interface, sizeof(interface)) < 0 or
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &hops, sizeof(hops)) < 0 or
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) < 0) {
+        close(fd);
+        return false;
+    }
+
+    _fd = fd;
+    _receiver = std::thread(&AsyncUDP::receive, this);
+    return true;
+
+}
+
+
+void AsyncUDP::onPacket(AuPacketHandlerFunction cb) {
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _handler = cb;
+
+}
+
+
+size_t AsyncUDP::writeTo(const uint8_t* data, size_t len, const IPAddress addr, uint16_t port) {
+
+    if (_fd < 0) { return 0; }
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = (uint32_t)addr;
+    address.sin_port = htons(port);
+    ssize_t sent = sendto(_fd, data, len, 0, (struct sockaddr*)&address, sizeof(address));
+    return sent < 0 ? 0 : sent;
+
+}
+
+
+void AsyncUDP::receive() {
+
+    uint8_t data[1500];
+    while (true) {
+        ssize_t received = recv(_fd, data, sizeof(data), 0);
+        if (_closing) { return; }
+        if (received < 0 and errno == EINTR) { continue; }
+        if (received < 0) { return; }
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_handler) {
+            AsyncUDPPacket packet(data, received);
+            _handler(packet);
+        }
+    }
+
+}
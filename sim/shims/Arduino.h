@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+void initArduino(void);
+void delay(uint32_t ms);
+
+/**
+ * @brief The part of the Arduino String the firmware uses,
+ * numbers are appended as decimal text
+ * 
+ */
+class String {
+
+public:
+    String() {}
+    String(const char* text) : text(text) {}
+
+    String& operator=(const char* value) { text = value; return *this; }
+    String& operator+=(const char* value) { text += value; return *this; }
+    String& operator+=(const String& value) { text += value.text; return *this; }
+    String& operator+=(char value) { text += value; return *this; }
+    String& operator+=(int value) { text += std::to_string(value); return *this; }
+    String& operator+=(unsigned int value) { text += std::to_string(value); return *this; }
+    String& operator+=(long value) { text += std::to_string(value); return *this; }
+    String& operator+=(unsigned long value) { text += std::to_string(value); return *this; }
+
+    bool operator==(const char* value) const { return text == value; }
+    bool operator==(const String& value) const { return text == value.text; }
+    bool startsWith(const char* prefix) const { return text.compare(0, strlen(prefix), prefix) == 0; }
+
+    const char* c_str() const { return text.c_str(); }
+    unsigned int length() const { return text.length(); }
+
+private:
+    std::string text;
+
+};
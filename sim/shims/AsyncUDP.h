@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "IPAddress.h"
+
+/* udp multicast on the loopback interface, packets are handed to the
+   handler from a receive thread like from the lwip task on the device */
+
+class AsyncUDPPacket {
+
+public:
+    AsyncUDPPacket(uint8_t* data, size_t length) : _data(data), _length(length) {}
+
+    uint8_t* data() { return _data; }
+    size_t length() { return _length; }
+
+private:
+    uint8_t* _data;
+    size_t _length;
+
+};
+
+typedef std::function<void(AsyncUDPPacket& packet)> AuPacketHandlerFunction;
+
+class AsyncUDP {
+
+public:
+    ~AsyncUDP();
+
+    /* joins `addr` on the loopback interface, every process on the host listening to it receives the packets */
+    bool listenMulticast(const IPAddress addr, uint16_t port, uint8_t ttl = 1);
+    void onPacket(AuPacketHandlerFunction cb);
+    size_t writeTo(const uint8_t* data, size_t len, const IPAddress addr, uint16_t port);
+
+private:
+    void receive();
+
+    int _fd = -1;
+    std::atomic<bool> _closing{ false };
+    std::thread _receiver;
+    std::mutex _lock;
+    AuPacketHandlerFunction _handler;
+
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Arduino.h"
+
+/* nothing is announced on the host */
+class MDNSResponder {
+
+public:
+    bool begin(const char* name) { return true; }
+    void addService(const char* service, const char* protocol, uint16_t port) {}
+
+};
+
+extern MDNSResponder MDNS;
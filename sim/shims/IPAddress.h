@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include "Arduino.h"
+
+class IPAddress {
+
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : octets{ a, b, c, d } {}
+
+    /* octets in network order, as in_addr.s_addr holds them */
+    operator uint32_t() const {
+        uint32_t address;
+        memcpy(&address, octets, sizeof(address));
+        return address;
+    }
+
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+        return String(text);
+    }
+
+private:
+    uint8_t octets[4];
+
+};
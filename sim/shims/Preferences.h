@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * @brief Preferences on top of a file per namespace in the working
+ * directory, every put rewrites the file like nvs_commit writes flash
+ * 
+ */
+class Preferences {
+
+public:
+    bool begin(const char* name, bool read_only = false, const char* partition_label = NULL);
+    void end() {}
+    size_t putBytes(const char* key, const void* value, size_t length);
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buffer, size_t length);
+
+private:
+    /* <SIM_NVS_DIR>/<namespace> */
+    char path[256];
+
+};
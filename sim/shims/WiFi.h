@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+typedef enum { WL_IDLE_STATUS, WL_CONNECTED } wl_status_t;
+
+/* the host is always connected, on the loopback address */
+class WiFiClass {
+
+public:
+    void begin(const char* ssid, const char* password) {}
+    wl_status_t status() { return WL_CONNECTED; }
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+
+};
+
+extern WiFiClass WiFi;
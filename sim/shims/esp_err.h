@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK      0
+#define ESP_FAIL    -1
+
+#define ESP_ERROR_CHECK(x) do {                                         \
+        esp_err_t error = (x);                                          \
+        if (error != ESP_OK) {                                          \
+            fprintf(stderr, "%s failed at %s:%d\n", #x, __FILE__, __LINE__); \
+            abort();                                                    \
+        }                                                               \
+    } while (0)
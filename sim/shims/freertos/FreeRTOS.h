@@ -0,0 +1,28 @@
+#pragma once
+
+/* FreeRTOS on top of std::thread, only what the firmware uses */
+
+#include <stdint.h>
+
+#include <mutex>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdTRUE          1
+#define pdFALSE         0
+#define pdPASS          1
+#define portMAX_DELAY   ((TickType_t)0xffffffff)
+/* CONFIG_FREERTOS_HZ is 1000 */
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+
+/* critical sections are plain mutexes, nothing runs in an interrupt */
+struct sim_mux {
+    std::mutex lock;
+};
+
+typedef struct sim_mux portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    {}
+#define portENTER_CRITICAL(mux)         ((mux)->lock.lock())
+#define portEXIT_CRITICAL(mux)          ((mux)->lock.unlock())
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+struct sim_task;
+
+typedef struct sim_task* TaskHandle_t;
+typedef void (*TaskFunction_t)(void* arg);
+
+/**
+ * @brief Runs the task on its own thread, the handle is valid before it starts
+ * 
+ */
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stack_size,
+                       void* arg, uint32_t priority, TaskHandle_t* handle);
+
+/**
+ * @brief Waits for a notification of the calling task
+ * 
+ * @param clear pdTRUE takes all notifications, pdFALSE one
+ * @param ticks longest wait in ms, portMAX_DELAY waits forever
+ * @return notification count before it was taken
+ */
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+
+void vTaskDelay(TickType_t ticks);
@@ -0,0 +1,9 @@
+#pragma once
+
+/* lwip mirrors the BSD socket api, the simulator uses the real one */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
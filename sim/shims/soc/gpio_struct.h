@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+
+/* write-one-to-set/clear output registers, every write lands in the frame trace */
+
+struct sim_gpio_set {
+    sim_gpio_set& operator=(uint32_t mask);
+};
+
+struct sim_gpio_clear {
+    sim_gpio_clear& operator=(uint32_t mask);
+};
+
+struct sim_gpio {
+    sim_gpio_set out_w1ts;
+    sim_gpio_clear out_w1tc;
+};
+
+extern sim_gpio GPIO;
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief Starts recording every change of the led outputs
+ * 
+ * @param trace trace file, NULL records nothing
+ */
+void sim_trace_begin(FILE* trace);
+
+/**
+ * @brief Makes esp_timer_get_time run fast or slow like the oscillator
+ * of a real controller, timer deadlines stay on the host clock
+ * 
+ * @param ppm error in parts per million, positive runs fast
+ */
+void sim_clock_skew(int32_t ppm);
+
+/**
+ * @brief Levels of all outputs, bit n is GPIO_NUM_n
+ * 
+ */
+uint32_t sim_levels(void);
+
+typedef struct {
+    uint64_t frames;        /* writes started on the rmt channel */
+    uint64_t overlaps;      /* writes started while the previous frame was still on the wire */
+    int64_t wire_ns;        /* time all frames took on the wire */
+} sim_rmt_stats_t;
+
+/**
+ * @brief Counters of the emulated rmt channel
+ * 
+ */
+sim_rmt_stats_t sim_rmt_stats(void);
+
+/**
+ * @brief Copies the symbols of the last write
+ * 
+ * @return number of symbols of the last write, even when more than `size`
+ */
+size_t sim_rmt_last_frame(uint32_t* symbols, size_t size);
@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <thread>
+
+#include "esp_timer.h"
+
+#include "macros.h"
+#include "clock.h"
+#include "sync.h"
+#include "sim.h"
+
+/*
+ * Runs a leader and followers with oscillators off by up to 500 ppm, each in
+ * a process of its own. Beacons go through sync.cpp over udp multicast on the
+ * loopback interface. Every process ticks every TICK_PERIOD and keeps its frame
+ * clock the way show_frame does. The followers compare their position with the
+ * leader's on the host clock all processes share, and have to stay within 1 ms
+ * of it once the first seconds have passed.
+ *   sync_test [seconds]
+ */
+
+#define SYNC_TEST_RATE      4000
+#define SYNC_TEST_SETTLE    2000000
+
+static const int32_t follower_ppm[] = { 500, -500, 250 };
+#define SYNC_TEST_FOLLOWERS (sizeof(follower_ppm) / sizeof(follower_ppm[0]))
+
+/* shared by all processes */
+typedef struct {
+    /* leader position at `start` on the host clock */
+    std::atomic<bool> leader_ready;
+    int64_t start;
+    uint64_t position;
+    struct {
+        int64_t worst;
+        /* worst over the last second */
+        int64_t settled;
+        long beacons;
+        int32_t trim;
+    } followers[SYNC_TEST_FOLLOWERS];
+} shared_t;
+
+static shared_t* shared;
+
+
+/**
+ * @brief Microseconds on the host clock, the same in every process
+ */
+static int64_t host_time(void) {
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+}
+
+
+static int leader(double seconds) {
+
+    if (not sync_begin()) {
+        fprintf(stderr, "leader: can't join the multicast group\n");
+        return 1;
+    }
+    frame_clock_t clock;
+    int64_t now = esp_timer_get_time();
+    shared->start = host_time();
+    frame_clock_init(&clock, SYNC_TEST_RATE, now);
+    shared->position = frame_clock_position(&clock, now);
+    shared->leader_ready = true;
+
+    auto tick = std::chrono::steady_clock::now();
+    auto end = tick + std::chrono::duration<std::chrono::steady_clock::rep, std::micro>((long)(seconds * 1e6));
+    while (tick < end) {
+        tick += std::chrono::microseconds(TICK_PERIOD);
+        std::this_thread::sleep_until(tick);
+        now = esp_timer_get_time();
+        bool beat = sync_due(now);
+        frame_clock_advance(&clock, now);
+        if (beat) {
+            sync_beacon_t beacon = {};
+            beacon.position = clock.frame * FRAME_CLOCK_ONE + clock.phase;
+            beacon.time = now;
+            beacon.frame_rate = SYNC_TEST_RATE;
+            sync_send(&beacon);
+        }
+    }
+    return 0;
+
+}
+
+
+static int follower(int index, double seconds) {
+
+    sim_clock_skew(follower_ppm[index]);
+    if (not sync_begin()) {
+        fprintf(stderr, "follower: can't join the multicast group\n");
+        return 1;
+    }
+    while (not shared->leader_ready) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+    frame_clock_t clock;
+    frame_clock_init(&clock, SYNC_TEST_RATE, esp_timer_get_time());
+    int64_t worst = 0, settled = 0;
+    long beacons = 0;
+    auto tick = std::chrono::steady_clock::now();
+    auto begin = tick;
+    auto end = tick + std::chrono::duration<std::chrono::steady_clock::rep, std::micro>((long)(seconds * 1e6));
+    while (tick < end) {
+        tick += std::chrono::microseconds(TICK_PERIOD);
+        std::this_thread::sleep_until(tick);
+        int64_t now = esp_timer_get_time();
+
+        sync_beacon_t beacon;
+        if (sync_receive(&beacon)) {
+            beacons++;
+            if (beacon.frame_rate != clock.rate) { frame_clock_set_rate(&clock, beacon.frame_rate, now); }
+            frame_clock_discipline(&clock, beacon.position, beacon.time, now);
+        }
+        frame_clock_advance(&clock, now);
+
+        /* the leader's clock runs on the host clock, its position follows from the start */
+        int64_t host = host_time();
+        uint64_t leader_position = shared->position + (uint64_t)(host - shared->start) * SYNC_TEST_RATE;
+        int64_t error = (int64_t)(frame_clock_position(&clock, esp_timer_get_time()) - leader_position) / SYNC_TEST_RATE;
+        if (tick - begin > std::chrono::microseconds(SYNC_TEST_SETTLE) and llabs(error) > worst) { worst = llabs(error); }
+        if (end - tick < std::chrono::seconds(1) and llabs(error) > settled) { settled = llabs(error); }
+    }
+
+    shared->followers[index].worst = worst;
+    shared->followers[index].settled = settled;
+    shared->followers[index].beacons = beacons;
+    shared->followers[index].trim = clock.trim;
+    return 0;
+
+}
+
+
+int main(int argc, char** argv) {
+
+    double seconds = argc > 1 ? atof(argv[1]) : 6.0;
+
+    void* memory = mmap(NULL, sizeof(shared_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) { return 1; }
+    shared = new (memory) shared_t();
+
+    pid_t children[SYNC_TEST_FOLLOWERS + 1];
+    for (size_t i = 0; i <= SYNC_TEST_FOLLOWERS; i++) {
+        children[i] = fork();
+        if (children[i] == 0) { _exit(i == 0 ? leader(seconds) : follower(i - 1, seconds)); }
+    }
+    int failures = 0;
+    for (pid_t child : children) {
+        int status;
+        waitpid(child, &status, 0);
+        if (not WIFEXITED(status) or WEXITSTATUS(status) != 0) { failures++; }
+    }
+
+    for (size_t i = 0; i < SYNC_TEST_FOLLOWERS; i++) {
+        printf("%+5d ppm follower: worst error %lld us, %lld us in the last second, %ld beacons, trim %d ppm\n",
+               (int)follower_ppm[i], (long long)shared->followers[i].worst, (long long)shared->followers[i].settled,
+               shared->followers[i].beacons, (int)shared->followers[i].trim);
+        if (shared->followers[i].beacons == 0 or shared->followers[i].worst >= 1000) { failures++; }
+    }
+    printf("sync: %d checks failed\n", failures);
+    return failures ? 1 : 0;
+
+}
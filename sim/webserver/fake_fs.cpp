@@ -0,0 +1,156 @@
+/*
+ * Flash file systems of the host build. Every partition is a directory, mounting
+ * it only makes sure the base path exists. The real SPIFFS, LittleFS and FFat
+ * classes sit on top and read through the real VFSImpl over stdio, so the three
+ * differ here only in the library code around the files, not in flash access.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "diskio_wl.h"
+#include "esp_spiffs.h"
+#include "esp_vfs_fat.h"
+#include "sdkconfig.h"
+extern "C" {
+#include "esp_littlefs.h"
+}
+
+/* "spiffs:label" and so on to the directory the partition is mounted on */
+static std::map<std::string, std::string> mounted;
+/* FAT volumes by wear levelling handle */
+static std::vector<std::string> fat_volumes;
+
+
+static std::string partition(const char* kind, const char* label) {
+
+    return std::string(kind) + ':' + (label ? label : "");
+
+}
+
+
+static esp_err_t mount(const std::string& name, const char* base_path) {
+
+    if (not base_path or (mkdir(base_path, 0755) and errno != EEXIST)) { return ESP_FAIL; }
+    mounted[name] = base_path;
+    return ESP_OK;
+
+}
+
+
+static esp_err_t unmount(const std::string& name) {
+
+    return mounted.erase(name) ? ESP_OK : ESP_FAIL;
+
+}
+
+
+static esp_err_t info(const std::string& name, size_t* total_bytes, size_t* used_bytes) {
+
+    auto volume = mounted.find(name);
+    struct statvfs stats;
+    if (volume == mounted.end() or statvfs(volume->second.c_str(), &stats)) { return ESP_FAIL; }
+    *total_bytes = stats.f_blocks * stats.f_frsize;
+    *used_bytes = (stats.f_blocks - stats.f_bfree) * stats.f_frsize;
+    return ESP_OK;
+
+}
+
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t* conf) { return mount(partition("spiffs", conf->partition_label), conf->base_path); }
+esp_err_t esp_vfs_spiffs_unregister(const char* partition_label) { return unmount(partition("spiffs", partition_label)); }
+bool esp_spiffs_mounted(const char* partition_label) { return mounted.count(partition("spiffs", partition_label)); }
+esp_err_t esp_spiffs_format(const char* partition_label) { (void)partition_label; return ESP_OK; }
+esp_err_t esp_spiffs_info(const char* partition_label, size_t* total_bytes, size_t* used_bytes) { return info(partition("spiffs", partition_label), total_bytes, used_bytes); }
+
+esp_err_t esp_vfs_littlefs_register(const esp_vfs_littlefs_conf_t* conf) { return mount(partition("littlefs", conf->partition_label), conf->base_path); }
+esp_err_t esp_vfs_littlefs_unregister(const char* partition_label) { return unmount(partition("littlefs", partition_label)); }
+bool esp_littlefs_mounted(const char* partition_label) { return mounted.count(partition("littlefs", partition_label)); }
+esp_err_t esp_littlefs_format(const char* partition_label) { (void)partition_label; return ESP_OK; }
+esp_err_t esp_littlefs_info(const char* partition_label, size_t* total_bytes, size_t* used_bytes) { return info(partition("littlefs", partition_label), total_bytes, used_bytes); }
+
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char* label) {
+
+    /* the partition table has whatever is asked for */
+    static esp_partition_t found;
+    found.type = type;
+    found.subtype = subtype;
+    found.address = 0;
+    found.size = 1024 * 1024;
+    strncpy(found.label, label ? label : "", sizeof(found.label) - 1);
+    return &found;
+
+}
+
+
+esp_err_t wl_mount(const esp_partition_t* partition, wl_handle_t* out_handle) {
+
+    (void)partition;
+    *out_handle = WL_INVALID_HANDLE;
+    return ESP_FAIL;
+
+}
+
+
+esp_err_t wl_unmount(wl_handle_t handle) { (void)handle; return ESP_OK; }
+esp_err_t wl_erase_range(wl_handle_t handle, size_t start_addr, size_t size) { (void)handle; (void)start_addr; (void)size; return ESP_OK; }
+size_t wl_size(wl_handle_t handle) { (void)handle; return 0; }
+
+
+esp_err_t esp_vfs_fat_spiflash_mount(const char* base_path, const char* partition_label,
+                                     const esp_vfs_fat_mount_config_t* mount_config, wl_handle_t* wl_handle) {
+
+    (void)mount_config;
+    *wl_handle = WL_INVALID_HANDLE;
+    esp_err_t err = mount(partition("ffat", partition_label), base_path);
+    if (err == ESP_OK) {
+        *wl_handle = fat_volumes.size();
+        fat_volumes.push_back(base_path);
+    }
+    return err;
+
+}
+
+
+esp_err_t esp_vfs_fat_spiflash_unmount(const char* base_path, wl_handle_t wl_handle) {
+
+    if (wl_handle < 0 or (size_t)wl_handle >= fat_volumes.size() or fat_volumes[wl_handle] != base_path) { return ESP_FAIL; }
+    for (auto volume = mounted.begin(); volume != mounted.end(); ++volume) {
+        if (volume->second == base_path) {
+            mounted.erase(volume);
+            break;
+        }
+    }
+    fat_volumes[wl_handle].clear();
+    return ESP_OK;
+
+}
+
+
+BYTE ff_diskio_get_pdrv_wl(wl_handle_t flash_handle) { return (BYTE)flash_handle; }
+
+
+FRESULT f_getfree(const char* path, DWORD* nclst, FATFS** fatfs) {
+
+    /* one sector per cluster, "0:" is the volume of handle 0 */
+    static FATFS volume;
+    size_t drive = path ? (size_t)atoi(path) : fat_volumes.size();
+    struct statvfs stats;
+    if (drive >= fat_volumes.size() or fat_volumes[drive].empty() or statvfs(fat_volumes[drive].c_str(), &stats)) {
+        return FR_NOT_READY;
+    }
+    volume.n_fatent = stats.f_blocks * stats.f_frsize / CONFIG_WL_SECTOR_SIZE + 2;
+    volume.csize = 1;
+    *nclst = stats.f_bfree * stats.f_frsize / CONFIG_WL_SECTOR_SIZE;
+    *fatfs = &volume;
+    return FR_OK;
+
+}
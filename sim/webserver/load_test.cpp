@@ -0,0 +1,253 @@
+/* ahead of the socket headers, IPAddress.h declares its own INADDR_NONE */
+#include "WebServer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/*
+ * Serves keep-alive clients over loopback with the vendored WebServer library
+ * and reports requests per second for 1 to 32 clients, once with the single
+ * client handleClient() and once with enableConcurrency(), with a slot per
+ * client or the default WEBSERVER_MAX_CLIENTS slots. The +slow columns add a
+ * client that trickles its request one byte every 10 ms. Last, the cpu time and
+ * handleClient() calls of the concurrent server with no client, and while only
+ * the slow client is connected.
+ *   webserver_load [seconds per run] [port]
+ */
+
+static const char request_text[] = "GET /hello HTTP/1.1\r\nHost: sim\r\n\r\n";
+
+typedef enum {
+    MODE_SINGLE,        /* handleClient() without enableConcurrency() */
+    MODE_CONCURRENT,    /* enableConcurrency(), one task calls handleClient() */
+    MODE_FEW_SLOTS,     /* enableConcurrency() with the default slot count */
+    MODE_WORKERS,       /* enableConcurrency(), two tasks call handleClient(), handlers still run one at a time */
+} server_mode;
+
+
+static int connect_to(int port) {
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    /* the single client server never closes a connection it stopped serving */
+    struct timeval timeout = { 0, 500000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+
+}
+
+
+/**
+ * @brief Reads one response, headers and Content-Length body
+ *
+ * @return true when the connection can take the next request
+ */
+static bool read_response(int fd, bool* complete) {
+
+    char buffer[1024];
+    size_t received = 0;
+    *complete = false;
+    while (received < sizeof(buffer) - 1) {
+        int part = recv(fd, buffer + received, sizeof(buffer) - 1 - received, 0);
+        if (part <= 0) { return false; }
+        received += part;
+        buffer[received] = '\0';
+        char* end = strstr(buffer, "\r\n\r\n");
+        if (not end) { continue; }
+        const char* length = strcasestr(buffer, "Content-Length:");
+        size_t body = length ? strtoul(length + 15, NULL, 10) : 0;
+        if (received < (size_t)(end + 4 - buffer) + body) { continue; }
+        *complete = true;
+        return not strcasestr(buffer, "Connection: close");
+    }
+    return false;
+
+}
+
+
+/**
+ * @brief Sends requests one after another, reconnecting whenever the server closes
+ */
+static void run_client(int port, const std::atomic<bool>* running, std::atomic<long>* served) {
+
+    int fd = -1;
+    while (*running) {
+        if (fd < 0) {
+            fd = connect_to(port);
+            if (fd < 0) { continue; }
+        }
+        bool complete;
+        send(fd, request_text, sizeof(request_text) - 1, MSG_NOSIGNAL);
+        bool keep = read_response(fd, &complete);
+        if (complete) { (*served)++; }
+        if (not keep) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (fd >= 0) { close(fd); }
+
+}
+
+
+/**
+ * @brief Holds a connection and sends its request a byte at a time
+ */
+static void run_slow_client(int port, const std::atomic<bool>* running) {
+
+    while (*running) {
+        int fd = connect_to(port);
+        if (fd < 0) { continue; }
+        for (size_t i = 0; i < sizeof(request_text) - 1 and *running; i++) {
+            send(fd, request_text + i, 1, MSG_NOSIGNAL);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        bool complete;
+        if (*running) { read_response(fd, &complete); }
+        close(fd);
+    }
+
+}
+
+
+static double measure(server_mode mode, int clients, bool slow, double seconds, int port) {
+
+    WebServer server(port);
+    server.on("/hello", [&server]() { server.send(200, "text/plain", "hello"); });
+    if (mode == MODE_FEW_SLOTS) {
+        server.enableConcurrency();
+    } else if (mode != MODE_SINGLE) {
+        server.enableConcurrency(clients + 1 > WEBSERVER_MAX_CLIENTS ? clients + 1 : WEBSERVER_MAX_CLIENTS);
+    }
+    server.begin();
+
+    std::atomic<bool> serving(true);
+    std::vector<std::thread> workers;
+    int worker_count = mode == MODE_WORKERS ? 2 : 1;
+    for (int i = 0; i < worker_count; i++) {
+        workers.emplace_back([&server, &serving]() {
+            while (serving) { server.handleClient(); }
+        });
+    }
+
+    std::atomic<bool> running(true);
+    std::atomic<long> served(0);
+    std::vector<std::thread> threads;
+    if (slow) { threads.emplace_back(run_slow_client, port, &running); }
+    for (int i = 0; i < clients; i++) {
+        threads.emplace_back(run_client, port, &running, &served);
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    long count = served;
+    running = false;
+    serving = false;
+    for (std::thread& worker : workers) { worker.join(); }
+    server.close();
+    for (std::thread& thread : threads) { thread.join(); }
+    return count / seconds;
+
+}
+
+
+static double cpu_seconds(void) {
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+
+}
+
+
+/**
+ * @brief Share of a core the concurrent server takes and its handleClient()
+ * calls per second while the slow client sends its request, or with no client
+ */
+static void measure_waiting(bool slow_client, double seconds, int port, double* cpu_share, double* calls) {
+
+    WebServer server(port);
+    server.on("/hello", [&server]() { server.send(200, "text/plain", "hello"); });
+    server.enableConcurrency();
+    server.begin();
+
+    std::atomic<bool> serving(true);
+    std::atomic<long> handled(0);
+    std::thread worker([&server, &serving, &handled]() {
+        while (serving) {
+            server.handleClient();
+            handled++;
+        }
+    });
+    std::atomic<bool> running(true);
+    std::thread slow;
+    if (slow_client) { slow = std::thread(run_slow_client, port, &running); }
+
+    /* the slow client is on its first bytes by now */
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    long before = handled;
+    double cpu = cpu_seconds();
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    *cpu_share = (cpu_seconds() - cpu) / elapsed;
+    *calls = (handled - before) / elapsed;
+
+    running = false;
+    serving = false;
+    worker.join();
+    server.close();
+    if (slow_client) { slow.join(); }
+
+}
+
+
+int main(int argc, char** argv) {
+
+    double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+    int port = argc > 2 ? atoi(argv[2]) : 8181;
+    static const int client_counts[] = { 1, 2, 4, 8, 16, 32 };
+    /* lwip has no signals, a write to a reset connection just fails */
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("%7s %12s %12s %12s %12s %12s %12s\n", "clients", "single", "concurrent", "2 workers", "4 slots", "single+slow", "conc.+slow");
+    for (int clients : client_counts) {
+        double single = measure(MODE_SINGLE, clients, false, seconds, port);
+        double concurrent = measure(MODE_CONCURRENT, clients, false, seconds, port);
+        double workers = measure(MODE_WORKERS, clients, false, seconds, port);
+        double few_slots = measure(MODE_FEW_SLOTS, clients, false, seconds, port);
+        double single_slow = measure(MODE_SINGLE, clients, true, seconds, port);
+        double concurrent_slow = measure(MODE_CONCURRENT, clients, true, seconds, port);
+        printf("%7d %12.0f %12.0f %12.0f %12.0f %12.0f %12.0f\n", clients, single, concurrent, workers, few_slots, single_slow, concurrent_slow);
+    }
+
+    /* the 1 ms select() timeout of enableDelay() paces the calls, a waiting client adds none */
+    double cpu_share, calls;
+    measure_waiting(false, seconds, port, &cpu_share, &calls);
+    printf("\nno client:         %.1f %% cpu, %.0f handleClient() calls/s\n", cpu_share * 100, calls);
+    measure_waiting(true, seconds, port, &cpu_share, &calls);
+    printf("slow client alone: %.1f %% cpu, %.0f handleClient() calls/s\n", cpu_share * 100, calls);
+    return 0;
+
+}
@@ -0,0 +1,395 @@
+/* ahead of the socket headers, IPAddress.h declares its own INADDR_NONE */
+#include "WebServer.h"
+
+#include <malloc.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Checks the indices collectHeaders() gives the user's header keys, and the
+ * arena parser of enableConcurrency() against the String parser, also for
+ * requests arriving in pieces, longer than the arena or pipelined, and
+ * counts the heap allocations the server makes per request, outside and inside
+ * the handler, with the live heap after warming up and after all requests.
+ * malloc and friends are wrapped at link time.
+ *   webserver_parse_bench [requests] [port]
+ */
+
+static std::atomic<long> allocations(0);
+static std::atomic<long> handler_allocations(0);
+static std::atomic<long> live_bytes(0);
+static std::atomic<long> peak_bytes(0);
+
+/* set on the server thread, cleared while a handler runs */
+static thread_local int counting = 0;
+
+extern "C" void* __real_malloc(size_t size);
+extern "C" void* __real_calloc(size_t count, size_t size);
+extern "C" void* __real_realloc(void* pointer, size_t size);
+extern "C" void __real_free(void* pointer);
+
+
+static void count(void* pointer, long released) {
+
+    if (counting == 1) { allocations++; }
+    if (counting == 2) { handler_allocations++; }
+    long live = live_bytes += (pointer ? (long)malloc_usable_size(pointer) : 0) - released;
+    long peak = peak_bytes;
+    while (live > peak and not peak_bytes.compare_exchange_weak(peak, live)) {}
+
+}
+
+
+extern "C" void* __wrap_malloc(size_t size) {
+
+    void* pointer = __real_malloc(size);
+    count(pointer, 0);
+    return pointer;
+
+}
+
+
+extern "C" void* __wrap_calloc(size_t number, size_t size) {
+
+    void* pointer = __real_calloc(number, size);
+    count(pointer, 0);
+    return pointer;
+
+}
+
+
+extern "C" void* __wrap_realloc(void* pointer, size_t size) {
+
+    long released = pointer ? (long)malloc_usable_size(pointer) : 0;
+    void* moved = __real_realloc(pointer, size);
+    count(moved, released);
+    return moved;
+
+}
+
+
+extern "C" void __wrap_free(void* pointer) {
+
+    if (pointer) { live_bytes -= (long)malloc_usable_size(pointer); }
+    __real_free(pointer);
+
+}
+
+void* operator new(size_t size) { return __wrap_malloc(size); }
+void* operator new[](size_t size) { return __wrap_malloc(size); }
+void operator delete(void* pointer) noexcept { __wrap_free(pointer); }
+void operator delete[](void* pointer) noexcept { __wrap_free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { __wrap_free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { __wrap_free(pointer); }
+
+/* requests the two parsers have to agree on, %s is the Connection header */
+static const char* const parity_requests[] = {
+    "GET /echo HTTP/1.1\r\nHost: sim\r\nConnection: %s\r\n\r\n",
+    "GET /echo?led=3&color=%%23ff8800&name=kitchen+lights HTTP/1.1\r\nHost: sim\r\nUser-Agent: bench/1.0\r\nConnection: %s\r\n\r\n",
+    "GET /headers HTTP/1.1\r\nHost: sim\r\nRange: bytes=0-9\r\nAuthorization: Basic eDp5\r\nIf-None-Match: \"1\"\r\nUser-Agent: ua\r\nConnection: %s\r\n\r\n",
+    "GET /echo?a=1&&novalue&b=&=x&c=%%41%%4 HTTP/1.1\r\nhost: lower.case\r\nConnection: %s\r\n\r\n",
+    "POST /echo?q=1 HTTP/1.1\r\nHost: sim\r\nContent-Type: application/x-www-form-urlencoded\r\nContent-Length: 19\r\nConnection: %s\r\n\r\nspeed=12&mode=a%%2Bb",
+    "POST /echo HTTP/1.1\r\nHost: sim\r\nContent-Type: application/json\r\nContent-Length: 13\r\nConnection: %s\r\n\r\n{\"led\":[1,2]}",
+    "PUT /echo?x=%%20y HTTP/1.1\r\nHost: sim\r\nContent-Length: 0\r\nConnection: %s\r\n\r\n",
+    "GET /missing?x=1 HTTP/1.1\r\nHost: sim\r\nConnection: %s\r\n\r\n",
+};
+
+static const char bench_request[] =
+    "GET /echo?led=3&color=%23ff8800&name=kitchen+lights HTTP/1.1\r\n"
+    "Host: esp32-led-controller.local\r\nUser-Agent: bench/1.0\r\nAccept: */*\r\n\r\n";
+
+
+static int connect_to(int port) {
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    struct timeval timeout = { 2, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+
+}
+
+
+/**
+ * @brief Reads `count` responses and returns the start of the status line and
+ * the body of each, empty when they don't all come
+ */
+static std::string receive(int fd, int count) {
+
+    std::string text, answers;
+    char buffer[4096];
+    while (count > 0) {
+        size_t end = text.find("\r\n\r\n");
+        if (end != std::string::npos) {
+            std::string head = text.substr(0, end);
+            const char* length = strcasestr(head.c_str(), "Content-Length:");
+            size_t body = length ? strtoul(length + 15, NULL, 10) : 0;
+            if (text.size() >= end + 4 + body) {
+                answers += text.substr(0, 12) + text.substr(end + 4, body);
+                text.erase(0, end + 4 + body);
+                count--;
+                continue;
+            }
+        }
+        int part = recv(fd, buffer, sizeof(buffer), 0);
+        if (part <= 0) { return std::string(); }
+        text.append(buffer, part);
+    }
+    return answers;
+
+}
+
+
+/**
+ * @brief Sends a request and returns the body of the response, empty when there is none
+ */
+static std::string exchange(int fd, const char* text) {
+
+    send(fd, text, strlen(text), MSG_NOSIGNAL);
+    return receive(fd, 1);
+
+}
+
+
+class bench_server {
+
+public:
+    WebServer server;
+    std::atomic<bool> serving;
+    std::thread thread;
+
+    bench_server(int port, bool concurrent) : server(port), serving(true) {
+
+        static const char* header_keys[] = { "User-Agent" };
+        server.collectHeaders(header_keys, 1);
+        server.on("/echo", [this]() {
+            counting = 2;
+            String body = server.uri();
+            body += '|';
+            body += server.hostHeader();
+            body += '|';
+            body += server.header("User-Agent");
+            for (int i = 0; i < server.args(); i++) {
+                body += '|';
+                body += server.argName(i);
+                body += '=';
+                body += server.arg(i);
+            }
+            body += server.hasArg("color") ? "|color:" + server.arg("color") : String("|no color");
+            server.send(200, "text/plain", body);
+            counting = 1;
+        });
+        /* Authorization and the collected keys, in their order */
+        server.on("/headers", [this]() {
+            String body;
+            for (int i = 0; i < server.headers(); i++) {
+                body += server.headerName(i);
+                body += ':';
+                body += server.header(i);
+                body += '|';
+            }
+            server.send(200, "text/plain", body);
+        });
+        if (concurrent) { server.enableConcurrency(); }
+        server.begin();
+        thread = std::thread([this]() {
+            counting = 1;
+            while (serving) { server.handleClient(); }
+            counting = 0;
+        });
+
+    }
+
+    ~bench_server() {
+
+        serving = false;
+        thread.join();
+        server.close();
+
+    }
+
+};
+
+
+/**
+ * @brief Authorization comes first and the user's keys follow in their order,
+ * the keys the library collects for itself are not counted
+ */
+static int check_header_indices(int port) {
+
+    WebServer server(port);
+    static const char* header_keys[] = { "User-Agent", "X-Led" };
+    server.collectHeaders(header_keys, 2);
+    server.begin();
+    bool indices = server.headers() == 3 and server.headerName(0) == "Authorization" and
+                   server.headerName(1) == "User-Agent" and server.headerName(2) == "X-Led" and
+                   server.headerName(3) == "" and server.header(3) == "";
+    server.close();
+    if (not indices) { printf("collectHeaders() moved the user's header keys\n"); }
+    return indices ? 0 : 1;
+
+}
+
+
+static int check_parity(int port) {
+
+    int mismatches = 0;
+    for (const char* format : parity_requests) {
+        char request[512];
+        snprintf(request, sizeof(request), format, "close");
+        std::string single, concurrent;
+        {
+            bench_server bench(port, false);
+            int fd = connect_to(port);
+            single = exchange(fd, request);
+            close(fd);
+        }
+        {
+            bench_server bench(port, true);
+            int fd = connect_to(port);
+            snprintf(request, sizeof(request), format, "keep-alive");
+            concurrent = exchange(fd, request);
+            close(fd);
+        }
+        if (single != concurrent or single.empty()) {
+            printf("mismatch for %.40s...\n  String parser: %s\n  arena parser:  %s\n", request, single.c_str(), concurrent.c_str());
+            mismatches++;
+        }
+    }
+    printf("parity: %zu requests, %d mismatches\n", sizeof(parity_requests) / sizeof(parity_requests[0]), mismatches);
+    return mismatches;
+
+}
+
+
+/**
+ * @brief Requests the slots take in pieces, sent a few bytes at a time, longer
+ * than the arena, multipart, or pipelined in one write, have to get the answers
+ * the String parser gives each request on a connection of its own
+ */
+static int check_arrival(int port) {
+
+    std::string upload = "--b\r\nContent-Disposition: form-data; name=\"mode\"\r\n\r\nfast\r\n--b--\r\n";
+    const struct {
+        const char* name;
+        std::vector<std::string> requests;
+        /* bytes per send, 0 sends all requests at once */
+        size_t piece;
+    } cases[] = {
+        { "a few bytes at a time", { "GET /echo?led=1 HTTP/1.1\r\nHost: sim\r\nUser-Agent: slow\r\n\r\n" }, 5 },
+        { "longer than the arena", { "GET /echo?pad=" + std::string(2000, 'x') + " HTTP/1.1\r\nHost: sim\r\n\r\n" }, 1000 },
+        { "multipart", { "POST /echo HTTP/1.1\r\nHost: sim\r\nContent-Type: multipart/form-data; boundary=b\r\nContent-Length: " +
+                         std::to_string(upload.size()) + "\r\n\r\n" + upload }, 40 },
+        { "pipelined", { "GET /echo?n=1 HTTP/1.1\r\nHost: sim\r\n\r\n", "POST /echo?n=2 HTTP/1.1\r\nHost: sim\r\nContent-Length: 4\r\n\r\nbody",
+                         "GET /headers HTTP/1.1\r\nHost: sim\r\nUser-Agent: third\r\n\r\n" }, 0 },
+    };
+    int failures = 0;
+    for (auto& check : cases) {
+        std::string expected, answers, text;
+        {
+            bench_server bench(port, false);
+            for (const std::string& request : check.requests) {
+                int fd = connect_to(port);
+                expected += exchange(fd, request.c_str());
+                close(fd);
+                text += request;
+            }
+        }
+        {
+            bench_server bench(port, true);
+            int fd = connect_to(port);
+            size_t piece = check.piece ? check.piece : text.size();
+            for (size_t sent = 0; sent < text.size(); sent += piece) {
+                send(fd, text.data() + sent, std::min(piece, text.size() - sent), MSG_NOSIGNAL);
+                usleep(5000);
+            }
+            answers = receive(fd, check.requests.size());
+            close(fd);
+        }
+        if (answers != expected or expected.empty()) {
+            printf("%s: expected %.80s\n  got %.80s\n", check.name, expected.c_str(), answers.c_str());
+            failures++;
+        }
+    }
+    printf("arrival: %zu cases, %d wrong\n", sizeof(cases) / sizeof(cases[0]), failures);
+    return failures;
+
+}
+
+
+static void measure(const char* name, int port, bool concurrent, bool keep_alive, long requests) {
+
+    bench_server bench(port, concurrent);
+    char request[512];
+    snprintf(request, sizeof(request), "%.*s%s\r\n\r\n", (int)sizeof(bench_request) - 5, bench_request,
+             keep_alive ? "" : "\r\nConnection: close");
+    long warm_up = requests / 100;
+    long live_after_warm_up = 0;
+    allocations = 0;
+    handler_allocations = 0;
+    int fd = -1;
+    for (long i = 0; i < requests + warm_up; i++) {
+        if (i == warm_up) {
+            allocations = 0;
+            handler_allocations = 0;
+            live_after_warm_up = live_bytes;
+            peak_bytes = live_bytes.load();
+        }
+        if (fd < 0) { fd = connect_to(port); }
+        if (exchange(fd, request).empty()) {
+            printf("%s: request %ld failed\n", name, i);
+            break;
+        }
+        if (not keep_alive) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (fd >= 0) { close(fd); }
+    /* the last response is sent before the handler returns */
+    usleep(10000);
+    printf("%-22s %9ld %10.2f %10.2f %12ld %12ld %12ld\n", name, requests,
+           (double)allocations / requests, (double)handler_allocations / requests,
+           live_after_warm_up, live_bytes.load(), peak_bytes.load());
+
+}
+
+
+int main(int argc, char** argv) {
+
+    long requests = argc > 1 ? atol(argv[1]) : 100000;
+    int port = argc > 2 ? atoi(argv[2]) : 8182;
+    /* lwip has no signals, a write to a reset connection just fails */
+    signal(SIGPIPE, SIG_IGN);
+
+    if (check_header_indices(port) or check_parity(port) or check_arrival(port)) { return 1; }
+    printf("%-22s %9s %10s %10s %12s %12s %12s\n", "", "requests", "allocs/req", "handler", "live warm", "live end", "peak");
+    measure("String parser, close", port, false, false, requests / 5);
+    measure("arena parser, close", port, true, false, requests / 5);
+    measure("arena parser", port, true, true, requests);
+    return 0;
+
+}
@@ -0,0 +1,273 @@
+/* ahead of the socket headers, IPAddress.h declares its own INADDR_NONE */
+#include "WebServer.h"
+#include "FFat.h"
+#include "LittleFS.h"
+#include "SPIFFS.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+
+/*
+ * Serves 100 KB and 1 MB files from SPIFFS, LittleFS and FFat over loopback and
+ * reports MB/s, once through the generic Stream path of streamFile() and once
+ * through the block reads of streamFile(File&). The partitions are directories
+ * of a temporary folder (fake_fs.cpp). Range requests are checked first.
+ *   webserver_serve_bench [seconds per run] [port]
+ */
+
+typedef struct {
+    const char* name;
+    fs::FS* fs;
+    std::string base_path;
+} file_system;
+
+typedef struct {
+    const char* path;
+    size_t size;
+    std::string content;
+} test_file;
+
+static file_system file_systems[] = {
+    { "SPIFFS", &SPIFFS, "" },
+    { "LittleFS", &LittleFS, "" },
+    { "FFat", &FFat, "" },
+};
+
+static test_file test_files[] = {
+    { "/100k.bin", 100 * 1024, "" },
+    { "/1m.bin", 1024 * 1024, "" },
+};
+
+
+/**
+ * @brief A File behind a plain Stream, so streamFile() takes its generic path
+ */
+class stream_file : public Stream {
+
+public:
+    File& file;
+
+    explicit stream_file(File& file) : file(file) {}
+
+    int available() override { return file.available(); }
+    int read() override { return file.read(); }
+    int peek() override { return file.peek(); }
+    void flush() override {}
+    size_t write(uint8_t) override { return 0; }
+    using Stream::readBytes;
+    size_t readBytes(char* buffer, size_t length) override { return file.read((uint8_t*)buffer, length); }
+    size_t size() const { return file.size(); }
+    const char* name() const { return file.name(); }
+
+};
+
+
+typedef struct {
+    int status;
+    std::string head;
+    std::string body;
+} response;
+
+
+static bool get(int port, const std::string& uri, const char* range, response* result) {
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        close(fd);
+        return false;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    struct timeval timeout = { 5, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string request = "GET " + uri + " HTTP/1.1\r\nHost: sim\r\nConnection: close\r\n";
+    if (range) { request += std::string("Range: ") + range + "\r\n"; }
+    request += "\r\n";
+    send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+
+    std::string text;
+    static char buffer[64 * 1024];
+    ssize_t part;
+    while ((part = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        text.append(buffer, part);
+    }
+    close(fd);
+    size_t end = text.find("\r\n\r\n");
+    if (end == std::string::npos or text.size() < 12) { return false; }
+    result->status = atoi(text.c_str() + 9);
+    result->head = text.substr(0, end);
+    result->body = text.substr(end + 4);
+    return true;
+
+}
+
+
+/**
+ * @brief Checks ranges against the 100 KB file on SPIFFS
+ *
+ * @return the number of requests that came back wrong
+ */
+static int check_ranges(int port) {
+
+    static const struct {
+        const char* range;
+        int status;
+        size_t start;
+        size_t length;
+    } cases[] = {
+        { "bytes=1000-1999", 206, 1000, 1000 },
+        { "bytes=4095-70000", 206, 4095, 65906 },
+        { "bytes=-500", 206, 102400 - 500, 500 },
+        { "bytes=102000-", 206, 102000, 400 },
+        { "bytes=100000-200000", 206, 100000, 2400 },
+        { "bytes=102400-", 416, 0, 0 },
+        { "bytes=0-0,5-9", 200, 0, 102400 },
+        { "lines=1-2", 200, 0, 102400 },
+    };
+    const std::string& content = test_files[0].content;
+    int failures = 0;
+    for (auto& check : cases) {
+        response answer;
+        bool right = get(port, "/block/SPIFFS/100k.bin", check.range, &answer) and answer.status == check.status;
+        if (right and check.status == 206) {
+            char content_range[80];
+            snprintf(content_range, sizeof(content_range), "Content-Range: bytes %zu-%zu/%zu",
+                     check.start, check.start + check.length - 1, content.size());
+            right = answer.head.find(content_range) != std::string::npos;
+        }
+        if (right and check.status == 416) {
+            right = answer.head.find("Content-Range: bytes */102400") != std::string::npos;
+        }
+        if (right and check.status != 416) {
+            right = answer.body == content.substr(check.start, check.length);
+        }
+        if (not right) {
+            printf("range %s: expected %d, got %d\n%s\n", check.range, check.status, answer.status, answer.head.c_str());
+            failures++;
+        }
+    }
+    printf("range requests: %zu, %d wrong\n", sizeof(cases) / sizeof(cases[0]), failures);
+    return failures;
+
+}
+
+
+static double measure(int port, const std::string& uri, const std::string& content, double seconds, bool* intact) {
+
+    long bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    while (elapsed < seconds) {
+        response answer;
+        if (not get(port, uri, NULL, &answer) or answer.status != 200 or answer.body != content) {
+            *intact = false;
+            return 0;
+        }
+        bytes += answer.body.size();
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return bytes / elapsed / (1024 * 1024);
+
+}
+
+
+int main(int argc, char** argv) {
+
+    double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+    int port = argc > 2 ? atoi(argv[2]) : 8184;
+    /* lwip has no signals, a write to a reset connection just fails */
+    signal(SIGPIPE, SIG_IGN);
+
+    char folder[] = "/tmp/webserver-fs.XXXXXX";
+    if (not mkdtemp(folder)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    for (file_system& volume : file_systems) {
+        volume.base_path = std::string(folder) + "/" + volume.name;
+    }
+    /* the file system keeps the base path, not a copy */
+    if (not SPIFFS.begin(false, file_systems[0].base_path.c_str())
+        or not LittleFS.begin(false, file_systems[1].base_path.c_str())
+        or not FFat.begin(false, file_systems[2].base_path.c_str())) {
+        printf("mounting %s failed\n", folder);
+        return 1;
+    }
+
+    std::mt19937 random(42);
+    for (test_file& file : test_files) {
+        file.content.resize(file.size);
+        for (char& byte : file.content) { byte = (char)random(); }
+        for (file_system& volume : file_systems) {
+            File written = volume.fs->open(file.path, FILE_WRITE);
+            written.write((const uint8_t*)file.content.data(), file.content.size());
+            written.close();
+        }
+    }
+
+    WebServer server(port);
+    for (file_system& volume : file_systems) {
+        for (test_file& file : test_files) {
+            fs::FS* fs = volume.fs;
+            String path = file.path;
+            server.on(String("/stream/") + volume.name + path, [&server, fs, path]() {
+                File file = fs->open(path, FILE_READ);
+                stream_file stream(file);
+                server.streamFile(stream, "application/octet-stream");
+            });
+            server.on(String("/block/") + volume.name + path, [&server, fs, path]() {
+                File file = fs->open(path, FILE_READ);
+                server.streamFile(file, "application/octet-stream");
+            });
+        }
+    }
+    server.begin();
+    std::atomic<bool> serving(true);
+    std::thread thread([&server, &serving]() {
+        while (serving) { server.handleClient(); }
+    });
+
+    int failures = check_ranges(port);
+    printf("%-9s %8s %14s %14s\n", "", "size", "Stream MB/s", "blocks MB/s");
+    for (file_system& volume : file_systems) {
+        for (test_file& file : test_files) {
+            bool intact = true;
+            std::string uri = std::string(volume.name) + file.path;
+            double stream = measure(port, "/stream/" + uri, file.content, seconds, &intact);
+            double blocks = measure(port, "/block/" + uri, file.content, seconds, &intact);
+            failures += not intact;
+            printf("%-9s %5zu KB %14.1f %14.1f%s\n", volume.name, file.size / 1024, stream, blocks,
+                   intact ? "" : "  wrong content");
+        }
+    }
+
+    serving = false;
+    thread.join();
+    server.close();
+    for (file_system& volume : file_systems) {
+        for (test_file& file : test_files) { volume.fs->remove(file.path); }
+        rmdir(volume.base_path.c_str());
+    }
+    rmdir(folder);
+    return failures ? 1 : 0;
+
+}
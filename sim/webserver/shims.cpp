@@ -0,0 +1,82 @@
+/* Arduino core functions of the host build of the WebServer library */
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include "Arduino.h"
+#include "WiFi.h"
+
+#include <netdb.h>
+
+static const auto start = std::chrono::steady_clock::now();
+
+unsigned long micros()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long millis()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void delay(uint32_t ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield(void)
+{
+    std::this_thread::yield();
+}
+
+/* no task watchdog on the host */
+void disableCore0WDT()
+{
+}
+
+void enableCore0WDT()
+{
+}
+
+const char* pathToFileName(const char* path)
+{
+    const char* name = strrchr(path, '/');
+    return name ? name + 1 : path;
+}
+
+uint32_t esp_random(void)
+{
+    static thread_local std::mt19937 generator(std::random_device{}());
+    return generator();
+}
+
+/* newlib has these next to the ltoa and ultoa of stdlib_noniso.c, glibc doesn't */
+extern "C" char* itoa(int val, char* s, int radix)
+{
+    return ltoa(val, s, radix);
+}
+
+extern "C" char* utoa(unsigned int val, char* s, int radix)
+{
+    return ultoa(val, s, radix);
+}
+
+int WiFiGenericClass::hostByName(const char* aHostname, IPAddress& aResult)
+{
+    struct addrinfo hints = {};
+    struct addrinfo* result = nullptr;
+    hints.ai_family = AF_INET;
+    if (getaddrinfo(aHostname, nullptr, &hints, &result) != 0 or not result) {
+        return 0;
+    }
+    aResult = IPAddress(((struct sockaddr_in*)result->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo(result);
+    return 1;
+}
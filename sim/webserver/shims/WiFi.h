@@ -0,0 +1,19 @@
+#ifndef WiFi_h
+#define WiFi_h
+
+/* Stands in for the station and access point api, force included ahead of
+ * the real WiFi.h so only the client and server classes are compiled */
+
+#include "Print.h"
+#include "IPAddress.h"
+
+class WiFiGenericClass
+{
+public:
+    static int hostByName(const char* aHostname, IPAddress& aResult);
+};
+
+#include "WiFiClient.h"
+#include "WiFiServer.h"
+
+#endif
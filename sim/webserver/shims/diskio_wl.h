@@ -0,0 +1,14 @@
+#pragma once
+
+#include "ff.h"
+#include "wear_levelling.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+BYTE ff_diskio_get_pdrv_wl(wl_handle_t flash_handle);
+
+#ifdef __cplusplus
+}
+#endif
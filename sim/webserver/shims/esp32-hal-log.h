@@ -0,0 +1,19 @@
+#ifndef __ARDUHAL_LOG_H__
+#define __ARDUHAL_LOG_H__
+
+/* log_e goes to stderr when WEBSERVER_SIM_LOG is set, the chatty levels never do */
+
+#include <stdio.h>
+
+#ifdef WEBSERVER_SIM_LOG
+#define log_e(format, ...) fprintf(stderr, "[E] %s: " format "\n", __func__, ##__VA_ARGS__)
+#else
+#define log_e(format, ...) do { if (0) fprintf(stderr, format, ##__VA_ARGS__); } while (0)
+#endif
+
+#define log_w(format, ...) do { if (0) fprintf(stderr, format, ##__VA_ARGS__); } while (0)
+#define log_i(format, ...) do { if (0) fprintf(stderr, format, ##__VA_ARGS__); } while (0)
+#define log_d(format, ...) do { if (0) fprintf(stderr, format, ##__VA_ARGS__); } while (0)
+#define log_v(format, ...) do { if (0) fprintf(stderr, format, ##__VA_ARGS__); } while (0)
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef HAL_ESP32_HAL_H_
+#define HAL_ESP32_HAL_H_
+
+#include <stdint.h>
+
+#include "sdkconfig.h"
+#include "esp_err.h"
+#include "esp_system.h"
+#include "esp32-hal-log.h"
+#include "pgmspace.h"
+
+/* the library code is compiled as if it were built by ESP-IDF 4 */
+#ifndef ESP_IDF_VERSION_MAJOR
+#define ESP_IDF_VERSION_MAJOR 4
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void yield(void);
+#define optimistic_yield(u)
+
+unsigned long micros();
+unsigned long millis();
+void delay(uint32_t);
+void delayMicroseconds(uint32_t us);
+
+void disableCore0WDT();
+void enableCore0WDT();
+const char* pathToFileName(const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
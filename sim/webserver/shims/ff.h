@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint8_t BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+
+typedef struct {
+    DWORD n_fatent;     /* number of FAT entries, clusters + 2 */
+    WORD csize;         /* sectors per cluster */
+} FATFS;
+
+typedef enum {
+    FR_OK = 0,
+    FR_NOT_READY = 3,
+} FRESULT;
+
+FRESULT f_getfree(const char* path, DWORD* nclst, FATFS** fatfs);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+/* FreeRTOS on top of std::thread, only what the WebServer library uses */
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdTRUE          1
+#define pdFALSE         0
+#define portMAX_DELAY   ((TickType_t)0xffffffff)
+/* CONFIG_FREERTOS_HZ is 1000 */
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+#define portTICK_PERIOD_MS  1
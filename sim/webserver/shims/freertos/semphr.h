@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+
+#include "freertos/FreeRTOS.h"
+
+/* mutexes only, the library never uses counting or binary semaphores */
+typedef std::timed_mutex* SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return new std::timed_mutex();
+}
+
+static inline void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    delete semaphore;
+}
+
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY) {
+        semaphore->lock();
+        return pdTRUE;
+    }
+    return semaphore->try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    semaphore->unlock();
+    return pdTRUE;
+}
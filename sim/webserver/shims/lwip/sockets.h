@@ -0,0 +1,18 @@
+#pragma once
+
+/* lwip mirrors the BSD socket api, the host build maps it onto the real one */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static inline int lwip_accept(int s, struct sockaddr* addr, socklen_t* addrlen) { return accept(s, addr, addrlen); }
+static inline int lwip_connect(int s, const struct sockaddr* name, socklen_t namelen) { return connect(s, name, namelen); }
+static inline int lwip_ioctl(int s, long cmd, void* argp) { return ioctl(s, cmd, argp); }
+static inline int lwip_close(int s) { return close(s); }
@@ -0,0 +1,25 @@
+#pragma once
+
+/* Digest authentication is not exercised on the host, the hash is left zero */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef struct {
+    int unused;
+} mbedtls_md5_context;
+
+static inline void mbedtls_md5_init(mbedtls_md5_context* ctx) { (void)ctx; }
+static inline int mbedtls_md5_starts_ret(mbedtls_md5_context* ctx) { (void)ctx; return 0; }
+static inline int mbedtls_md5_update_ret(mbedtls_md5_context* ctx, const unsigned char* input, size_t ilen)
+{
+    (void)ctx; (void)input; (void)ilen;
+    return 0;
+}
+static inline int mbedtls_md5_finish_ret(mbedtls_md5_context* ctx, unsigned char output[16])
+{
+    (void)ctx;
+    memset(output, 0, 16);
+    return 0;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+/* flash file system settings, the host build mounts them on directories (fake_fs.cpp) */
+
+#define CONFIG_LITTLEFS_PAGE_SIZE   256
+#define CONFIG_WL_SECTOR_SIZE       4096
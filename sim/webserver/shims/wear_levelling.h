@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_partition.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int32_t wl_handle_t;
+
+#define WL_INVALID_HANDLE -1
+
+esp_err_t wl_mount(const esp_partition_t* partition, wl_handle_t* out_handle);
+esp_err_t wl_unmount(wl_handle_t handle);
+esp_err_t wl_erase_range(wl_handle_t handle, size_t start_addr, size_t size);
+size_t wl_size(wl_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,260 @@
+/* ahead of the socket headers, IPAddress.h declares its own INADDR_NONE */
+#include "WebServer.h"
+#include "SPIFFS.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+
+/*
+ * Serves a handful of small assets with serveStatic() from SPIFFS on a temporary
+ * directory (fake_fs.cpp) over one keep-alive connection and reports requests/s
+ * with the metadata cache of the handler cold, dropped before every request, and
+ * warm, for full responses and for If-None-Match answered with 304.
+ *   webserver_static_bench [seconds per run] [port]
+ */
+
+typedef struct {
+    const char* uri;
+    const char* file;    // on SPIFFS, app.js only exists compressed
+    const char* type;
+    size_t size;
+    std::string content;
+    std::string etag;
+} asset;
+
+static asset assets[] = {
+    { "/", "/index.htm", "text/html", 2100, "", "" },
+    { "/app.js", "/app.js.gz", "application/javascript", 8300, "", "" },
+    { "/style.css", "/style.css", "text/css", 3100, "", "" },
+    { "/logo.png", "/logo.png", "image/png", 6200, "", "" },
+    { "/config.json", "/config.json", "application/json", 700, "", "" },
+};
+
+typedef struct {
+    int status;
+    std::string head;
+    std::string body;
+} response;
+
+
+static int connect_to(int port) {
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    struct timeval timeout = { 2, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+
+}
+
+
+static std::string header(const std::string& head, const char* name) {
+
+    std::string key = std::string("\r\n") + name + ": ";
+    size_t start = head.find(key);
+    if (start == std::string::npos) { return std::string(); }
+    start += key.size();
+    return head.substr(start, head.find("\r\n", start) - start);
+
+}
+
+
+/**
+ * @brief Sends a GET on a keep-alive connection and reads the response by its Content-Length
+ */
+static bool get(int fd, const char* method, const char* uri, const std::string& etag, response* result) {
+
+    char request[512];
+    snprintf(request, sizeof(request), "%s %s HTTP/1.1\r\nHost: sim\r\n%s%s%s\r\n", method, uri,
+             etag.empty() ? "" : "If-None-Match: ", etag.c_str(), etag.empty() ? "" : "\r\n");
+    send(fd, request, strlen(request), MSG_NOSIGNAL);
+
+    static std::string text;
+    text.clear();
+    char buffer[16 * 1024];
+    size_t end = std::string::npos;
+    size_t length = 0;
+    while (end == std::string::npos or text.size() < end + 4 + length) {
+        ssize_t part = recv(fd, buffer, sizeof(buffer), 0);
+        if (part <= 0) { return false; }
+        text.append(buffer, part);
+        if (end == std::string::npos and (end = text.find("\r\n\r\n")) != std::string::npos) {
+            length = strtoul(header(text.substr(0, end + 2), "Content-Length").c_str(), NULL, 10);
+        }
+    }
+    result->status = atoi(text.c_str() + 9);
+    result->head = text.substr(0, end + 2);
+    result->body = text.substr(end + 4, length);
+    return true;
+
+}
+
+
+static void write_file(const char* path, const std::string& content) {
+
+    File written = SPIFFS.open(path, FILE_WRITE);
+    written.write((const uint8_t*)content.data(), content.size());
+    written.close();
+
+}
+
+
+/**
+ * @brief Checks types, gz selection, ETags, 304 and that a POST drops the cache
+ *
+ * @return the number of checks that failed
+ */
+static int check(int port) {
+
+    int failures = 0;
+    int fd = connect_to(port);
+    for (asset& file : assets) {
+        response first, again;
+        bool right = get(fd, "GET", file.uri, "", &first) and first.status == 200 and first.body == file.content
+                     and header(first.head, "Content-Type") == file.type
+                     and (header(first.head, "Content-Encoding") == "gzip") == (strstr(file.file, ".gz") != NULL)
+                     and not header(first.head, "Last-Modified").empty();
+        file.etag = header(first.head, "ETag");
+        right = right and not file.etag.empty()
+                and get(fd, "GET", file.uri, file.etag, &again) and again.status == 304 and again.body.empty()
+                and header(again.head, "ETag") == file.etag
+                and get(fd, "GET", file.uri, "\"0-0\"", &again) and again.status == 200 and again.body == file.content;
+        if (not right) {
+            printf("%s: wrong response\n%s\n", file.uri, first.head.c_str());
+            failures++;
+        }
+    }
+
+    /* the same size, a POST leaves the cache alone, a DELETE makes the change seen */
+    asset& changed = assets[2];
+    changed.content[0] = changed.content[0] == 'x' ? 'y' : 'x';
+    /* the ETag holds the write time in seconds */
+    sleep(1);
+    write_file(changed.file, changed.content);
+    response before, after;
+    bool right = get(fd, "GET", changed.uri, changed.etag, &before) and before.status == 304
+                 and get(fd, "POST", "/touch", "", &after) and after.status == 200
+                 and get(fd, "GET", changed.uri, changed.etag, &before) and before.status == 304
+                 and get(fd, "DELETE", "/touch", "", &after) and after.status == 200
+                 and get(fd, "GET", changed.uri, changed.etag, &after) and after.status == 200
+                 and after.body == changed.content and header(after.head, "ETag") != changed.etag;
+    changed.etag = header(after.head, "ETag");
+    if (not right) {
+        printf("%s: change not seen\n%s\n", changed.uri, after.head.c_str());
+        failures++;
+    }
+    close(fd);
+    printf("checks: %zu assets, %d wrong\n", sizeof(assets) / sizeof(assets[0]), failures);
+    return failures;
+
+}
+
+
+static double measure(int port, bool conditional, double seconds) {
+
+    int fd = connect_to(port);
+    long requests = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    while (elapsed < seconds) {
+        asset& file = assets[requests % (sizeof(assets) / sizeof(assets[0]))];
+        response answer;
+        if (not get(fd, "GET", file.uri, conditional ? file.etag : "", &answer)
+            or answer.status != (conditional ? 304 : 200)) {
+            printf("%s: request %ld failed\n", file.uri, requests);
+            close(fd);
+            return 0;
+        }
+        requests++;
+        if (requests % 64 == 0) {
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+    close(fd);
+    return requests / elapsed;
+
+}
+
+
+int main(int argc, char** argv) {
+
+    double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+    int port = argc > 2 ? atoi(argv[2]) : 8185;
+    /* lwip has no signals, a write to a reset connection just fails */
+    signal(SIGPIPE, SIG_IGN);
+
+    char folder[] = "/tmp/webserver-static.XXXXXX";
+    if (not mkdtemp(folder)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    /* the file system keeps the base path, not a copy */
+    std::string base_path = std::string(folder) + "/spiffs";
+    if (not SPIFFS.begin(false, base_path.c_str())) {
+        printf("mounting %s failed\n", base_path.c_str());
+        return 1;
+    }
+    std::mt19937 random(7);
+    for (asset& file : assets) {
+        file.content.resize(file.size);
+        for (char& byte : file.content) { byte = 'a' + random() % 26; }
+        write_file(file.file, file.content);
+    }
+
+    WebServer server(port);
+    server.serveStatic("/", SPIFFS, "/", "max-age=600");
+    server.on("/touch", HTTP_ANY, [&server]() { server.send(200, "text/plain", "ok"); });
+    server.enableConcurrency();
+    server.begin();
+    std::atomic<bool> serving(true);
+    std::atomic<bool> cold(false);
+    std::thread thread([&server, &serving, &cold]() {
+        while (serving) {
+            if (cold) { server.invalidateStatic(); }
+            server.handleClient();
+        }
+    });
+
+    int failures = check(port);
+    printf("%-16s %12s %12s\n", "", "cold req/s", "warm req/s");
+    for (bool conditional : { false, true }) {
+        cold = true;
+        double cold_rate = measure(port, conditional, seconds);
+        cold = false;
+        double warm_rate = measure(port, conditional, seconds);
+        failures += not cold_rate or not warm_rate;
+        printf("%-16s %12.0f %12.0f\n", conditional ? "304 Not Modified" : "200 OK", cold_rate, warm_rate);
+    }
+
+    serving = false;
+    thread.join();
+    server.close();
+    for (asset& file : assets) { SPIFFS.remove(file.file); }
+    rmdir(base_path.c_str());
+    rmdir(folder);
+    return failures ? 1 : 0;
+
+}
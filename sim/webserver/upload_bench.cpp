@@ -0,0 +1,203 @@
+/* ahead of the socket headers, IPAddress.h declares its own INADDR_NONE */
+#include "WebServer.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+
+/*
+ * Uploads files of 100 KB to 8 MB as multipart forms over loopback and reports
+ * MB/s, with the upload handler checking every byte it gets. The payload is
+ * salted with CR LF and cut off delimiters. webserver_upload_bench_bytewise is
+ * the same program on the previous one byte at a time parser.
+ *   webserver_upload_bench [seconds per size] [port]
+ */
+
+static const char boundary[] = "----simFormBoundary7MA4YWxkTrZu0gW";
+static const char note_value[] = "line one\r\nline two";
+
+static std::string payload;
+
+/* what the upload handler saw of the last upload */
+static size_t received_bytes;
+static long chunks;
+static size_t largest_chunk;
+static long mismatches;
+
+
+static void make_payload(size_t size) {
+
+    std::mt19937 random(size);
+    payload.resize(size);
+    for (size_t i = 0; i < size; i++) {
+        payload[i] = (char)random();
+    }
+    /* line breaks and delimiters that stop short of the boundary */
+    std::string delimiter = std::string("\r\n--") + boundary;
+    for (size_t at = 997; at + delimiter.size() < size; at += 1811) {
+        size_t length = 1 + random() % (delimiter.size() - 1);
+        payload.replace(at, length, delimiter, 0, length);
+        /* a random byte could complete the boundary */
+        payload[at + length] = '\0';
+    }
+
+}
+
+
+static int connect_to(int port) {
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    struct timeval timeout = { 10, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+
+}
+
+
+static bool send_all(int fd, const std::string& text) {
+
+    size_t sent = 0;
+    while (sent < text.size()) {
+        ssize_t part = send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        if (part <= 0) { return false; }
+        sent += part;
+    }
+    return true;
+
+}
+
+
+/**
+ * @brief Posts the payload with a text field and returns the response body
+ */
+static std::string upload(int port) {
+
+    std::string body;
+    body += std::string("--") + boundary + "\r\n";
+    body += "Content-Disposition: form-data; name=\"note\"\r\n\r\n";
+    body += std::string(note_value) + "\r\n";
+    body += std::string("--") + boundary + "\r\n";
+    body += "Content-Disposition: form-data; name=\"asset\"; filename=\"asset.bin\"\r\n";
+    body += "Content-Type: application/octet-stream\r\n\r\n";
+    body += payload;
+    body += std::string("\r\n--") + boundary + "--\r\n";
+
+    char head[256];
+    snprintf(head, sizeof(head),
+             "POST /upload HTTP/1.1\r\nHost: sim\r\nConnection: close\r\n"
+             "Content-Type: multipart/form-data; boundary=%s\r\nContent-Length: %zu\r\n\r\n",
+             boundary, body.size());
+
+    int fd = connect_to(port);
+    if (fd < 0 or not send_all(fd, head) or not send_all(fd, body)) {
+        if (fd >= 0) { close(fd); }
+        return std::string();
+    }
+    std::string response;
+    char buffer[1024];
+    ssize_t part;
+    while ((part = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, part);
+    }
+    close(fd);
+    size_t end = response.find("\r\n\r\n");
+    return end == std::string::npos ? std::string() : response.substr(end + 4);
+
+}
+
+
+int main(int argc, char** argv) {
+
+    double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+    int port = argc > 2 ? atoi(argv[2]) : 8183;
+    static const size_t sizes[] = { 100 * 1024, 1024 * 1024, 8 * 1024 * 1024 };
+    /* lwip has no signals, a write to a reset connection just fails */
+    signal(SIGPIPE, SIG_IGN);
+
+    WebServer server(port);
+    server.on("/upload", HTTP_POST, [&server]() {
+        char result[160];
+        snprintf(result, sizeof(result), "%zu %ld %zu %ld %d", received_bytes, chunks, largest_chunk, mismatches,
+                 server.arg("note") == "line one\nline two");
+        server.send(200, "text/plain", result);
+    }, [&server]() {
+        HTTPUpload& file = server.upload();
+        if (file.status == UPLOAD_FILE_START) {
+            received_bytes = 0;
+            chunks = 0;
+            largest_chunk = 0;
+            mismatches = 0;
+        } else if (file.status == UPLOAD_FILE_WRITE and file.currentSize) {
+            size_t length = file.currentSize;
+            if (received_bytes + length > payload.size()
+                or memcmp(file.buf, payload.data() + received_bytes, length)) {
+                mismatches++;
+            }
+            received_bytes += length;
+            chunks++;
+            largest_chunk = length > largest_chunk ? length : largest_chunk;
+        }
+    });
+    server.begin();
+    std::atomic<bool> serving(true);
+    std::thread thread([&server, &serving]() {
+        while (serving) { server.handleClient(); }
+    });
+
+#ifdef WEBSERVER_BYTEWISE_UPLOAD
+    printf("byte at a time parser, HTTP_UPLOAD_BUFLEN %d\n", HTTP_UPLOAD_BUFLEN);
+#else
+    printf("block parser, HTTP_UPLOAD_BUFLEN %d\n", HTTP_UPLOAD_BUFLEN);
+#endif
+    printf("%9s %8s %10s %10s %10s  %s\n", "size", "uploads", "MB/s", "chunks", "largest", "check");
+    int failures = 0;
+    for (size_t size : sizes) {
+        make_payload(size);
+        char expected[64];
+        long uploads = 0;
+        bool intact = true;
+        std::string result;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0;
+        while (elapsed < seconds or uploads < 2) {
+            result = upload(port);
+            uploads++;
+            snprintf(expected, sizeof(expected), "%zu %ld", size, chunks);
+            intact = intact and result.compare(0, strlen(expected), expected) == 0
+                     and result.size() > 4 and result.compare(result.size() - 4, 4, " 0 1") == 0;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        failures += not intact;
+        printf("%6zu KB %8ld %10.2f %10ld %10zu  %s\n", size / 1024, uploads,
+               uploads * size / elapsed / (1024 * 1024), chunks, largest_chunk, intact ? "ok" : result.c_str());
+    }
+
+    serving = false;
+    thread.join();
+    server.close();
+    return failures ? 1 : 0;
+
+}
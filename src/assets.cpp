@@ -0,0 +1,292 @@
+/* generated by tools/embed_assets.py from assets/, do not edit */
+
+#include <string.h>
+
+#include "assets.h"
+
+
+/* live.js, 1335 bytes, 622 gzipped */
+static const uint8_t asset_0_gzip[811] = {
+    0x48, 0x54, 0x54, 0x50, 0x2f, 0x31, 0x2e, 0x31, 0x20, 0x32, 0x30, 0x30, 0x20, 0x4f, 0x4b, 0x0d,
+    0x0a, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x2d, 0x54, 0x79, 0x70, 0x65, 0x3a, 0x20, 0x61,
+    0x70, 0x70, 0x6c, 0x69, 0x63, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x2f, 0x6a, 0x61, 0x76, 0x61, 0x73,
+    0x63, 0x72, 0x69, 0x70, 0x74, 0x0d, 0x0a, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x2d, 0x45,
+    0x6e, 0x63, 0x6f, 0x64, 0x69, 0x6e, 0x67, 0x3a, 0x20, 0x67, 0x7a, 0x69, 0x70, 0x0d, 0x0a, 0x43,
+    0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x2d, 0x4c, 0x65, 0x6e, 0x67, 0x74, 0x68, 0x3a, 0x20, 0x36,
+    0x32, 0x32, 0x0d, 0x0a, 0x45, 0x54, 0x61, 0x67, 0x3a, 0x20, 0x22, 0x62, 0x30, 0x63, 0x34, 0x30,
+    0x65, 0x65, 0x34, 0x65, 0x32, 0x64, 0x61, 0x33, 0x30, 0x64, 0x30, 0x22, 0x0d, 0x0a, 0x43, 0x61,
+    0x63, 0x68, 0x65, 0x2d, 0x43, 0x6f, 0x6e, 0x74, 0x72, 0x6f, 0x6c, 0x3a, 0x20, 0x70, 0x75, 0x62,
+    0x6c, 0x69, 0x63, 0x2c, 0x20, 0x6d, 0x61, 0x78, 0x2d, 0x61, 0x67, 0x65, 0x3d, 0x38, 0x36, 0x34,
+    0x30, 0x30, 0x0d, 0x0a, 0x56, 0x61, 0x72, 0x79, 0x3a, 0x20, 0x41, 0x63, 0x63, 0x65, 0x70, 0x74,
+    0x2d, 0x45, 0x6e, 0x63, 0x6f, 0x64, 0x69, 0x6e, 0x67, 0x0d, 0x0a, 0x0d, 0x0a, 0x1f, 0x8b, 0x08,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x93, 0x51, 0x6f, 0xdb, 0x20, 0x14, 0x85, 0xdf,
+    0xfd, 0x2b, 0x28, 0x9a, 0x2a, 0xac, 0x74, 0xce, 0xba, 0xee, 0xa9, 0x69, 0x35, 0x55, 0x5d, 0x5f,
+    0xa6, 0xa9, 0x9d, 0x94, 0xbe, 0xa5, 0xd9, 0x44, 0xe0, 0x3a, 0x66, 0x75, 0xc0, 0x03, 0xdc, 0x2c,
+    0xca, 0xf2, 0xdf, 0x77, 0x2f, 0xce, 0x92, 0x78, 0x6a, 0x1e, 0xf6, 0x64, 0x0c, 0x97, 0xc3, 0x3d,
+    0x1f, 0x07, 0x51, 0xb6, 0x56, 0x45, 0xe3, 0x2c, 0x13, 0x39, 0x5b, 0x67, 0x2f, 0xd2, 0xb3, 0xda,
+    0xd8, 0xe7, 0xc0, 0xae, 0x99, 0x76, 0xaa, 0x5d, 0x80, 0x8d, 0xc5, 0xcf, 0x16, 0xfc, 0x6a, 0x0c,
+    0x35, 0xa8, 0xe8, 0xfc, 0x4d, 0x5d, 0x0b, 0x2e, 0x8b, 0x59, 0x1b, 0xa3, 0xb3, 0x3c, 0x1f, 0x65,
+    0x3b, 0x81, 0xd2, 0x40, 0xad, 0x05, 0xed, 0x26, 0x25, 0x0f, 0xb1, 0xf5, 0x96, 0x0d, 0xbf, 0x3d,
+    0x0d, 0x45, 0x68, 0x00, 0xf4, 0x6f, 0x69, 0xcd, 0x42, 0x52, 0x65, 0xfe, 0x5d, 0x3c, 0x2d, 0x07,
+    0xf9, 0x9b, 0x61, 0x01, 0xbf, 0x40, 0xa5, 0x1d, 0xc5, 0x1c, 0xe2, 0x4d, 0x8c, 0xde, 0xa0, 0x2e,
+    0x08, 0x5e, 0x79, 0x28, 0x79, 0x8e, 0xe2, 0x9b, 0xcc, 0x94, 0x4c, 0x2c, 0x8d, 0xd5, 0x6e, 0x59,
+    0x94, 0x10, 0x55, 0x45, 0xda, 0xbb, 0xce, 0xa4, 0xd6, 0x77, 0x2f, 0x38, 0xf8, 0x62, 0x42, 0x04,
+    0x0b, 0x5e, 0x70, 0x55, 0x1b, 0xf5, 0xcc, 0xcf, 0xd8, 0xde, 0x16, 0x50, 0xc1, 0xa1, 0x37, 0xb4,
+    0x96, 0xe6, 0x8a, 0x28, 0x3d, 0x1e, 0x5b, 0xa8, 0xda, 0x05, 0x08, 0xb1, 0xef, 0x8a, 0x8a, 0xb1,
+    0x5b, 0x55, 0x61, 0x75, 0xda, 0x74, 0x7a, 0x7a, 0x68, 0x70, 0x94, 0xfa, 0x3a, 0x49, 0x15, 0x7b,
+    0xb7, 0xd4, 0x6f, 0x27, 0xdd, 0xf8, 0xf4, 0xfd, 0x04, 0xa5, 0x6c, 0xeb, 0x28, 0xb6, 0x82, 0x6d,
+    0xa3, 0x65, 0x04, 0x54, 0x5c, 0x6f, 0x46, 0x59, 0xf7, 0x33, 0x49, 0x12, 0x93, 0xf3, 0xe9, 0x14,
+    0xa7, 0xbb, 0xf1, 0xfb, 0x29, 0x42, 0x25, 0xab, 0x82, 0x0f, 0x95, 0xb3, 0xd1, 0xbb, 0x1a, 0x0d,
+    0xad, 0xb3, 0x05, 0xc4, 0xca, 0xe9, 0x4b, 0xc6, 0xbf, 0x3e, 0x8c, 0x1f, 0xf9, 0x59, 0x56, 0x81,
+    0xd4, 0xe0, 0xc3, 0x25, 0x5b, 0x33, 0x7e, 0x8b, 0x75, 0x78, 0xde, 0xdb, 0xc7, 0x55, 0x03, 0x1c,
+    0x4b, 0x64, 0xd3, 0x20, 0x88, 0x44, 0x7b, 0xf8, 0x23, 0xa0, 0x25, 0xb6, 0x39, 0xcb, 0x66, 0x4e,
+    0xaf, 0x2e, 0xd9, 0xe7, 0xf1, 0xc3, 0x7d, 0x11, 0x10, 0xb5, 0x9d, 0x9b, 0x72, 0x25, 0xba, 0x36,
+    0xf2, 0x6c, 0x43, 0xb4, 0x77, 0xc4, 0x4f, 0xb6, 0xc8, 0x13, 0xdd, 0xb1, 0x6b, 0xbd, 0x82, 0xbe,
+    0xcd, 0x04, 0x13, 0x74, 0x2f, 0x27, 0xca, 0x03, 0x4a, 0xdd, 0xd5, 0x40, 0x7f, 0x82, 0x6b, 0xf3,
+    0x42, 0x24, 0xa9, 0x0a, 0x19, 0xcb, 0x10, 0xee, 0xe5, 0x82, 0xcc, 0x73, 0x9a, 0xe1, 0xe8, 0xd1,
+    0x79, 0x26, 0x48, 0xc7, 0xe0, 0xe4, 0xbb, 0x11, 0x7e, 0xae, 0xd8, 0x07, 0xfc, 0x0c, 0x06, 0x74,
+    0x54, 0xda, 0x86, 0x36, 0xc0, 0xea, 0xdb, 0xca, 0x20, 0xf7, 0x63, 0xc7, 0x84, 0x46, 0xda, 0x6d,
+    0x56, 0x5e, 0x4f, 0xac, 0xe0, 0x85, 0xea, 0xf0, 0xf0, 0xbc, 0xa7, 0x48, 0x47, 0x6c, 0x6f, 0x26,
+    0xdd, 0x16, 0x99, 0xb1, 0xb0, 0x64, 0x07, 0xa6, 0xf1, 0x0a, 0xba, 0x25, 0x72, 0xd2, 0x8d, 0x5e,
+    0x09, 0x5d, 0x88, 0xd8, 0xd0, 0xf1, 0xd0, 0xa5, 0x65, 0xd4, 0x4e, 0xe4, 0x1b, 0xe9, 0x03, 0x74,
+    0xeb, 0x05, 0x92, 0x97, 0xf9, 0xeb, 0x20, 0xd2, 0x23, 0x2c, 0x6a, 0xb0, 0xf3, 0x58, 0xed, 0x98,
+    0x1c, 0x86, 0x72, 0x1f, 0xc6, 0x30, 0x31, 0xd3, 0x6d, 0x20, 0x77, 0x79, 0xfc, 0x3b, 0xdf, 0x07,
+    0xdf, 0xc5, 0x9b, 0x71, 0x36, 0x60, 0x22, 0x35, 0x75, 0x98, 0xbe, 0xeb, 0x7d, 0xfe, 0xd8, 0x47,
+    0xc6, 0x29, 0x33, 0x18, 0x24, 0x57, 0x96, 0x3c, 0xb1, 0xdd, 0xa4, 0x74, 0x1c, 0x45, 0x50, 0x7a,
+    0x3c, 0xe3, 0x38, 0x82, 0xb4, 0xfc, 0x9f, 0x08, 0x2e, 0xfa, 0x59, 0x50, 0x74, 0x67, 0x1e, 0xec,
+    0xbf, 0xae, 0x44, 0xd2, 0x2e, 0x66, 0x28, 0xca, 0x4e, 0x99, 0x38, 0x67, 0x57, 0x57, 0xcc, 0xe4,
+    0x39, 0x79, 0xa8, 0x4d, 0x4c, 0x26, 0x38, 0x19, 0xe8, 0x8b, 0x5c, 0xf4, 0x45, 0x3a, 0x0d, 0x3f,
+    0x9f, 0x25, 0x0e, 0xdc, 0x3a, 0x0b, 0x9c, 0x14, 0x68, 0xfb, 0x6e, 0x6d, 0xfb, 0x40, 0x72, 0x7c,
+    0xce, 0x7f, 0x00, 0x0e, 0x88, 0xdd, 0x93, 0x37, 0x05, 0x00, 0x00,
+};
+static const uint8_t asset_0_identity[1501] = {
+    0x48, 0x54, 0x54, 0x50, 0x2f, 0x31, 0x2e, 0x31, 0x20, 0x32, 0x30, 0x30, 0x20, 0x4f, 0x4b, 0x0d,
+    0x0a, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x2d, 0x54, 0x79, 0x70, 0x65, 0x3a, 0x20, 0x61,
+    0x70, 0x70, 0x6c, 0x69, 0x63, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x2f, 0x6a, 0x61, 0x76, 0x61, 0x73,
+    0x63, 0x72, 0x69, 0x70, 0x74, 0x0d, 0x0a, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x2d, 0x4c,
+    0x65, 0x6e, 0x67, 0x74, 0x68, 0x3a, 0x20, 0x31, 0x33, 0x33, 0x35, 0x0d, 0x0a, 0x45, 0x54, 0x61,
+    0x67, 0x3a, 0x20, 0x22, 0x62, 0x30, 0x63, 0x34, 0x30, 0x65, 0x65, 0x34, 0x65, 0x32, 0x64, 0x61,
+    0x33, 0x30, 0x64, 0x30, 0x22, 0x0d, 0x0a, 0x43, 0x61, 0x63, 0x68, 0x65, 0x2d, 0x43, 0x6f, 0x6e,
+    0x74, 0x72, 0x6f, 0x6c, 0x3a, 0x20, 0x70, 0x75, 0x62, 0x6c, 0x69, 0x63, 0x2c, 0x20, 0x6d, 0x61,
+    0x78, 0x2d, 0x61, 0x67, 0x65, 0x3d, 0x38, 0x36, 0x34, 0x30, 0x30, 0x0d, 0x0a, 0x56, 0x61, 0x72,
+    0x79, 0x3a, 0x20, 0x41, 0x63, 0x63, 0x65, 0x70, 0x74, 0x2d, 0x45, 0x6e, 0x63, 0x6f, 0x64, 0x69,
+    0x6e, 0x67, 0x0d, 0x0a, 0x0d, 0x0a, 0x28, 0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x20,
+    0x28, 0x29, 0x20, 0x7b, 0x0a, 0x76, 0x61, 0x72, 0x20, 0x6c, 0x69, 0x6e, 0x6b, 0x73, 0x20, 0x3d,
+    0x20, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x71, 0x75, 0x65, 0x72, 0x79, 0x53,
+    0x65, 0x6c, 0x65, 0x63, 0x74, 0x6f, 0x72, 0x41, 0x6c, 0x6c, 0x28, 0x22, 0x61, 0x2e, 0x62, 0x75,
+    0x74, 0x74, 0x6f, 0x6e, 0x22, 0x29, 0x3b, 0x0a, 0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e,
+    0x20, 0x66, 0x69, 0x65, 0x6c, 0x64, 0x28, 0x6c, 0x69, 0x6e, 0x6b, 0x29, 0x20, 0x7b, 0x0a, 0x72,
+    0x65, 0x74, 0x75, 0x72, 0x6e, 0x20, 0x2f, 0x5e, 0x5c, 0x2f, 0x28, 0x73, 0x70, 0x65, 0x65, 0x64,
+    0x7c, 0x61, 0x6e, 0x69, 0x6d, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x29, 0x5f, 0x28, 0x5c, 0x77, 0x2b,
+    0x29, 0x24, 0x2f, 0x2e, 0x65, 0x78, 0x65, 0x63, 0x28, 0x6c, 0x69, 0x6e, 0x6b, 0x2e, 0x67, 0x65,
+    0x74, 0x41, 0x74, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x65, 0x28, 0x22, 0x68, 0x72, 0x65, 0x66,
+    0x22, 0x29, 0x29, 0x3b, 0x0a, 0x7d, 0x0a, 0x69, 0x66, 0x20, 0x28, 0x77, 0x69, 0x6e, 0x64, 0x6f,
+    0x77, 0x2e, 0x66, 0x65, 0x74, 0x63, 0x68, 0x29, 0x20, 0x7b, 0x0a, 0x64, 0x6f, 0x63, 0x75, 0x6d,
+    0x65, 0x6e, 0x74, 0x2e, 0x61, 0x64, 0x64, 0x45, 0x76, 0x65, 0x6e, 0x74, 0x4c, 0x69, 0x73, 0x74,
+    0x65, 0x6e, 0x65, 0x72, 0x28, 0x22, 0x63, 0x6c, 0x69, 0x63, 0x6b, 0x22, 0x2c, 0x20, 0x66, 0x75,
+    0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x28, 0x65, 0x76, 0x65, 0x6e, 0x74, 0x29, 0x20, 0x7b,
+    0x0a, 0x76, 0x61, 0x72, 0x20, 0x6c, 0x69, 0x6e, 0x6b, 0x20, 0x3d, 0x20, 0x65, 0x76, 0x65, 0x6e,
+    0x74, 0x2e, 0x74, 0x61, 0x72, 0x67, 0x65, 0x74, 0x2e, 0x63, 0x6c, 0x6f, 0x73, 0x65, 0x73, 0x74,
+    0x28, 0x22, 0x61, 0x2e, 0x62, 0x75, 0x74, 0x74, 0x6f, 0x6e, 0x22, 0x29, 0x3b, 0x0a, 0x76, 0x61,
+    0x72, 0x20, 0x6d, 0x61, 0x74, 0x63, 0x68, 0x20, 0x3d, 0x20, 0x6c, 0x69, 0x6e, 0x6b, 0x20, 0x26,
+    0x26, 0x20, 0x66, 0x69, 0x65, 0x6c, 0x64, 0x28, 0x6c, 0x69, 0x6e, 0x6b, 0x29, 0x3b, 0x0a, 0x69,
+    0x66, 0x20, 0x28, 0x21, 0x6d, 0x61, 0x74, 0x63, 0x68, 0x29, 0x20, 0x7b, 0x0a, 0x72, 0x65, 0x74,
+    0x75, 0x72, 0x6e, 0x3b, 0x0a, 0x7d, 0x0a, 0x65, 0x76, 0x65, 0x6e, 0x74, 0x2e, 0x70, 0x72, 0x65,
+    0x76, 0x65, 0x6e, 0x74, 0x44, 0x65, 0x66, 0x61, 0x75, 0x6c, 0x74, 0x28, 0x29, 0x3b, 0x0a, 0x76,
+    0x61, 0x72, 0x20, 0x75, 0x70, 0x64, 0x61, 0x74, 0x65, 0x20, 0x3d, 0x20, 0x7b, 0x7d, 0x3b, 0x0a,
+    0x75, 0x70, 0x64, 0x61, 0x74, 0x65, 0x5b, 0x6d, 0x61, 0x74, 0x63, 0x68, 0x5b, 0x31, 0x5d, 0x5d,
+    0x20, 0x3d, 0x20, 0x6d, 0x61, 0x74, 0x63, 0x68, 0x5b, 0x32, 0x5d, 0x3b, 0x0a, 0x66, 0x65, 0x74,
+    0x63, 0x68, 0x28, 0x22, 0x2f, 0x63, 0x6f, 0x6e, 0x74, 0x72, 0x6f, 0x6c, 0x22, 0x2c, 0x20, 0x7b,
+    0x0a, 0x6d, 0x65, 0x74, 0x68, 0x6f, 0x64, 0x3a, 0x20, 0x22, 0x50, 0x4f, 0x53, 0x54, 0x22, 0x2c,
+    0x0a, 0x68, 0x65, 0x61, 0x64, 0x65, 0x72, 0x73, 0x3a, 0x20, 0x7b, 0x20, 0x22, 0x43, 0x6f, 0x6e,
+    0x74, 0x65, 0x6e, 0x74, 0x2d, 0x54, 0x79, 0x70, 0x65, 0x22, 0x3a, 0x20, 0x22, 0x61, 0x70, 0x70,
+    0x6c, 0x69, 0x63, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x2f, 0x6a, 0x73, 0x6f, 0x6e, 0x22, 0x20, 0x7d,
+    0x2c, 0x0a, 0x62, 0x6f, 0x64, 0x79, 0x3a, 0x20, 0x4a, 0x53, 0x4f, 0x4e, 0x2e, 0x73, 0x74, 0x72,
+    0x69, 0x6e, 0x67, 0x69, 0x66, 0x79, 0x28, 0x75, 0x70, 0x64, 0x61, 0x74, 0x65, 0x29, 0x0a, 0x7d,
+    0x29, 0x3b, 0x0a, 0x7d, 0x29, 0x3b, 0x0a, 0x7d, 0x0a, 0x69, 0x66, 0x20, 0x28, 0x21, 0x77, 0x69,
+    0x6e, 0x64, 0x6f, 0x77, 0x2e, 0x45, 0x76, 0x65, 0x6e, 0x74, 0x53, 0x6f, 0x75, 0x72, 0x63, 0x65,
+    0x29, 0x20, 0x7b, 0x0a, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6e, 0x3b, 0x0a, 0x7d, 0x0a, 0x76, 0x61,
+    0x72, 0x20, 0x6c, 0x65, 0x64, 0x73, 0x20, 0x3d, 0x20, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e,
+    0x74, 0x2e, 0x63, 0x72, 0x65, 0x61, 0x74, 0x65, 0x45, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x28,
+    0x22, 0x64, 0x69, 0x76, 0x22, 0x29, 0x3b, 0x0a, 0x6c, 0x65, 0x64, 0x73, 0x2e, 0x63, 0x6c, 0x61,
+    0x73, 0x73, 0x4e, 0x61, 0x6d, 0x65, 0x20, 0x3d, 0x20, 0x22, 0x6c, 0x65, 0x64, 0x73, 0x22, 0x3b,
+    0x0a, 0x66, 0x6f, 0x72, 0x20, 0x28, 0x76, 0x61, 0x72, 0x20, 0x69, 0x20, 0x3d, 0x20, 0x30, 0x3b,
+    0x20, 0x69, 0x20, 0x3c, 0x20, 0x34, 0x3b, 0x20, 0x69, 0x2b, 0x2b, 0x29, 0x20, 0x7b, 0x0a, 0x6c,
+    0x65, 0x64, 0x73, 0x2e, 0x61, 0x70, 0x70, 0x65, 0x6e, 0x64, 0x43, 0x68, 0x69, 0x6c, 0x64, 0x28,
+    0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x63, 0x72, 0x65, 0x61, 0x74, 0x65, 0x45,
+    0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x28, 0x22, 0x73, 0x70, 0x61, 0x6e, 0x22, 0x29, 0x29, 0x3b,
+    0x0a, 0x7d, 0x0a, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x71, 0x75, 0x65, 0x72,
+    0x79, 0x53, 0x65, 0x6c, 0x65, 0x63, 0x74, 0x6f, 0x72, 0x28, 0x22, 0x2e, 0x63, 0x6f, 0x6e, 0x74,
+    0x65, 0x6e, 0x74, 0x22, 0x29, 0x2e, 0x61, 0x70, 0x70, 0x65, 0x6e, 0x64, 0x43, 0x68, 0x69, 0x6c,
+    0x64, 0x28, 0x6c, 0x65, 0x64, 0x73, 0x29, 0x3b, 0x0a, 0x76, 0x61, 0x72, 0x20, 0x65, 0x76, 0x65,
+    0x6e, 0x74, 0x73, 0x20, 0x3d, 0x20, 0x6e, 0x65, 0x77, 0x20, 0x45, 0x76, 0x65, 0x6e, 0x74, 0x53,
+    0x6f, 0x75, 0x72, 0x63, 0x65, 0x28, 0x22, 0x2f, 0x65, 0x76, 0x65, 0x6e, 0x74, 0x73, 0x22, 0x29,
+    0x3b, 0x0a, 0x65, 0x76, 0x65, 0x6e, 0x74, 0x73, 0x2e, 0x61, 0x64, 0x64, 0x45, 0x76, 0x65, 0x6e,
+    0x74, 0x4c, 0x69, 0x73, 0x74, 0x65, 0x6e, 0x65, 0x72, 0x28, 0x22, 0x73, 0x74, 0x61, 0x74, 0x65,
+    0x22, 0x2c, 0x20, 0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x28, 0x65, 0x76, 0x65,
+    0x6e, 0x74, 0x29, 0x20, 0x7b, 0x0a, 0x76, 0x61, 0x72, 0x20, 0x73, 0x74, 0x61, 0x74, 0x65, 0x20,
+    0x3d, 0x20, 0x4a, 0x53, 0x4f, 0x4e, 0x2e, 0x70, 0x61, 0x72, 0x73, 0x65, 0x28, 0x65, 0x76, 0x65,
+    0x6e, 0x74, 0x2e, 0x64, 0x61, 0x74, 0x61, 0x29, 0x3b, 0x0a, 0x66, 0x6f, 0x72, 0x20, 0x28, 0x76,
+    0x61, 0x72, 0x20, 0x69, 0x20, 0x3d, 0x20, 0x30, 0x3b, 0x20, 0x69, 0x20, 0x3c, 0x20, 0x6c, 0x69,
+    0x6e, 0x6b, 0x73, 0x2e, 0x6c, 0x65, 0x6e, 0x67, 0x74, 0x68, 0x3b, 0x20, 0x69, 0x2b, 0x2b, 0x29,
+    0x20, 0x7b, 0x0a, 0x76, 0x61, 0x72, 0x20, 0x6d, 0x61, 0x74, 0x63, 0x68, 0x20, 0x3d, 0x20, 0x66,
+    0x69, 0x65, 0x6c, 0x64, 0x28, 0x6c, 0x69, 0x6e, 0x6b, 0x73, 0x5b, 0x69, 0x5d, 0x29, 0x3b, 0x0a,
+    0x69, 0x66, 0x20, 0x28, 0x6d, 0x61, 0x74, 0x63, 0x68, 0x29, 0x20, 0x7b, 0x0a, 0x6c, 0x69, 0x6e,
+    0x6b, 0x73, 0x5b, 0x69, 0x5d, 0x2e, 0x63, 0x6c, 0x61, 0x73, 0x73, 0x4e, 0x61, 0x6d, 0x65, 0x20,
+    0x3d, 0x20, 0x22, 0x62, 0x75, 0x74, 0x74, 0x6f, 0x6e, 0x20, 0x22, 0x20, 0x2b, 0x20, 0x28, 0x73,
+    0x74, 0x61, 0x74, 0x65, 0x5b, 0x6d, 0x61, 0x74, 0x63, 0x68, 0x5b, 0x31, 0x5d, 0x5d, 0x20, 0x3d,
+    0x3d, 0x3d, 0x20, 0x6d, 0x61, 0x74, 0x63, 0x68, 0x5b, 0x32, 0x5d, 0x20, 0x3f, 0x20, 0x22, 0x6f,
+    0x6e, 0x22, 0x20, 0x3a, 0x20, 0x22, 0x6f, 0x66, 0x66, 0x22, 0x29, 0x3b, 0x0a, 0x7d, 0x0a, 0x7d,
+    0x0a, 0x7d, 0x29, 0x3b, 0x0a, 0x65, 0x76, 0x65, 0x6e, 0x74, 0x73, 0x2e, 0x61, 0x64, 0x64, 0x45,
+    0x76, 0x65, 0x6e, 0x74, 0x4c, 0x69, 0x73, 0x74, 0x65, 0x6e, 0x65, 0x72, 0x28, 0x22, 0x66, 0x72,
+    0x61, 0x6d, 0x65, 0x22, 0x2c, 0x20, 0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x28,
+    0x65, 0x76, 0x65, 0x6e, 0x74, 0x29, 0x20, 0x7b, 0x0a, 0x76, 0x61, 0x72, 0x20, 0x66, 0x72, 0x61,
+    0x6d, 0x65, 0x20, 0x3d, 0x20, 0x4a, 0x53, 0x4f, 0x4e, 0x2e, 0x70, 0x61, 0x72, 0x73, 0x65, 0x28,
+    0x65, 0x76, 0x65, 0x6e, 0x74, 0x2e, 0x64, 0x61, 0x74, 0x61, 0x29, 0x3b, 0x0a, 0x66, 0x6f, 0x72,
+    0x20, 0x28, 0x76, 0x61, 0x72, 0x20, 0x69, 0x20, 0x3d, 0x20, 0x30, 0x3b, 0x20, 0x69, 0x20, 0x3c,
+    0x20, 0x33, 0x3b, 0x20, 0x69, 0x2b, 0x2b, 0x29, 0x20, 0x7b, 0x0a, 0x6c, 0x65, 0x64, 0x73, 0x2e,
+    0x63, 0x68, 0x69, 0x6c, 0x64, 0x72, 0x65, 0x6e, 0x5b, 0x69, 0x5d, 0x2e, 0x63, 0x6c, 0x61, 0x73,
+    0x73, 0x4e, 0x61, 0x6d, 0x65, 0x20, 0x3d, 0x20, 0x28, 0x66, 0x72, 0x61, 0x6d, 0x65, 0x2e, 0x62,
+    0x61, 0x72, 0x73, 0x20, 0x26, 0x20, 0x28, 0x31, 0x20, 0x3c, 0x3c, 0x20, 0x69, 0x29, 0x29, 0x20,
+    0x3f, 0x20, 0x22, 0x6c, 0x69, 0x74, 0x22, 0x20, 0x3a, 0x20, 0x22, 0x22, 0x3b, 0x0a, 0x7d, 0x0a,
+    0x6c, 0x65, 0x64, 0x73, 0x2e, 0x63, 0x68, 0x69, 0x6c, 0x64, 0x72, 0x65, 0x6e, 0x5b, 0x33, 0x5d,
+    0x2e, 0x63, 0x6c, 0x61, 0x73, 0x73, 0x4e, 0x61, 0x6d, 0x65, 0x20, 0x3d, 0x20, 0x66, 0x72, 0x61,
+    0x6d, 0x65, 0x2e, 0x72, 0x67, 0x62, 0x20, 0x3d, 0x3d, 0x3d, 0x20, 0x22, 0x6e, 0x6f, 0x6e, 0x65,
+    0x22, 0x20, 0x3f, 0x20, 0x22, 0x22, 0x20, 0x3a, 0x20, 0x66, 0x72, 0x61, 0x6d, 0x65, 0x2e, 0x72,
+    0x67, 0x62, 0x3b, 0x0a, 0x7d, 0x29, 0x3b, 0x0a, 0x7d, 0x29, 0x28, 0x29, 0x3b,
+};
+static const uint8_t asset_0_not_modified[116] = {
+    0x48, 0x54, 0x54, 0x50, 0x2f, 0x31, 0x2e, 0x31, 0x20, 0x33, 0x30, 0x34, 0x20, 0x4e, 0x6f, 0x74,
+    0x20, 0x4d, 0x6f, 0x64, 0x69, 0x66, 0x69, 0x65, 0x64, 0x0d, 0x0a, 0x45, 0x54, 0x61, 0x67, 0x3a,
+    0x20, 0x22, 0x62, 0x30, 0x63, 0x34, 0x30, 0x65, 0x65, 0x34, 0x65, 0x32, 0x64, 0x61, 0x33, 0x30,
+    0x64, 0x30, 0x22, 0x0d, 0x0a, 0x43, 0x61, 0x63, 0x68, 0x65, 0x2d, 0x43, 0x6f, 0x6e, 0x74, 0x72,
+    0x6f, 0x6c, 0x3a, 0x20, 0x70, 0x75, 0x62, 0x6c, 0x69, 0x63, 0x2c, 0x20, 0x6d, 0x61, 0x78, 0x2d,
+    0x61, 0x67, 0x65, 0x3d, 0x38, 0x36, 0x34, 0x30, 0x30, 0x0d, 0x0a, 0x56, 0x61, 0x72, 0x79, 0x3a,
+    0x20, 0x41, 0x63, 0x63, 0x65, 0x70, 0x74, 0x2d, 0x45, 0x6e, 0x63, 0x6f, 0x64, 0x69, 0x6e, 0x67,
+    0x0d, 0x0a, 0x0d, 0x0a,
+};
+
+/* style.css, 664 bytes, 331 gzipped */
+static const uint8_t asset_1_gzip[506] = {
+    0x48, 0x54, 0x54, 0x50, 0x2f, 0x31, 0x2e, 0x31, 0x20, 0x32, 0x30, 0x30, 0x20, 0x4f, 0x4b, 0x0d,
+    0x0a, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x2d, 0x54, 0x79, 0x70, 0x65, 0x3a, 0x20, 0x74,
+    0x65, 0x78, 0x74, 0x2f, 0x63, 0x73, 0x73, 0x0d, 0x0a, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74,
+    0x2d, 0x45, 0x6e, 0x63, 0x6f, 0x64, 0x69, 0x6e, 0x67, 0x3a, 0x20, 0x67, 0x7a, 0x69, 0x70, 0x0d,
+    0x0a, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x2d, 0x4c, 0x65, 0x6e, 0x67, 0x74, 0x68, 0x3a,
+    0x20, 0x33, 0x33, 0x31, 0x0d, 0x0a, 0x45, 0x54, 0x61, 0x67, 0x3a, 0x20, 0x22, 0x66, 0x39, 0x64,
+    0x62, 0x39, 0x66, 0x62, 0x38, 0x38, 0x35, 0x62, 0x62, 0x33, 0x61, 0x63, 0x37, 0x22, 0x0d, 0x0a,
+    0x43, 0x61, 0x63, 0x68, 0x65, 0x2d, 0x43, 0x6f, 0x6e, 0x74, 0x72, 0x6f, 0x6c, 0x3a, 0x20, 0x70,
+    0x75, 0x62, 0x6c, 0x69, 0x63, 0x2c, 0x20, 0x6d, 0x61, 0x78, 0x2d, 0x61, 0x67, 0x65, 0x3d, 0x38,
+    0x36, 0x34, 0x30, 0x30, 0x0d, 0x0a, 0x56, 0x61, 0x72, 0x79, 0x3a, 0x20, 0x41, 0x63, 0x63, 0x65,
+    0x70, 0x74, 0x2d, 0x45, 0x6e, 0x63, 0x6f, 0x64, 0x69, 0x6e, 0x67, 0x0d, 0x0a, 0x0d, 0x0a, 0x1f,
+    0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x75, 0x91, 0x5d, 0x6e, 0x83, 0x30, 0x10,
+    0x84, 0xaf, 0x82, 0x54, 0xf5, 0x91, 0x88, 0x84, 0x44, 0x6d, 0xcd, 0x05, 0x72, 0x0d, 0xff, 0x2c,
+    0xd8, 0x8a, 0xf1, 0x22, 0xb3, 0x84, 0xa4, 0x28, 0x77, 0xaf, 0xc1, 0x71, 0xd2, 0x96, 0xf6, 0x81,
+    0x87, 0x9d, 0x19, 0xdb, 0xdf, 0x2c, 0x9a, 0x5a, 0x3b, 0xd5, 0xe8, 0x28, 0xaf, 0x79, 0x6b, 0xec,
+    0x95, 0x1d, 0xc1, 0x9e, 0x81, 0x8c, 0xe4, 0x55, 0xcb, 0x7d, 0x63, 0x1c, 0x2b, 0xba, 0x4b, 0x16,
+    0xbe, 0x6a, 0x34, 0x8a, 0x34, 0xdb, 0x16, 0xc5, 0x79, 0xac, 0x34, 0x98, 0x46, 0xd3, 0x32, 0xe8,
+    0x0a, 0xcf, 0xe0, 0x6b, 0x8b, 0x23, 0xe3, 0x03, 0xe1, 0x4d, 0xa0, 0xba, 0x4e, 0xf1, 0x68, 0x4e,
+    0xd8, 0xb1, 0x43, 0x38, 0x7b, 0xd3, 0xbb, 0xbb, 0xb4, 0x8c, 0xd9, 0x1c, 0xcc, 0xca, 0xc5, 0xd8,
+    0xa7, 0xac, 0x40, 0x22, 0x6c, 0x63, 0xbc, 0x8b, 0x44, 0xbd, 0xf9, 0x04, 0xb6, 0xdd, 0x07, 0x61,
+    0x23, 0x86, 0xe0, 0xba, 0x7e, 0x52, 0xa6, 0xef, 0x2c, 0xbf, 0xb2, 0xda, 0x42, 0x22, 0x7a, 0x0b,
+    0x0c, 0x29, 0xf0, 0xf0, 0x85, 0x45, 0x79, 0x7a, 0x04, 0x02, 0xbd, 0x40, 0xaf, 0xc0, 0x33, 0x87,
+    0x0e, 0x2a, 0x89, 0x16, 0x3d, 0x1b, 0xb5, 0x21, 0xa8, 0x3a, 0xae, 0x94, 0x71, 0x4d, 0xa8, 0x12,
+    0xb8, 0x76, 0x73, 0x92, 0xe0, 0x42, 0xb9, 0x02, 0x89, 0x9e, 0x93, 0x41, 0x17, 0x8f, 0x3c, 0x79,
+    0x96, 0xcc, 0xb7, 0xd5, 0xcc, 0x73, 0x56, 0x1e, 0x82, 0x28, 0x07, 0xdf, 0x87, 0x7b, 0x3b, 0x34,
+    0x8e, 0xc0, 0xdf, 0x5f, 0xcc, 0x3d, 0x57, 0x66, 0xe8, 0xd9, 0xd2, 0x02, 0xeb, 0x7a, 0x12, 0x5c,
+    0x9e, 0x1a, 0x8f, 0x83, 0x53, 0x79, 0xe4, 0x78, 0x29, 0xf7, 0x1f, 0xef, 0x4a, 0x04, 0xd7, 0xad,
+    0x4d, 0x61, 0x07, 0xb8, 0x6d, 0x2c, 0xa8, 0x9f, 0xd5, 0xa3, 0x94, 0xf5, 0x1d, 0x77, 0x53, 0x2c,
+    0x39, 0x6f, 0x33, 0xfd, 0x96, 0xf2, 0x17, 0xe2, 0xf6, 0xb9, 0x80, 0x84, 0x73, 0x28, 0x5e, 0xab,
+    0x35, 0x89, 0x94, 0xf2, 0x7e, 0xf3, 0xc6, 0x1a, 0x5a, 0xd3, 0x34, 0x68, 0x55, 0x0a, 0x78, 0x50,
+    0xeb, 0x40, 0x10, 0x93, 0xdf, 0x78, 0x80, 0x3f, 0x0a, 0x2d, 0x72, 0xca, 0xcc, 0xed, 0xfe, 0xe9,
+    0xfc, 0x05, 0xf5, 0x76, 0xa8, 0xb1, 0x98, 0x02, 0x00, 0x00,
+};
+static const uint8_t asset_1_identity[815] = {
+    0x48, 0x54, 0x54, 0x50, 0x2f, 0x31, 0x2e, 0x31, 0x20, 0x32, 0x30, 0x30, 0x20, 0x4f, 0x4b, 0x0d,
+    0x0a, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x2d, 0x54, 0x79, 0x70, 0x65, 0x3a, 0x20, 0x74,
+    0x65, 0x78, 0x74, 0x2f, 0x63, 0x73, 0x73, 0x0d, 0x0a, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74,
+    0x2d, 0x4c, 0x65, 0x6e, 0x67, 0x74, 0x68, 0x3a, 0x20, 0x36, 0x36, 0x34, 0x0d, 0x0a, 0x45, 0x54,
+    0x61, 0x67, 0x3a, 0x20, 0x22, 0x66, 0x39, 0x64, 0x62, 0x39, 0x66, 0x62, 0x38, 0x38, 0x35, 0x62,
+    0x62, 0x33, 0x61, 0x63, 0x37, 0x22, 0x0d, 0x0a, 0x43, 0x61, 0x63, 0x68, 0x65, 0x2d, 0x43, 0x6f,
+    0x6e, 0x74, 0x72, 0x6f, 0x6c, 0x3a, 0x20, 0x70, 0x75, 0x62, 0x6c, 0x69, 0x63, 0x2c, 0x20, 0x6d,
+    0x61, 0x78, 0x2d, 0x61, 0x67, 0x65, 0x3d, 0x38, 0x36, 0x34, 0x30, 0x30, 0x0d, 0x0a, 0x56, 0x61,
+    0x72, 0x79, 0x3a, 0x20, 0x41, 0x63, 0x63, 0x65, 0x70, 0x74, 0x2d, 0x45, 0x6e, 0x63, 0x6f, 0x64,
+    0x69, 0x6e, 0x67, 0x0d, 0x0a, 0x0d, 0x0a, 0x68, 0x74, 0x6d, 0x6c, 0x7b, 0x66, 0x6f, 0x6e, 0x74,
+    0x2d, 0x66, 0x61, 0x6d, 0x69, 0x6c, 0x79, 0x3a, 0x48, 0x65, 0x6c, 0x76, 0x65, 0x74, 0x69, 0x63,
+    0x61, 0x3b, 0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x3a, 0x30, 0x70, 0x78, 0x20, 0x30, 0x70, 0x78,
+    0x3b, 0x77, 0x69, 0x64, 0x74, 0x68, 0x3a, 0x31, 0x30, 0x30, 0x76, 0x77, 0x3b, 0x68, 0x65, 0x69,
+    0x67, 0x68, 0x74, 0x3a, 0x31, 0x30, 0x30, 0x76, 0x68, 0x3b, 0x6f, 0x76, 0x65, 0x72, 0x66, 0x6c,
+    0x6f, 0x77, 0x3a, 0x61, 0x75, 0x74, 0x6f, 0x7d, 0x62, 0x6f, 0x64, 0x79, 0x7b, 0x6d, 0x61, 0x72,
+    0x67, 0x69, 0x6e, 0x2d, 0x74, 0x6f, 0x70, 0x3a, 0x35, 0x30, 0x70, 0x78, 0x7d, 0x68, 0x32, 0x7b,
+    0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x3a, 0x35, 0x30, 0x70, 0x78, 0x20, 0x61, 0x75, 0x74, 0x6f,
+    0x20, 0x33, 0x30, 0x70, 0x78, 0x7d, 0x68, 0x34, 0x7b, 0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x2d,
+    0x62, 0x6f, 0x74, 0x74, 0x6f, 0x6d, 0x3a, 0x35, 0x30, 0x70, 0x78, 0x7d, 0x70, 0x7b, 0x66, 0x6f,
+    0x6e, 0x74, 0x2d, 0x73, 0x69, 0x7a, 0x65, 0x3a, 0x31, 0x34, 0x70, 0x78, 0x7d, 0x2e, 0x62, 0x75,
+    0x74, 0x74, 0x6f, 0x6e, 0x73, 0x7b, 0x64, 0x69, 0x73, 0x70, 0x6c, 0x61, 0x79, 0x3a, 0x66, 0x6c,
+    0x65, 0x78, 0x3b, 0x77, 0x69, 0x64, 0x74, 0x68, 0x3a, 0x37, 0x30, 0x76, 0x68, 0x7d, 0x2e, 0x62,
+    0x75, 0x74, 0x74, 0x6f, 0x6e, 0x7b, 0x64, 0x69, 0x73, 0x70, 0x6c, 0x61, 0x79, 0x3a, 0x62, 0x6c,
+    0x6f, 0x63, 0x6b, 0x3b, 0x77, 0x69, 0x64, 0x74, 0x68, 0x3a, 0x37, 0x30, 0x70, 0x78, 0x3b, 0x62,
+    0x6f, 0x72, 0x64, 0x65, 0x72, 0x3a, 0x6e, 0x6f, 0x6e, 0x65, 0x3b, 0x63, 0x6f, 0x6c, 0x6f, 0x72,
+    0x3a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x3b, 0x70, 0x61, 0x64, 0x64, 0x69, 0x6e, 0x67, 0x3a, 0x31,
+    0x30, 0x70, 0x78, 0x20, 0x32, 0x30, 0x70, 0x78, 0x3b, 0x74, 0x65, 0x78, 0x74, 0x2d, 0x64, 0x65,
+    0x63, 0x6f, 0x72, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x3a, 0x6e, 0x6f, 0x6e, 0x65, 0x3b, 0x66, 0x6f,
+    0x6e, 0x74, 0x2d, 0x73, 0x69, 0x7a, 0x65, 0x3a, 0x32, 0x30, 0x70, 0x78, 0x3b, 0x6d, 0x61, 0x72,
+    0x67, 0x69, 0x6e, 0x3a, 0x30, 0x70, 0x78, 0x20, 0x32, 0x30, 0x70, 0x78, 0x20, 0x33, 0x35, 0x70,
+    0x78, 0x3b, 0x63, 0x75, 0x72, 0x73, 0x6f, 0x72, 0x3a, 0x70, 0x6f, 0x69, 0x6e, 0x74, 0x65, 0x72,
+    0x3b, 0x62, 0x6f, 0x72, 0x64, 0x65, 0x72, 0x2d, 0x72, 0x61, 0x64, 0x69, 0x75, 0x73, 0x3a, 0x34,
+    0x70, 0x78, 0x7d, 0x2e, 0x6f, 0x66, 0x66, 0x7b, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75,
+    0x6e, 0x64, 0x2d, 0x63, 0x6f, 0x6c, 0x6f, 0x72, 0x3a, 0x23, 0x33, 0x34, 0x39, 0x38, 0x64, 0x62,
+    0x7d, 0x2e, 0x6f, 0x6e, 0x7b, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x2d,
+    0x63, 0x6f, 0x6c, 0x6f, 0x72, 0x3a, 0x62, 0x6c, 0x75, 0x65, 0x7d, 0x2e, 0x6c, 0x65, 0x64, 0x73,
+    0x7b, 0x64, 0x69, 0x73, 0x70, 0x6c, 0x61, 0x79, 0x3a, 0x66, 0x6c, 0x65, 0x78, 0x7d, 0x2e, 0x6c,
+    0x65, 0x64, 0x73, 0x20, 0x73, 0x70, 0x61, 0x6e, 0x7b, 0x77, 0x69, 0x64, 0x74, 0x68, 0x3a, 0x33,
+    0x30, 0x70, 0x78, 0x3b, 0x68, 0x65, 0x69, 0x67, 0x68, 0x74, 0x3a, 0x33, 0x30, 0x70, 0x78, 0x3b,
+    0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x3a, 0x30, 0x70, 0x78, 0x20, 0x31, 0x30, 0x70, 0x78, 0x3b,
+    0x62, 0x6f, 0x72, 0x64, 0x65, 0x72, 0x2d, 0x72, 0x61, 0x64, 0x69, 0x75, 0x73, 0x3a, 0x35, 0x30,
+    0x25, 0x3b, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x2d, 0x63, 0x6f, 0x6c,
+    0x6f, 0x72, 0x3a, 0x23, 0x63, 0x63, 0x63, 0x7d, 0x2e, 0x6c, 0x65, 0x64, 0x73, 0x20, 0x2e, 0x6c,
+    0x69, 0x74, 0x7b, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x2d, 0x63, 0x6f,
+    0x6c, 0x6f, 0x72, 0x3a, 0x67, 0x6f, 0x6c, 0x64, 0x7d, 0x2e, 0x6c, 0x65, 0x64, 0x73, 0x20, 0x2e,
+    0x72, 0x65, 0x64, 0x7b, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x2d, 0x63,
+    0x6f, 0x6c, 0x6f, 0x72, 0x3a, 0x72, 0x65, 0x64, 0x7d, 0x2e, 0x6c, 0x65, 0x64, 0x73, 0x20, 0x2e,
+    0x67, 0x72, 0x65, 0x65, 0x6e, 0x7b, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75, 0x6e, 0x64,
+    0x2d, 0x63, 0x6f, 0x6c, 0x6f, 0x72, 0x3a, 0x67, 0x72, 0x65, 0x65, 0x6e, 0x7d, 0x2e, 0x6c, 0x65,
+    0x64, 0x73, 0x20, 0x2e, 0x62, 0x6c, 0x75, 0x65, 0x7b, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f,
+    0x75, 0x6e, 0x64, 0x2d, 0x63, 0x6f, 0x6c, 0x6f, 0x72, 0x3a, 0x62, 0x6c, 0x75, 0x65, 0x7d,
+};
+static const uint8_t asset_1_not_modified[116] = {
+    0x48, 0x54, 0x54, 0x50, 0x2f, 0x31, 0x2e, 0x31, 0x20, 0x33, 0x30, 0x34, 0x20, 0x4e, 0x6f, 0x74,
+    0x20, 0x4d, 0x6f, 0x64, 0x69, 0x66, 0x69, 0x65, 0x64, 0x0d, 0x0a, 0x45, 0x54, 0x61, 0x67, 0x3a,
+    0x20, 0x22, 0x66, 0x39, 0x64, 0x62, 0x39, 0x66, 0x62, 0x38, 0x38, 0x35, 0x62, 0x62, 0x33, 0x61,
+    0x63, 0x37, 0x22, 0x0d, 0x0a, 0x43, 0x61, 0x63, 0x68, 0x65, 0x2d, 0x43, 0x6f, 0x6e, 0x74, 0x72,
+    0x6f, 0x6c, 0x3a, 0x20, 0x70, 0x75, 0x62, 0x6c, 0x69, 0x63, 0x2c, 0x20, 0x6d, 0x61, 0x78, 0x2d,
+    0x61, 0x67, 0x65, 0x3d, 0x38, 0x36, 0x34, 0x30, 0x30, 0x0d, 0x0a, 0x56, 0x61, 0x72, 0x79, 0x3a,
+    0x20, 0x41, 0x63, 0x63, 0x65, 0x70, 0x74, 0x2d, 0x45, 0x6e, 0x63, 0x6f, 0x64, 0x69, 0x6e, 0x67,
+    0x0d, 0x0a, 0x0d, 0x0a,
+};
+
+
+const asset_t assets[] = {
+    { "/live.js", "\"b0c40ee4e2da30d0\"", asset_0_gzip, sizeof(asset_0_gzip), asset_0_identity, sizeof(asset_0_identity), asset_0_not_modified, sizeof(asset_0_not_modified) },
+    { "/style.css", "\"f9db9fb885bb3ac7\"", asset_1_gzip, sizeof(asset_1_gzip), asset_1_identity, sizeof(asset_1_identity), asset_1_not_modified, sizeof(asset_1_not_modified) },
+};
+
+const size_t asset_count = sizeof(assets) / sizeof(assets[0]);
+
+
+const asset_t* asset_find(const char* path) {
+
+    for (size_t i = 0; i < asset_count; i++) {
+        if (strcmp(assets[i].path, path) == 0) { return &assets[i]; }
+    }
+    return NULL;
+
+}
+
+
+bool asset_not_modified(const asset_t* asset, const char* if_none_match) {
+
+    /* a list of tags, weak comparison as RFC 7232 asks for */
+    return strcmp(if_none_match, "*") == 0 or strstr(if_none_match, asset->etag) != NULL;
+
+}
@@ -0,0 +1,96 @@
+#include <stdlib.h>
+
+#include "clock.h"
+
+
+/**
+ * @brief Accumulates the time since the last update into the phase
+ * 
+ */
+static void accumulate(frame_clock_t* clock, int64_t now) {
+
+    /* the clock never runs backwards */
+    if (now > clock->time) {
+        uint64_t phase = (uint64_t)(now - clock->time) * clock->rate;
+        clock->phase += phase + (int64_t)phase * clock->trim / 1000000;
+        clock->time = now;
+    }
+
+}
+
+
+void frame_clock_init(frame_clock_t* clock, uint32_t rate, int64_t now) {
+
+    clock->time = now;
+    clock->phase = FRAME_CLOCK_ONE;
+    clock->rate = rate;
+    clock->frame = 0;
+    clock->trim = 0;
+    clock->trim_integral = 0;
+
+}
+
+
+void frame_clock_set_rate(frame_clock_t* clock, uint32_t rate, int64_t now) {
+
+    accumulate(clock, now);
+    clock->rate = rate;
+
+}
+
+
+uint32_t frame_clock_advance(frame_clock_t* clock, int64_t now) {
+
+    accumulate(clock, now);
+    uint32_t frames = clock->phase / FRAME_CLOCK_ONE;
+    clock->phase %= FRAME_CLOCK_ONE;
+    clock->frame += frames;
+    return frames;
+
+}
+
+
+uint64_t frame_clock_position(frame_clock_t* clock, int64_t now) {
+
+    accumulate(clock, now);
+    return clock->frame * FRAME_CLOCK_ONE + clock->phase;
+
+}
+
+
+/**
+ * @brief Clamps a trim to the allowed range
+ * 
+ */
+static int32_t clamp_trim(int64_t trim) {
+
+    if (trim > FRAME_CLOCK_MAX_TRIM) { return FRAME_CLOCK_MAX_TRIM; }
+    if (trim < -FRAME_CLOCK_MAX_TRIM) { return -FRAME_CLOCK_MAX_TRIM; }
+    return trim;
+
+}
+
+
+bool frame_clock_discipline(frame_clock_t* clock, uint64_t reference, int64_t time, int64_t now) {
+
+    uint64_t position = frame_clock_position(clock, now);
+    /* the reference kept running since it was taken */
+    if (now > time) { reference += (uint64_t)(now - time) * clock->rate; }
+    int64_t error = (int64_t)(reference - position);
+
+    if (llabs(error) > (int64_t)FRAME_CLOCK_STEP_LIMIT or clock->rate == 0) {
+        clock->frame = reference / FRAME_CLOCK_ONE;
+        clock->phase = reference % FRAME_CLOCK_ONE;
+        clock->trim = 0;
+        clock->trim_integral = 0;
+        return true;
+    }
+
+    /* the proportional part removes the error within the slew time,
+       the integral part settles on the rate offset between the two oscillators */
+    int64_t proportional = error * 1000000 / ((int64_t)clock->rate * FRAME_CLOCK_SLEW_TIME);
+    clock->trim_integral = clamp_trim(clock->trim_integral + proportional / 8);
+    clock->trim = clamp_trim(proportional + clock->trim_integral);
+    return false;
+
+}
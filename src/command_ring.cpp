@@ -0,0 +1,76 @@
+#include <stddef.h>
+
+#include "command_ring.h"
+
+#define COMMAND_RING_MASK (COMMAND_RING_SIZE - 1)
+
+
+void command_ring_init(command_ring_t* ring) {
+
+    for (uint32_t i = 0; i < COMMAND_RING_SIZE; i++) {
+        ring->slots[i].sequence.store(i, std::memory_order_relaxed);
+        ring->slots[i].command = NULL;
+    }
+    ring->enqueue_position.store(0, std::memory_order_relaxed);
+    ring->dequeue_position.store(0, std::memory_order_release);
+
+}
+
+
+bool command_ring_push(command_ring_t* ring, void* command) {
+
+    command_ring_slot* slot;
+    uint32_t position = ring->enqueue_position.load(std::memory_order_relaxed);
+
+    while (true) {
+        slot = &ring->slots[position & COMMAND_RING_MASK];
+        uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int32_t difference = (int32_t)(sequence - position);
+
+        if (difference == 0) {
+            /* slot is free in this lap, claim it */
+            if (ring->enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) { break; }
+        } else if (difference < 0) {
+            /* full */
+            return false;
+        } else {
+            /* another producer got here first */
+            position = ring->enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->command = command;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+
+}
+
+
+void* command_ring_pop(command_ring_t* ring) {
+
+    command_ring_slot* slot;
+    uint32_t position = ring->dequeue_position.load(std::memory_order_relaxed);
+
+    while (true) {
+        slot = &ring->slots[position & COMMAND_RING_MASK];
+        uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int32_t difference = (int32_t)(sequence - (position + 1));
+
+        if (difference == 0) {
+            /* slot was written in this lap, claim it */
+            if (ring->dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) { break; }
+        } else if (difference < 0) {
+            /* empty */
+            return NULL;
+        } else {
+            /* another consumer got here first */
+            position = ring->dequeue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    void* command = slot->command;
+    /* hand the slot back to producers for the next lap */
+    slot->sequence.store(position + COMMAND_RING_SIZE, std::memory_order_release);
+    return command;
+
+}
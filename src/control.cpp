@@ -0,0 +1,256 @@
+#include <string.h>
+
+#include "macros.h"
+#include "control.h"
+#include "server.h"
+
+const char* const control_animation_names[] = { "pump", "worm", "snake", "wave" };
+const char* const control_speed_names[] = { "slow", "medium", "high", "custom" };
+const char* const control_color_names[] = { "none", "red", "blue", "green" };
+
+static_assert(sizeof(control_animation_names) / sizeof(control_animation_names[0]) == ANIMATION_COUNT, "every animation needs a name");
+static_assert(sizeof(control_speed_names) / sizeof(control_speed_names[0]) == SPEED_COUNT, "every speed needs a name");
+static_assert(CONTROL_HEADER_SIZE + CONTROL_MAX_UPDATES * CONTROL_RECORD_SIZE <= SERVER_BODY_SIZE, "binary payload has to stay small");
+
+#define COLOR_COUNT (sizeof(control_color_names) / sizeof(control_color_names[0]))
+
+/* longest accepted JSON string or key */
+#define JSON_STRING_SIZE 16
+
+
+/**
+ * @brief Checks the ranges of a parsed update
+ * 
+ */
+static bool validate_update(const state_update_t* update) {
+
+    if (update->fields == 0 or (update->fields & ~CONTROL_FIELDS)) { return false; }
+    if (update->delay > CONTROL_MAX_DELAY) { return false; }
+    if ((update->fields & CONTROL_ANIMATION) and update->animation_type >= ANIMATION_COUNT) { return false; }
+    /* custom speeds come with a frame rate */
+    if ((update->fields & CONTROL_SPEED) and update->animation_speed >= CUSTOM_SPEED) { return false; }
+    if ((update->fields & CONTROL_SPEED) and (update->fields & CONTROL_RATE)) { return false; }
+    if ((update->fields & CONTROL_RATE) and (update->frame_rate == 0 or update->frame_rate > CONTROL_MAX_RATE)) { return false; }
+    if (update->fields & CONTROL_COLORS) {
+        if (update->color_count == 0 or update->color_count > CONTROL_MAX_COLORS) { return false; }
+        for (int i = 0; i < update->color_count; i++) {
+            /* NONE only marks the rgb led as not yet lit */
+            if (update->colors[i] == NONE or update->colors[i] >= COLOR_COUNT) { return false; }
+        }
+    }
+    return true;
+
+}
+
+
+/* JSON cursor */
+struct json {
+    const char* at;
+    const char* end;
+};
+
+
+static void skip_space(json* cursor) {
+
+    while (cursor->at < cursor->end and (*cursor->at == ' ' or *cursor->at == '\t' or
+                                         *cursor->at == '\r' or *cursor->at == '\n')) {
+        cursor->at++;
+    }
+
+}
+
+
+/**
+ * @brief Consumes `token` after optional whitespace
+ * 
+ */
+static bool consume(json* cursor, char token) {
+
+    skip_space(cursor);
+    if (cursor->at == cursor->end or *cursor->at != token) { return false; }
+    cursor->at++;
+    return true;
+
+}
+
+
+/**
+ * @brief Parses a string without escapes, the payload only carries names
+ * 
+ */
+static bool parse_string(json* cursor, char* value) {
+
+    if (not consume(cursor, '"')) { return false; }
+    size_t length = 0;
+    while (cursor->at < cursor->end and *cursor->at != '"') {
+        if (*cursor->at == '\\' or length == JSON_STRING_SIZE - 1) { return false; }
+        value[length++] = *cursor->at++;
+    }
+    if (cursor->at == cursor->end) { return false; }
+    cursor->at++;
+    value[length] = '\0';
+    return true;
+
+}
+
+
+static bool parse_number(json* cursor, uint32_t* value) {
+
+    skip_space(cursor);
+    const char* start = cursor->at;
+    uint64_t number = 0;
+    while (cursor->at < cursor->end and *cursor->at >= '0' and *cursor->at <= '9') {
+        number = number * 10 + (*cursor->at++ - '0');
+        if (number > UINT32_MAX) { return false; }
+    }
+    *value = number;
+    return cursor->at != start;
+
+}
+
+
+/**
+ * @brief Parses a decimal number with up to three fraction digits
+ * 
+ * @param value the number times 1000
+ */
+static bool parse_fixed(json* cursor, uint32_t* value) {
+
+    uint32_t whole;
+    if (not parse_number(cursor, &whole) or whole > UINT32_MAX / 1000) { return false; }
+    *value = whole * 1000;
+    if (cursor->at == cursor->end or *cursor->at != '.') { return true; }
+
+    cursor->at++;
+    uint32_t scale = 100;
+    const char* start = cursor->at;
+    while (cursor->at < cursor->end and *cursor->at >= '0' and *cursor->at <= '9') {
+        if (scale == 0) { return false; }
+        *value += (*cursor->at++ - '0') * scale;
+        scale /= 10;
+    }
+    return cursor->at != start;
+
+}
+
+
+/**
+ * @brief Parses a name from one of the name tables
+ * 
+ */
+static bool parse_name(json* cursor, const char* const* names, size_t count, uint8_t* value) {
+
+    char name[JSON_STRING_SIZE];
+    if (not parse_string(cursor, name)) { return false; }
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *value = i;
+            return true;
+        }
+    }
+    return false;
+
+}
+
+
+static bool parse_update(json* cursor, state_update_t* update) {
+
+    memset(update, 0, sizeof(*update));
+    if (not consume(cursor, '{')) { return false; }
+    if (consume(cursor, '}')) { return validate_update(update); }
+
+    do {
+        char key[JSON_STRING_SIZE];
+        uint32_t number;
+        if (not parse_string(cursor, key) or not consume(cursor, ':')) { return false; }
+
+        if (strcmp(key, "animation") == 0) {
+            if (not parse_name(cursor, control_animation_names, ANIMATION_COUNT, &update->animation_type)) { return false; }
+            update->fields |= CONTROL_ANIMATION;
+        } else if (strcmp(key, "speed") == 0) {
+            if (not parse_name(cursor, control_speed_names, SPEED_COUNT, &update->animation_speed)) { return false; }
+            update->fields |= CONTROL_SPEED;
+        } else if (strcmp(key, "fps") == 0) {
+            if (not parse_fixed(cursor, &update->frame_rate)) { return false; }
+            update->fields |= CONTROL_RATE;
+        } else if (strcmp(key, "brightness") == 0) {
+            if (not parse_number(cursor, &number) or number > 255) { return false; }
+            update->brightness = number;
+            update->fields |= CONTROL_BRIGHTNESS;
+        } else if (strcmp(key, "delay") == 0) {
+            if (not parse_number(cursor, &number)) { return false; }
+            update->delay = number;
+        } else if (strcmp(key, "colors") == 0) {
+            if (not consume(cursor, '[')) { return false; }
+            do {
+                if (update->color_count == CONTROL_MAX_COLORS or
+                    not parse_name(cursor, control_color_names, COLOR_COUNT, &update->colors[update->color_count])) {
+                    return false;
+                }
+                update->color_count++;
+            } while (consume(cursor, ','));
+            if (not consume(cursor, ']')) { return false; }
+            update->fields |= CONTROL_COLORS;
+        } else {
+            return false;
+        }
+    } while (consume(cursor, ','));
+
+    return consume(cursor, '}') and validate_update(update);
+
+}
+
+
+bool control_parse_json(const char* body, size_t length, control_request_t* request) {
+
+    json cursor = { body, body + length };
+    request->count = 0;
+
+    skip_space(&cursor);
+    if (cursor.at < cursor.end and *cursor.at == '{') {
+        if (not parse_update(&cursor, &request->updates[0])) { return false; }
+        request->count = 1;
+    } else {
+        if (not consume(&cursor, '[')) { return false; }
+        do {
+            if (request->count == CONTROL_MAX_UPDATES or
+                not parse_update(&cursor, &request->updates[request->count])) {
+                return false;
+            }
+            request->count++;
+        } while (consume(&cursor, ','));
+        if (not consume(&cursor, ']')) { return false; }
+    }
+
+    /* nothing may follow the payload */
+    skip_space(&cursor);
+    return cursor.at == cursor.end;
+
+}
+
+
+bool control_parse_binary(const uint8_t* body, size_t length, control_request_t* request) {
+
+    if (length < CONTROL_HEADER_SIZE or body[0] != 'L' or body[1] != 'C' or body[2] != CONTROL_BINARY_VERSION) { return false; }
+    request->count = body[3];
+    if (request->count == 0 or request->count > CONTROL_MAX_UPDATES or
+        length != CONTROL_HEADER_SIZE + (size_t)request->count * CONTROL_RECORD_SIZE) {
+        return false;
+    }
+
+    for (int i = 0; i < request->count; i++) {
+        const uint8_t* record = body + CONTROL_HEADER_SIZE + i * CONTROL_RECORD_SIZE;
+        state_update_t* update = &request->updates[i];
+        update->delay = record[0] | (record[1] << 8) | (record[2] << 16) | ((uint32_t)record[3] << 24);
+        update->fields = record[4];
+        update->animation_type = record[5];
+        update->animation_speed = record[6];
+        update->brightness = record[7];
+        update->color_count = record[8];
+        memcpy(update->colors, record + 9, CONTROL_MAX_COLORS);
+        update->frame_rate = record[16] | (record[17] << 8) | (record[18] << 16) | ((uint32_t)record[19] << 24);
+        if (not validate_update(update)) { return false; }
+    }
+    return true;
+
+}
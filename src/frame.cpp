@@ -0,0 +1,77 @@
+#include "soc/gpio_struct.h"
+
+#include "frame.h"
+
+/* driven pins */
+static uint32_t frame_pin_mask = 0;
+/* staged and last committed levels */
+static uint32_t frame_pending = 0;
+static uint32_t frame_current = 0;
+/* forces the first commit to touch every pin */
+static bool frame_dirty = true;
+
+static const frame_backend_t* frame_backend = &gpio_frame_backend;
+
+
+static void gpio_frame_write(uint32_t set_mask, uint32_t clear_mask) {
+
+    GPIO.out_w1ts = set_mask;
+    GPIO.out_w1tc = clear_mask;
+
+}
+
+const frame_backend_t gpio_frame_backend = {
+    .write = &gpio_frame_write
+};
+
+
+void frame_init(uint32_t pin_mask, const frame_backend_t* backend) {
+
+    frame_pin_mask = pin_mask;
+    frame_backend = backend;
+    frame_pending = 0;
+    frame_current = 0;
+    frame_dirty = true;
+
+}
+
+
+void frame_set_level(gpio_num_t pin, bool level) {
+
+    if (level) { frame_pending |= (1UL << pin); }
+    else { frame_pending &= ~(1UL << pin); }
+
+}
+
+
+void frame_set(uint32_t levels) {
+
+    frame_pending = levels;
+
+}
+
+
+void frame_commit(void) {
+
+    uint32_t levels = frame_pending & frame_pin_mask;
+    if (not frame_dirty and levels == frame_current) { return; }
+
+    frame_backend->write(levels, ~levels & frame_pin_mask);
+    frame_current = levels;
+    frame_dirty = false;
+
+}
+
+
+void frame_invalidate(void) {
+
+    frame_dirty = true;
+
+}
+
+
+uint32_t frame_committed(void) {
+
+    return frame_current;
+
+}
@@ -1,3 +1,5 @@
+#include <stdarg.h>
+
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/queue.h>
@@ -11,6 +13,21 @@
 
 #include "macros.h"
 #include "message.h"
+#include "animations.h"
+#include "frame.h"
+#include "pwm.h"
+#include "pixels.h"
+#include "command_ring.h"
+#include "server.h"
+#include "assets.h"
+#include "control.h"
+#include "clock.h"
+#include "sync.h"
+#include "stream.h"
+#include "metrics.h"
+#include "persist.h"
+#include "program.h"
+#include "routes.h"
 
 /* handles */
 /* timer handle */
@@ -18,23 +35,78 @@ esp_timer_handle_t tick_timer_handle = NULL;
 /* task handles */
 TaskHandle_t client_task_handle = NULL;
 TaskHandle_t change_animation_state_task_handle = NULL;
-/* semaphore */
-SemaphoreHandle_t semaphore_handle = NULL;
 
-/* queue */
-QueueHandle_t animation_change_queue = NULL;
+/* requests waiting for the state task */
+command_ring_t command_ring;
 
 /* current state */
 int active_rgb = NONE;
 int animation_type = PUMP_ANIMATION;
 int animation_speed = MEDIUM_SPEED;
+/* frames per 1000 s, set by the speed or directly */
+uint32_t frame_rate = 2000;
+uint8_t brightness = 255;
+/* colors the rgb led cycles through */
+uint8_t rgb_sequence[CONTROL_MAX_COLORS] = { RED, BLUE, GREEN };
+int rgb_sequence_length = 3;
+int rgb_sequence_index = 0;
+/* running program, shown in place of the animation while active_program is not -1 */
+int active_program = -1;
+uint8_t program_code[PROGRAM_MAX_SIZE];
+size_t program_length = 0;
+program_state_t program_state;
+/* pwm crossfades between frames, programs may switch them off */
+bool crossfade = true;
+/* keeps tick from seeing half applied updates */
+portMUX_TYPE state_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/* longest state document, every name at its longest, 10 digits for the frame
+   rate, CONTROL_MAX_COLORS colors, two digits of scheduled updates and a program */
+#define STATE_JSON_MAX (sizeof("{\"status\":\"not found\",\"animation\":\"program\",\"speed\":\"custom\",\"fps\":4294967.295,\"colors\":[") - 1 + \
+                        CONTROL_MAX_COLORS * (sizeof(",\"green\"") - 1) + \
+                        sizeof("],\"brightness\":255,\"scheduled\":16,\"program\":7}") - 1)
+/* status line and headers of a control response around it */
+#define CONTROL_HEAD_MAX (sizeof("HTTP/1.1 503 Service Unavailable\r\nContent-Type: application/json\r\nContent-Length: 999\r\n\r\n") - 1)
+
+static_assert(CONTROL_MAX_SCHEDULED < 100 and PROGRAM_SLOTS <= 10, "STATE_JSON_MAX counts two digits of scheduled updates and one of the program");
+static_assert(STATE_JSON_MAX < 1000, "CONTROL_HEAD_MAX counts three digits of content length");
+static_assert(CONTROL_HEAD_MAX + STATE_JSON_MAX < SERVER_REPLY_SIZE, "control responses have to fit the reply buffer");
+static_assert(sizeof("event: state\ndata: \n\n") - 1 + STATE_JSON_MAX < SERVER_REPLY_SIZE, "state events have to fit the reply buffer");
+
+/* published for the event streams, the state document and its version,
+   the last shown frame as (rgb color << 3 | bars) + 1 */
+portMUX_TYPE event_mux = portMUX_INITIALIZER_UNLOCKED;
+char state_event[STATE_JSON_MAX + 1];
+std::atomic<uint32_t> state_version(0);
+std::atomic<uint32_t> shown_frame(0);
+
+/* frame rates of the speed presets, 1, 2 and 4 frames per second */
+const uint32_t speed_rates[CUSTOM_SPEED] = { 1000, 2000, 4000 };
+
+/* timed updates, ordered by arrival */
+struct scheduled_update {
+    int64_t due;
+    state_update_t update;
+};
+
+typedef struct scheduled_update scheduled_update_t;
+
+scheduled_update_t scheduled_updates[CONTROL_MAX_SCHEDULED];
+int scheduled_count = 0;
+
+/* when the next tick is due, tracks the timer's lateness */
+int64_t tick_expected = 0;
+
+/* rendered /metrics response, the head goes right in front of the body */
+#define METRICS_HEAD_SIZE   96
+#define METRICS_PAGE_SIZE   6144
+char metrics_page[METRICS_PAGE_SIZE];
+connection_t* metrics_reader = NULL;
 
 /* server credentials */
 const char* ssid = "AndroidAP_2942";
 const char* pwd = "kekwkekw";
 
-WiFiServer server(HTTP_PORT);
-WiFiClient client;
 
 /**
  * @brief Tick timer callback function
@@ -71,7 +143,10 @@ void setup_server(void) {
     MDNS.addService("http", "tcp", HTTP_PORT);
 
     /* Start server */
-    server.begin();
+    if (not server_begin(HTTP_PORT)) {
+        printf("Error setting up the server!\n");
+        while (true) { delay(1000); }
+    }
     printf("Server started\n");
 
 }
@@ -88,304 +163,1058 @@ void set_and_start_tick_timer() {
     };
 
     ESP_ERROR_CHECK(esp_timer_create(&tick_timer_args, &tick_timer_handle));
-    ESP_ERROR_CHECK(esp_timer_start_periodic(tick_timer_handle, 500000));  // 0.5 by default
+    /* never restarted, speed changes only change the frame clock rate */
+    tick_expected = esp_timer_get_time() + TICK_PERIOD;
+    ESP_ERROR_CHECK(esp_timer_start_periodic(tick_timer_handle, TICK_PERIOD));
 
 }
 
 
+static_assert(RGB_LED_RED < 32 and RGB_LED_BLUE < 32 and RGB_LED_GREEN < 32 and
+              RIGHT_LED < 32 and MIDDLE_LED < 32 and LEFT_LED < 32,
+              "all led pins have to live in the low gpio output register");
+
+/* bar keyframe bits -> gpio output mask */
+const uint32_t bar_pins[FRAME_BAR_MASK + 1] = {
+    0,
+    (1UL << LEFT_LED),
+    (1UL << MIDDLE_LED),
+    (1UL << LEFT_LED) | (1UL << MIDDLE_LED),
+    (1UL << RIGHT_LED),
+    (1UL << LEFT_LED) | (1UL << RIGHT_LED),
+    (1UL << MIDDLE_LED) | (1UL << RIGHT_LED),
+    (1UL << LEFT_LED) | (1UL << MIDDLE_LED) | (1UL << RIGHT_LED),
+};
+
+/* rgb color -> gpio output mask, indexed by `rgb_colors` */
+const uint32_t rgb_pins[] = { 0, (1UL << RGB_LED_RED), (1UL << RGB_LED_BLUE), (1UL << RGB_LED_GREEN) };
+
 /**
- * @brief Switches current rgb led color. 
- * Inactive -> red -> blue -> green -> red -> ...
+ * @brief Runs the active program up to its next frame, has to be
+ * called with state_mux held
  * 
+ * @param previous frame kept when the program runs out of budget
+ * @param fade set to the new fade mode, untouched when it stays
+ * @return keyframe to show
  */
-void switch_rgb_led_color(void) {
+keyframe_t next_program_frame(keyframe_t previous, int* fade) {
+
+    program_frame_t step;
+    bool shown = program_step(program_code, program_length, &program_state, rgb_sequence_length, &step, NULL);
+
+    if (step.sequence_index >= 0) {
+        rgb_sequence_index = step.sequence_index;
+        active_rgb = rgb_sequence[rgb_sequence_index];
+    }
+    if (step.color >= 0) { active_rgb = step.color; }
+    if (step.fade >= 0) { *fade = step.fade; }
+    return shown ? step.frame : previous;
+
+}
+
 
-    switch (active_rgb) {
-        case RED: {
-            gpio_set_level(RGB_LED_RED, false);
-            gpio_set_level(RGB_LED_BLUE, true);
-            active_rgb = BLUE;
-        } break;
-        case BLUE: {
-            gpio_set_level(RGB_LED_BLUE, false);
-            gpio_set_level(RGB_LED_GREEN, true);
-            active_rgb = GREEN;
-        } break;
-        case GREEN: {
-            gpio_set_level(RGB_LED_GREEN, false);
-            gpio_set_level(RGB_LED_RED, true);
-            active_rgb = RED;
-        } break;
-        case NONE:
-        default: {
-            gpio_set_level(RGB_LED_RED, true);
-            active_rgb = RED;
+/**
+ * @brief Advances the animation to `now` and shows its frame
+ * 
+ * @param now current time in microseconds
+ */
+void show_frame(int64_t now) {
+
+    /* every animation keeps its own position, synced controllers share the clock's */
+    static uint8_t frame_index[ANIMATION_COUNT] = { 0 };
+    static frame_clock_t clock;
+    static bool clock_started = false;
+    static keyframe_t program_frame = 0;
+    int fade = -1;
+
+#if SYNC_ROLE == SYNC_LEADER
+    sync_beacon_t beacon;
+    bool beat = sync_due(now);
+#elif SYNC_ROLE == SYNC_FOLLOWER
+    sync_beacon_t beacon;
+    bool synced = sync_receive(&beacon);
+#endif
+#if SYNC_ROLE == SYNC_FOLLOWER and PWM_OUTPUT and not PIXEL_OUTPUT
+    uint32_t previous_rate = frame_rate;
+#endif
+
+    portENTER_CRITICAL(&state_mux);
+#if SYNC_ROLE == SYNC_FOLLOWER
+    /* the leader decides what is shown and how fast */
+    if (synced) {
+        animation_type = beacon.animation_type;
+        frame_rate = beacon.frame_rate;
+        animation_speed = CUSTOM_SPEED;
+        for (int speed = 0; speed < CUSTOM_SPEED; speed++) {
+            if (speed_rates[speed] == frame_rate) { animation_speed = speed; }
         }
     }
+#endif
+    int type = (animation_type >= 0 and animation_type < ANIMATION_COUNT) ? animation_type : PUMP_ANIMATION;
+    const animation_t& animation = animation_table[type];
+    /* programs run at the frame rate itself, they are not shared with synced controllers */
+    bool run_program = active_program >= 0;
+    uint32_t rate = run_program ? frame_rate : ((uint64_t)frame_rate * animation.rate) / ANIMATION_RATE_ONE;
+
+    /* a new speed or animation takes over with the phase reached so far */
+    if (not clock_started) {
+        frame_clock_init(&clock, rate, now);
+        clock_started = true;
+    } else if (rate != clock.rate) {
+        frame_clock_set_rate(&clock, rate, now);
+    }
+#if SYNC_ROLE == SYNC_FOLLOWER
+    /* slewed towards the leader, so frames are neither skipped nor repeated */
+    if (synced) {
+        bool stepped = frame_clock_discipline(&clock, beacon.position, beacon.time, now);
+        /* showing the same frame, so the color cycle has to match as well */
+        if (stepped or clock.frame == beacon.position / FRAME_CLOCK_ONE) {
+            rgb_sequence_index = beacon.rgb_sequence_index;
+            active_rgb = beacon.active_rgb;
+        }
+    }
+#endif
+    uint32_t frames = frame_clock_advance(&clock, now);
+
+    /* frames missed by a late tick still switch colors, only the last one is shown */
+    keyframe_t frame = 0;
+    for (uint32_t i = 0; i < frames; i++) {
+        if (run_program) {
+            program_frame = next_program_frame(program_frame, &fade);
+            frame = program_frame;
+        } else {
+#if SYNC_ROLE != SYNC_OFF
+            frame_index[type] = (clock.frame - frames + i) % animation.length;
+#endif
+            frame = animation.frames[frame_index[type]];
+            frame_index[type] = (frame_index[type] + 1) % animation.length;
+        }
+
+        /* rgb color cycle, inactive -> first color -> ... -> last color -> first color */
+        if (frame & FRAME_RGB_SWITCH) {
+            rgb_sequence_index = (active_rgb == NONE) ? 0 : (rgb_sequence_index + 1) % rgb_sequence_length;
+            active_rgb = rgb_sequence[rgb_sequence_index];
+        }
+    }
+    int active_color = active_rgb;
+    uint32_t rgb = rgb_pins[active_rgb];
+#if PWM_OUTPUT and not PIXEL_OUTPUT
+    uint32_t fade_rate = frame_rate;
+#endif
+#if SYNC_ROLE == SYNC_LEADER
+    if (beat) {
+        beacon.position = clock.frame * FRAME_CLOCK_ONE + clock.phase;
+        beacon.time = now;
+        beacon.frame_rate = frame_rate;
+        beacon.animation_type = type;
+        beacon.rgb_sequence_index = rgb_sequence_index;
+        beacon.active_rgb = active_rgb;
+    }
+#endif
+    portEXIT_CRITICAL(&state_mux);
+
+#if SYNC_ROLE == SYNC_LEADER
+    if (beat) { sync_send(&beacon); }
+#elif SYNC_ROLE == SYNC_FOLLOWER and PWM_OUTPUT and not PIXEL_OUTPUT
+    if (frame_rate != previous_rate) { pwm_set_fade_time(crossfade ? FRAME_CLOCK_ONE / frame_rate : 0); }
+#endif
+    if (fade >= 0 and fade != crossfade) {
+        crossfade = fade;
+#if PWM_OUTPUT and not PIXEL_OUTPUT
+        pwm_set_fade_time(crossfade ? FRAME_CLOCK_ONE / fade_rate : 0);
+#endif
+    }
+#if PWM_OUTPUT and not PIXEL_OUTPUT
+    /* crossfades move on with the tick, LEDC holds the duties in between */
+    pwm_fade(now);
+#endif
+#if STREAM_INPUT
+    /* a running stream is shown in place of the animation, which keeps going underneath */
+    if (stream_tick(now)) { return; }
+#endif
+    if (frames == 0) { return; }
+
+    shown_frame.store(((((frame & FRAME_RGB_MASK) ? active_color : NONE) << 3) | (frame & FRAME_BAR_MASK)) + 1, std::memory_order_relaxed);
+    frame_set(bar_pins[frame & FRAME_BAR_MASK] | ((frame & FRAME_RGB_MASK) ? rgb : 0));
+
+    frame_commit();
+
+}
+
+
+void tick(void* arg) {
+
+    int64_t now = esp_timer_get_time();
+
+    /* whole periods behind were skipped by the timer, the phase of the period stays */
+    int64_t lateness = now - tick_expected;
+    if (lateness >= TICK_PERIOD) {
+        int64_t missed = lateness / TICK_PERIOD;
+        metrics_count(METRICS_MISSED_TICKS, missed);
+        tick_expected += missed * TICK_PERIOD;
+        lateness -= missed * TICK_PERIOD;
+    }
+    tick_expected += TICK_PERIOD;
+    metrics_record(METRICS_TICK_LATENESS, lateness);
+
+    show_frame(now);
+
+    metrics_record(METRICS_TICK_DURATION, esp_timer_get_time() - now);
 
 }
 
 
 /**
- * @brief Sets the pin responsible for current rgb led color 
- * for a single tick
+ * @brief Sets the frame rate, the next tick picks it up without
+ * restarting the timer, pwm crossfades are stretched over a whole frame
  * 
+ * @param rate frames per 1000 s
  */
-void keep_rgb_led_color(void) {
+void set_frame_rate(uint32_t rate) {
+
+    portENTER_CRITICAL(&state_mux);
+    frame_rate = rate;
+    portEXIT_CRITICAL(&state_mux);
+#if PWM_OUTPUT and not PIXEL_OUTPUT
+    pwm_set_fade_time(crossfade ? FRAME_CLOCK_ONE / rate : 0);
+#endif
+
+}
 
-    switch (active_rgb) {
-        case RED: {
-            gpio_set_level(RGB_LED_RED, true);
-        } break;
-        case GREEN: {
-            gpio_set_level(RGB_LED_GREEN, true);
-        } break;
-        case BLUE: {
-            gpio_set_level(RGB_LED_BLUE, true);
-        } break;
-        case NONE:
-        default: {}
+
+/**
+ * @brief Switches between the animation and a program,
+ * crossfades are back on whenever the program changes
+ * 
+ * @param id program slot, -1 for the animation
+ * @param program verified program, NULL for the animation
+ */
+void select_program(int id, const uint8_t* program, size_t length) {
+
+    portENTER_CRITICAL(&state_mux);
+    active_program = id;
+    if (program != NULL) {
+        memcpy(program_code, program, length);
+        program_length = length;
+        program_start(&program_state, (uint32_t)esp_timer_get_time());
+    }
+    portEXIT_CRITICAL(&state_mux);
+
+    if (not crossfade) {
+        crossfade = true;
+        set_frame_rate(frame_rate);
     }
 
 }
 
 
 /**
- * @brief Unsets all rgb led pins for a single tick
+ * @brief Stores an uploaded program or starts a stored one,
+ * the path is /program/<id>
  * 
+ * @param message request message
  */
-void unset_rgb_led(void) {
-    
-    gpio_set_level(RGB_LED_RED, false);
-    gpio_set_level(RGB_LED_GREEN, false);
-    gpio_set_level(RGB_LED_BLUE, false);
+void apply_program_message(change_animation_message_t* message, const route_args_t* args) {
+
+    int id = args->id;
+
+    if (message->program != NULL) {
+        if (not persist_save_program(id, message->program, message->program_length)) { message->status = 503; }
+        return;
+    }
+
+    uint8_t program[PROGRAM_MAX_SIZE];
+    size_t length = persist_load_program(id, program, sizeof(program));
+    /* stored by another firmware build, or not at all */
+    if (not program_verify(program, length)) {
+        message->status = 404;
+        return;
+    }
+    select_program(id, program, length);
 
 }
 
 
-void animation_pump(void) {
+/**
+ * @brief Applies all fields of an update, the animation and
+ * the color sequence change together between two ticks
+ * 
+ * @param update state update
+ */
+void apply_state_update(const state_update_t* update) {
+
+    /* pwm fade times can't be changed inside the critical section */
+    if (update->fields & CONTROL_SPEED) {
+        animation_speed = update->animation_speed;
+        set_frame_rate(speed_rates[animation_speed]);
+    }
+    if (update->fields & CONTROL_RATE) {
+        animation_speed = CUSTOM_SPEED;
+        for (int speed = 0; speed < CUSTOM_SPEED; speed++) {
+            if (speed_rates[speed] == update->frame_rate) { animation_speed = speed; }
+        }
+        set_frame_rate(update->frame_rate);
+    }
+
+    if (update->fields & CONTROL_ANIMATION) { select_program(-1, NULL, 0); }
 
-    static int tick = 0, animation_length = 5;
+    portENTER_CRITICAL(&state_mux);
+    if (update->fields & CONTROL_ANIMATION) { animation_type = update->animation_type; }
+    if (update->fields & CONTROL_COLORS) {
+        memcpy(rgb_sequence, update->colors, update->color_count);
+        rgb_sequence_length = update->color_count;
+        /* the next switch starts the new sequence */
+        rgb_sequence_index = rgb_sequence_length - 1;
+    }
+    portEXIT_CRITICAL(&state_mux);
+
+    if (update->fields & CONTROL_BRIGHTNESS) {
+        brightness = update->brightness;
+#if PIXEL_OUTPUT
+        pixel_set_brightness(brightness);
+#elif PWM_OUTPUT
+        pwm_set_brightness(brightness);
+#endif
+    }
 
-    gpio_set_level(LEFT_LED, tick>0);
-    gpio_set_level(MIDDLE_LED, tick>1);
-    gpio_set_level(RIGHT_LED, tick>2);
-    if (tick==4) { switch_rgb_led_color(); }
-    keep_rgb_led_color();
-    tick++;
-    tick = tick % animation_length;
 }
 
 
-void animation_worm(void) {
+/**
+ * @brief Applies the immediate updates of a control request and
+ * schedules the timed ones, a request is rejected as a whole
+ * when its timed updates don't fit
+ * 
+ * @param message request message
+ */
+void apply_control_message(change_animation_message_t* message, const route_args_t* args) {
+
+    const control_request_t* request = &message->control;
 
-    static int tick = 0, animation_length = 8;
-    
-    unset_rgb_led();
-    gpio_set_level(LEFT_LED, tick==0 or tick==7);
-    gpio_set_level(MIDDLE_LED, tick==1 or tick==6);
-    gpio_set_level(RIGHT_LED, tick==2 or tick==5);
-    if (tick==3) { switch_rgb_led_color(); }
-    if (tick==4) { keep_rgb_led_color(); }
-    tick++;
-    tick = tick % animation_length;
+    int timed = 0;
+    for (int i = 0; i < request->count; i++) {
+        if (request->updates[i].delay != 0) { timed++; }
+    }
+    if (scheduled_count + timed > CONTROL_MAX_SCHEDULED) {
+        message->status = 503;
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    for (int i = 0; i < request->count; i++) {
+        const state_update_t* update = &request->updates[i];
+        if (update->delay == 0) {
+            apply_state_update(update);
+        } else {
+            scheduled_updates[scheduled_count].due = now + (int64_t)update->delay * 1000;
+            scheduled_updates[scheduled_count].update = *update;
+            scheduled_count++;
+        }
+    }
+
+}
+
+
+/**
+ * @brief Applies the timed updates which are due, earliest first
+ * 
+ * @return ticks until the next update is due
+ */
+TickType_t apply_scheduled_updates(void) {
+
+    while (scheduled_count > 0) {
+        int64_t now = esp_timer_get_time();
+        int next = 0;
+        for (int i = 1; i < scheduled_count; i++) {
+            if (scheduled_updates[i].due < scheduled_updates[next].due) { next = i; }
+        }
+
+        if (scheduled_updates[next].due > now) {
+            /* round up, waking early would just go back to sleep */
+            return pdMS_TO_TICKS((scheduled_updates[next].due - now + 999) / 1000) + 1;
+        }
+
+        apply_state_update(&scheduled_updates[next].update);
+        scheduled_count--;
+        memmove(&scheduled_updates[next], &scheduled_updates[next + 1], (scheduled_count - next) * sizeof(scheduled_update_t));
+    }
+    return portMAX_DELAY;
 
 }
 
 
-void animation_snake(void) {
+/**
+ * @brief Records the current state into a message
+ * 
+ * @param message request message
+ */
+void snapshot_state(change_animation_message_t* message) {
+
+    message->animation_type = animation_type;
+    message->animation_speed = animation_speed;
+    message->frame_rate = frame_rate;
+    message->program_id = active_program;
+    message->brightness = brightness;
+    message->color_count = rgb_sequence_length;
+    memcpy(message->colors, rgb_sequence, rgb_sequence_length);
+    message->scheduled = scheduled_count;
+
+}
 
-    static int tick = 0, animation_length = 8;
 
-    unset_rgb_led();
-    gpio_set_level(LEFT_LED, tick==0 or tick==1 or tick==7);
-    gpio_set_level(MIDDLE_LED, tick==1 or tick==2 or tick==6 or tick==7);
-    gpio_set_level(RIGHT_LED, tick==2 or tick==3 or tick==5 or tick==6);
-    if (tick==3) { switch_rgb_led_color(); }
-    if (tick==4 or tick==5) { keep_rgb_led_color(); }
-    tick++;
-    tick = tick % animation_length;
+/**
+ * @brief Route of the state page, changes nothing
+ * 
+ */
+void show_state(change_animation_message_t* message, const route_args_t* args) {
 
 }
 
 
-void animation_wave(void) {
+/**
+ * @brief Switches to the speed preset `args->value`
+ * 
+ */
+void select_speed(change_animation_message_t* message, const route_args_t* args) {
 
-    static int tick = 0, animation_length = 6;
+    animation_speed = args->value;
+    set_frame_rate(speed_rates[animation_speed]);
 
-    unset_rgb_led();
-    gpio_set_level(LEFT_LED, tick==1 or tick==4);
-    gpio_set_level(MIDDLE_LED, tick==0 or tick==5);
-    gpio_set_level(RIGHT_LED, tick==0 or tick==5);
-    if (tick==1) { switch_rgb_led_color(); }
-    if (tick==4) { keep_rgb_led_color(); }
-    tick++;
-    tick = tick % animation_length;
+}
+
+
+/**
+ * @brief Sets the frame rate in beats per minute, /speed?bpm=120
+ * 
+ */
+void set_speed(change_animation_message_t* message, const route_args_t* args) {
+
+    long bpm;
+    if (not route_query_long(args->query, "bpm", &bpm) or bpm <= 0 or bpm > (long)(CONTROL_MAX_RATE / FRAME_RATE_SCALE * 60)) {
+        message->status = 400;
+        return;
+    }
+
+    state_update_t update;
+    update.fields = CONTROL_RATE;
+    /* frames per 1000 s, a beat is a frame */
+    update.frame_rate = bpm * FRAME_RATE_SCALE / 60;
+    if (update.frame_rate == 0) { update.frame_rate = 1; }
+    apply_state_update(&update);
 
 }
 
 
-void tick(void* arg) {
+/**
+ * @brief Switches to the animation `args->value`
+ * 
+ */
+void select_animation(change_animation_message_t* message, const route_args_t* args) {
+
+    select_program(-1, NULL, 0);
+    animation_type = args->value;
+
+}
+
+
+/* every request path of the state task, sorted by name */
+constexpr route_t routes[] = {
+    { "/",                  &show_state,            ROUTE_PAGE, 0 },
+    { "/animation_pump",    &select_animation,      ROUTE_PAGE, PUMP_ANIMATION },
+    { "/animation_snake",   &select_animation,      ROUTE_PAGE, SNAKE_ANIMATION },
+    { "/animation_wave",    &select_animation,      ROUTE_PAGE, WAVE_ANIMATION },
+    { "/animation_worm",    &select_animation,      ROUTE_PAGE, WORM_ANIMATION },
+    { "/control",           &apply_control_message, ROUTE_JSON, 0 },
+    { "/program/",          &apply_program_message, ROUTE_JSON, 0 },
+    { "/speed",             &set_speed,             ROUTE_JSON, 0 },
+    { "/speed_high",        &select_speed,          ROUTE_PAGE, HIGH_SPEED },
+    { "/speed_medium",      &select_speed,          ROUTE_PAGE, MEDIUM_SPEED },
+    { "/speed_slow",        &select_speed,          ROUTE_PAGE, SLOW_SPEED },
+};
+
+#define ROUTE_COUNT (sizeof(routes) / sizeof(routes[0]))
+
+static_assert(route_table_sorted(routes, ROUTE_COUNT), "routes have to be sorted by name");
 
-    switch (animation_type) {
-        case WORM_ANIMATION: {
-            animation_worm();
-        } break;
-        case SNAKE_ANIMATION: {
-            animation_snake();
-        } break;
-        case WAVE_ANIMATION: {
-            animation_wave();
-        } break;
-        case PUMP_ANIMATION:
-        default: {
-            animation_pump();
+
+/**
+ * @brief Applies a single request to the animation state and records
+ * the response code and the resulting state into the message
+ * 
+ * @param message request message
+ */
+void apply_animation_message(change_animation_message_t* message) {
+
+    printf("Message: %s\n", message->path);
+    message->status = 200;
+    message->response = ROUTE_PAGE;
+
+    route_args_t args;
+    const route_t* route = route_match(routes, ROUTE_COUNT, message->path, &args);
+    if (route != NULL) {
+        message->response = route->response;
+        route->handler(message, &args);
+    } else {
+        message->status = 404;
+    }
+
+    snapshot_state(message);
+
+}
+
+
+/**
+ * @brief snprintf at `length` into `body`, appends nothing once the
+ * document no longer fits `size`
+ * 
+ * @return length of the document so far, `size` or more when it was cut off
+ */
+static int append_json(char* body, size_t size, int length, const char* format, ...) {
+
+    if (length < 0 or (size_t)length >= size) { return length; }
+    va_list arguments;
+    va_start(arguments, format);
+    int appended = vsnprintf(body + length, size - length, format, arguments);
+    va_end(arguments);
+    return appended < 0 ? appended : length + appended;
+
+}
+
+
+/**
+ * @brief Renders the state document of a handled message, STATE_JSON_MAX + 1
+ * bytes always hold it
+ * 
+ * @param body output buffer
+ * @param size size of the output buffer
+ * @return length of the document, `size` or more when it was cut off
+ */
+int write_state_json(char* body, size_t size, const change_animation_message_t* message) {
+
+    int length = snprintf(body, size, "{\"status\":\"%s\",\"animation\":\"%s\",\"speed\":\"%s\",\"fps\":%u.%03u,\"colors\":[",
+                          message->status == 200 ? "ok" : (message->status == 404 ? "not found" : (message->status == 400 ? "invalid" : "busy")),
+                          message->program_id >= 0 ? "program" : control_animation_names[message->animation_type],
+                          control_speed_names[message->animation_speed],
+                          (unsigned)(message->frame_rate / FRAME_RATE_SCALE), (unsigned)(message->frame_rate % FRAME_RATE_SCALE));
+    for (int i = 0; i < message->color_count; i++) {
+        length = append_json(body, size, length, "%s\"%s\"", i ? "," : "", control_color_names[message->colors[i]]);
+    }
+    length = append_json(body, size, length, "],\"brightness\":%u,\"scheduled\":%d", message->brightness, message->scheduled);
+    if (message->program_id >= 0) { length = append_json(body, size, length, ",\"program\":%d", message->program_id); }
+    length = append_json(body, size, length, "}");
+    return length;
+
+}
+
+
+/**
+ * @brief Publishes the current state to the event streams
+ * 
+ */
+void publish_state(void) {
+
+    static change_animation_message_t snapshot;
+    char body[sizeof(state_event)];
+
+    snapshot.status = 200;
+    snapshot_state(&snapshot);
+    write_state_json(body, sizeof(body), &snapshot);
+
+    portENTER_CRITICAL(&event_mux);
+    strcpy(state_event, body);
+    portEXIT_CRITICAL(&event_mux);
+    state_version.fetch_add(1, std::memory_order_release);
+
+}
+
+
+/**
+ * @brief Stages the current state for flash, the write itself
+ * waits until the changes go quiet
+ * 
+ */
+void save_state(void) {
+
+    persisted_state_t state;
+    memset(&state, 0, sizeof(state));
+    portENTER_CRITICAL(&state_mux);
+    state.animation_type = animation_type;
+    state.animation_speed = animation_speed;
+    state.active_rgb = active_rgb;
+    state.frame_rate = frame_rate;
+    state.program = active_program;
+    state.color_count = rgb_sequence_length;
+    memcpy(state.colors, rgb_sequence, rgb_sequence_length);
+    portEXIT_CRITICAL(&state_mux);
+    state.brightness = brightness;
+
+    persist_stage(&state, esp_timer_get_time());
+
+}
+
+
+/**
+ * @brief Restores the state saved before the last reboot,
+ * has to run before the outputs and the timer are set up
+ * 
+ */
+void restore_state(void) {
+
+    persisted_state_t state;
+    if (not persist_begin(&state)) {
+        printf("No saved state\n");
+        return;
+    }
+
+    /* a blob written by another firmware build may not fit */
+    if (state.animation_type >= ANIMATION_COUNT or state.animation_speed >= SPEED_COUNT or state.active_rgb > GREEN or
+        state.frame_rate == 0 or state.frame_rate > CONTROL_MAX_RATE or state.color_count == 0 or state.color_count > CONTROL_MAX_COLORS) {
+        printf("Saved state is invalid\n");
+        return;
+    }
+    for (int i = 0; i < state.color_count; i++) {
+        if (state.colors[i] > GREEN) {
+            printf("Saved state is invalid\n");
+            return;
         }
     }
 
+    animation_type = state.animation_type;
+    animation_speed = state.animation_speed;
+    frame_rate = state.frame_rate;
+    brightness = state.brightness;
+    rgb_sequence_length = state.color_count;
+    memcpy(rgb_sequence, state.colors, state.color_count);
+    active_rgb = state.active_rgb;
+    if (state.program >= 0 and state.program < PROGRAM_SLOTS) {
+        uint8_t program[PROGRAM_MAX_SIZE];
+        size_t length = persist_load_program(state.program, program, sizeof(program));
+        if (program_verify(program, length)) { select_program(state.program, program, length); }
+    }
+    /* the cycle goes on from the saved color */
+    rgb_sequence_index = rgb_sequence_length - 1;
+    for (int i = 0; i < rgb_sequence_length; i++) {
+        if (rgb_sequence[i] == active_rgb) { rgb_sequence_index = i; }
+    }
+    printf("Restored animation %s at %u.%03u fps\n", control_animation_names[animation_type],
+           (unsigned)(frame_rate / FRAME_RATE_SCALE), (unsigned)(frame_rate % FRAME_RATE_SCALE));
+
 }
 
 
 /**
- * @brief Handles animation speed/type changes, consumes queues
+ * @brief Handles animation speed/type changes, consumes the command ring.
+ * Never touches client sockets, so slow clients can't stall it
  * 
  * @param args 
  */
 void change_animation_state_task(void* args) {
 
+    TickType_t timeout = portMAX_DELAY;
+
     while (true) {
-        change_animation_message_t message;
-        if (animation_change_queue != NULL) {
-            if (xQueueReceive(animation_change_queue, &message, (TickType_t)100) == pdPASS) {
-                String string_message(message.res);
-                printf("Message: %s\n", string_message.c_str());
-                String response;
-
-                if (string_message == "/") { 
-                    goto construct_page;
-                }
-                /* speed change requests */
-                else if (string_message == "/speed_slow") { 
-                    animation_speed = SLOW_SPEED;
-                    esp_timer_stop(tick_timer_handle);
-                    esp_timer_start_periodic(tick_timer_handle, 1000000);
-                } else if (string_message == "/speed_medium") { 
-                    animation_speed = MEDIUM_SPEED;
-                    esp_timer_stop(tick_timer_handle);
-                    esp_timer_start_periodic(tick_timer_handle, 500000);
-                } else if (string_message == "/speed_high") { 
-                    animation_speed = HIGH_SPEED; 
-                    esp_timer_stop(tick_timer_handle);
-                    esp_timer_start_periodic(tick_timer_handle, 250000);
-                /* animation change requests */
-                } else if (string_message == "/animation_pump") { 
-                    animation_type = PUMP_ANIMATION; 
-                } else if (string_message == "/animation_worm") { 
-                    animation_type = WORM_ANIMATION; 
-                } else if (string_message == "/animation_snake") {
-                    animation_type = SNAKE_ANIMATION; 
-                } else if (string_message == "/animation_wave") { 
-                    animation_type = WAVE_ANIMATION; 
-                }
-                /* 404 */
-                else {
-                    printf("Reponse code: 404\n");
-                    response = page_404;
-                    goto print_page;
-                }
-construct_page:
-                printf("Reponse code: 200\n");
-                response += html_start;
-                if (animation_speed == SLOW_SPEED) { 
-                    response += "<a class=\"button on\" href=\"/speed_slow\">Slow</a>\n";
-                } else { 
-                    response += "<a class=\"button off\" href=\"/speed_slow\">Slow</a>\n";
-                }
-                if (animation_speed == MEDIUM_SPEED) { 
-                    response += "<a class=\"button on\" href=\"/speed_medium\">Medium</a>\n";
-                } else { 
-                    response += "<a class=\"button off\" href=\"/speed_medium\">Medium</a>\n";
-                }
-                response += second_row;
-                if (animation_speed == HIGH_SPEED) { 
-                    response += "<a class=\"button on\" href=\"/speed_high\">High</a>\n";
-                } else { 
-                    response += "<a class=\"button off\" href=\"/speed_high\">High</a>\n";
-                }
-                response += html_animation_buttons;
-                if (animation_type == PUMP_ANIMATION) { 
-                    response += "<a class=\"button on\" href=\"/animation_pump\">Pump</a>\n"; 
-                } else { 
-                    response += "<a class=\"button off\" href=\"/animation_pump\">Pump</a>\n"; 
-                }
-                if (animation_type == WORM_ANIMATION) { 
-                    response += "<a class=\"button on\" href=\"/animation_worm\">Worm</a>\n"; 
-                } else { 
-                    response += "<a class=\"button off\" href=\"/animation_worm\">Worm</a>\n"; 
-                }
-                response += second_row;
-                if (animation_type == SNAKE_ANIMATION) { 
-                    response += "<a class=\"button on\" href=\"/animation_snake\">Snake</a>\n"; 
-                } else { 
-                    response += "<a class=\"button off\" href=\"/animation_snake\">Snake</a>\n"; 
-                }
-                if (animation_type == WAVE_ANIMATION) { 
-                    response += "<a class=\"button on\" href=\"/animation_wave\">Wave</a>\n"; 
-                } else { 
-                    response += "<a class=\"button off\" href=\"/animation_wave\">Wave</a>\n"; 
-                }
-                response += html_end;
-print_page:
-                client.write(response.c_str());
-                /* release a semaphore */
-                xSemaphoreGive(semaphore_handle);
-            }
+        /* woken up by the client task after a push or by the next timed update */
+        ulTaskNotifyTake(pdTRUE, timeout);
+        timeout = apply_scheduled_updates();
+
+        change_animation_message_t* message;
+        while ((message = (change_animation_message_t*)command_ring_pop(&command_ring)) != NULL) {
+            metrics_record(METRICS_QUEUE_WAIT, esp_timer_get_time() - message->queued);
+            apply_animation_message(message);
+            message->handled.store(true, std::memory_order_release);
+        }
+        /* control requests may have added timed updates */
+        timeout = apply_scheduled_updates();
+        publish_state();
+
+        /* flash writes are coalesced, the task wakes up again when they are due */
+        save_state();
+        int64_t persist_wait = persist_poll(esp_timer_get_time());
+        if (persist_wait >= 0) {
+            TickType_t persist_timeout = pdMS_TO_TICKS((persist_wait + 999) / 1000) + 1;
+            if (persist_timeout < timeout) { timeout = persist_timeout; }
         }
     }
 
 }
 
 
+/* rendered status pages, indexed by speed and animation, empty until first use */
+String page_cache[SPEED_COUNT][ANIMATION_COUNT];
+
+
 /**
- * @brief Handles client connection, produces queues
+ * @brief Drops all rendered status pages, has to be called
+ * whenever animations or speeds are added
  * 
- * @param args 
  */
-void client_task(void* args) {
-    
-    while (true) {
+void page_cache_invalidate(void) {
+
+    for (int speed = 0; speed < SPEED_COUNT; speed++) {
+        for (int type = 0; type < ANIMATION_COUNT; type++) { page_cache[speed][type] = String(); }
+    }
+
+}
+
+
+/**
+ * @brief Renders the status page of a single state
+ * 
+ * @param response response buffer
+ * @param speed speed shown as active
+ * @param type animation shown as active
+ */
+void render_page(String& response, int speed, int type) {
+
+    String page;
+    page += html_start;
+    if (speed == SLOW_SPEED) { 
+        page += "<a class=\"button on\" href=\"/speed_slow\">Slow</a>\n";
+    } else { 
+        page += "<a class=\"button off\" href=\"/speed_slow\">Slow</a>\n";
+    }
+    if (speed == MEDIUM_SPEED) { 
+        page += "<a class=\"button on\" href=\"/speed_medium\">Medium</a>\n";
+    } else { 
+        page += "<a class=\"button off\" href=\"/speed_medium\">Medium</a>\n";
+    }
+    page += second_row;
+    if (speed == HIGH_SPEED) { 
+        page += "<a class=\"button on\" href=\"/speed_high\">High</a>\n";
+    } else { 
+        page += "<a class=\"button off\" href=\"/speed_high\">High</a>\n";
+    }
+    page += html_animation_buttons;
+    if (type == PUMP_ANIMATION) { 
+        page += "<a class=\"button on\" href=\"/animation_pump\">Pump</a>\n"; 
+    } else { 
+        page += "<a class=\"button off\" href=\"/animation_pump\">Pump</a>\n"; 
+    }
+    if (type == WORM_ANIMATION) { 
+        page += "<a class=\"button on\" href=\"/animation_worm\">Worm</a>\n"; 
+    } else { 
+        page += "<a class=\"button off\" href=\"/animation_worm\">Worm</a>\n"; 
+    }
+    page += second_row;
+    if (type == SNAKE_ANIMATION) { 
+        page += "<a class=\"button on\" href=\"/animation_snake\">Snake</a>\n"; 
+    } else { 
+        page += "<a class=\"button off\" href=\"/animation_snake\">Snake</a>\n"; 
+    }
+    if (type == WAVE_ANIMATION) { 
+        page += "<a class=\"button on\" href=\"/animation_wave\">Wave</a>\n"; 
+    } else { 
+        page += "<a class=\"button off\" href=\"/animation_wave\">Wave</a>\n"; 
+    }
+    page += html_end;
 
-        client = server.available();
-        if (not client) { continue; }
-
-        /* Wait for data from client to become available */
-        while (client.connected() and not client.available()) { delay(1); }
-
-        /* parse request */
-        String request = client.readStringUntil('\r');
-        int address_start = request.indexOf(' ');
-        int address_end = request.indexOf(' ', address_start + 1);
-        if (address_start == -1 || address_end == -1) { continue; }
-        request = request.substring(address_start + 1, address_end);
-        const char* _request = request.c_str();
-        printf("Request: %s\n", _request);
-
-        /* copy request to message structure */
-        change_animation_message_t message;
-        memset(&(message.res), 0, 20);
-        strncpy(message.res, _request, strlen(_request));
-        
-        /* send queue */
-        while (xQueueSend(animation_change_queue, (void *)&message, (TickType_t)100) != pdTRUE) {;}
-
-        /* wait for the queue processing to end */
-        if (xSemaphoreTake(semaphore_handle, portMAX_DELAY)) {
-            /* close the connection */
-            client.stop();
+    response = html_header;
+    response += page.length();
+    response += "\r\n\r\n";
+    response += page;
+
+}
+
+
+/**
+ * @brief Returns the response for a handled message, status pages
+ * are rendered once per state and served from the cache afterwards
+ * 
+ * @param message handled message
+ * @return response, stays valid until the cache is invalidated
+ */
+const String& write_response(const change_animation_message_t* message) {
+
+    static const String not_found = page_404;
+
+    if (message->status == 404) {
+        printf("Reponse code: 404\n");
+        return not_found;
+    }
+
+    printf("Reponse code: 200\n");
+    String& page = page_cache[message->animation_speed][message->animation_type];
+    if (page.length() == 0) { render_page(page, message->animation_speed, message->animation_type); }
+    return page;
+
+}
+
+
+/**
+ * @brief Clamps what snprintf wanted to write into connection->reply
+ * to what actually landed there
+ * 
+ */
+static size_t reply_length(int length) {
+
+    if (length < 0) { return 0; }
+    return (size_t)length < SERVER_REPLY_SIZE ? length : SERVER_REPLY_SIZE - 1;
+
+}
+
+
+/**
+ * @brief Writes the status document of a handled control request
+ * into the connection's reply buffer
+ * 
+ * @param connection client connection
+ */
+void write_control_response(connection_t* connection) {
+
+    const change_animation_message_t* message = &connection->message;
+    char body[STATE_JSON_MAX + 1];
+    int length = write_state_json(body, sizeof(body), message);
+
+    const char* status = "200 OK";
+    if (message->status == 400) { status = "400 Bad Request"; }
+    if (message->status == 404) { status = "404 Not Found"; }
+    if (message->status == 503) { status = "503 Service Unavailable"; }
+
+    printf("Reponse code: %d\n", message->status);
+    connection->response_length = reply_length(snprintf(connection->reply, SERVER_REPLY_SIZE,
+                                               "HTTP/1.1 %s\r\nContent-Type: application/json\r\nContent-Length: %d\r\n\r\n%s",
+                                               status, length, body));
+    connection->response = connection->reply;
+
+}
+
+
+#if STREAM_INPUT
+/* counters document with every counter at 10 digits */
+#define STREAM_JSON_MAX (sizeof("{\"received\":4294967295,\"shown\":4294967295,\"superseded\":4294967295," \
+                                "\"out_of_order\":4294967295,\"invalid\":4294967295}") - 1)
+
+static_assert(CONTROL_HEAD_MAX + STREAM_JSON_MAX < SERVER_REPLY_SIZE, "stream responses have to fit the reply buffer");
+
+/**
+ * @brief Writes the stream counters into the connection's reply buffer
+ * 
+ * @param connection client connection
+ */
+void write_stream_response(connection_t* connection) {
+
+    stream_stats_t stats;
+    stream_get_stats(&stats);
+
+    char body[STREAM_JSON_MAX + 1];
+    int length = snprintf(body, sizeof(body), "{\"received\":%u,\"shown\":%u,\"superseded\":%u,\"out_of_order\":%u,\"invalid\":%u}",
+                          (unsigned)stats.received, (unsigned)stats.shown, (unsigned)stats.superseded,
+                          (unsigned)stats.out_of_order, (unsigned)stats.invalid);
+
+    printf("Reponse code: 200\n");
+    connection->response_length = reply_length(snprintf(connection->reply, SERVER_REPLY_SIZE,
+                                               "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %d\r\n\r\n%s",
+                                               length, body));
+    connection->response = connection->reply;
+
+}
+#endif
+
+
+/**
+ * @brief Writes the next event of a stream into the connection's reply
+ * buffer, state changes first, then the last shown frame, frames shown
+ * in between are skipped
+ * 
+ * @param connection event stream
+ * @return length of the event, 0 when the viewer is up to date
+ */
+size_t write_event(connection_t* connection) {
+
+    uint32_t version = state_version.load(std::memory_order_acquire);
+    if (version != connection->event_cursor[0]) {
+        connection->event_cursor[0] = version;
+        portENTER_CRITICAL(&event_mux);
+        int length = snprintf(connection->reply, SERVER_REPLY_SIZE, "event: state\ndata: %s\n\n", state_event);
+        portEXIT_CRITICAL(&event_mux);
+        return reply_length(length);
+    }
+
+    uint32_t frame = shown_frame.load(std::memory_order_relaxed);
+    if (frame != connection->event_cursor[1]) {
+        connection->event_cursor[1] = frame;
+        return reply_length(snprintf(connection->reply, SERVER_REPLY_SIZE, "event: frame\ndata: {\"bars\":%u,\"rgb\":\"%s\"}\n\n",
+                                     (unsigned)((frame - 1) & FRAME_BAR_MASK), control_color_names[(frame - 1) >> 3]));
+    }
+    return 0;
+
+}
+
+
+/**
+ * @brief Renders the metrics into the shared metrics page, only one
+ * connection can be sending it at a time
+ * 
+ * @param connection client connection
+ */
+void write_metrics_response(connection_t* connection) {
+
+    if (metrics_reader != NULL and metrics_reader->state == CONNECTION_WRITING and metrics_reader->response != NULL and
+        metrics_reader->response >= metrics_page and metrics_reader->response < metrics_page + METRICS_PAGE_SIZE) {
+        printf("Reponse code: 503\n");
+        connection->response = service_unavailable;
+        connection->response_length = strlen(service_unavailable);
+        return;
+    }
+
+    char* body = metrics_page + METRICS_HEAD_SIZE;
+    size_t length = metrics_render(body, METRICS_PAGE_SIZE - METRICS_HEAD_SIZE);
+
+    char head[METRICS_HEAD_SIZE];
+    int head_length = snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %u\r\n\r\n",
+                               (unsigned)length);
+    memcpy(body - head_length, head, head_length);
+
+    printf("Reponse code: 200\n");
+    metrics_reader = connection;
+    connection->response = body - head_length;
+    connection->response_length = head_length + length;
+
+}
+
+
+/**
+ * @brief Serves embedded assets right away, hands any other path
+ * over to the state task with the connection's message
+ * 
+ * @param connection client connection
+ * @return true when the request was queued
+ */
+bool queue_request(connection_t* connection) {
+
+    const asset_t* asset = asset_find(connection->path);
+    if (asset != NULL) {
+        if (asset_not_modified(asset, connection->if_none_match)) {
+            printf("Reponse code: 304\n");
+            connection->response = (const char*)asset->not_modified_response;
+            connection->response_length = asset->not_modified_response_length;
+        } else if (connection->accepts_gzip) {
+            printf("Reponse code: 200\n");
+            connection->response = (const char*)asset->gzip_response;
+            connection->response_length = asset->gzip_response_length;
+        } else {
+            printf("Reponse code: 200\n");
+            connection->response = (const char*)asset->identity_response;
+            connection->response_length = asset->identity_response_length;
+        }
+        return false;
+    }
+    if (strcmp(connection->path, "/metrics") == 0) {
+        write_metrics_response(connection);
+        return false;
+    }
+
+    /* a HEAD gets the head of the GET response, prefetchers and probes must not change
+       the state or hold an event stream, so of the routes only the status page answers it */
+    route_args_t args;
+    const route_t* route = route_match(routes, ROUTE_COUNT, connection->path, &args);
+    if (connection->method != NULL and strcmp(connection->method, "HEAD") == 0 and
+        ((route != NULL and route->handler != &show_state) or strcmp(connection->path, "/events") == 0)) {
+        printf("Reponse code: 405\n");
+        connection->response = method_not_allowed;
+        connection->response_length = strlen(method_not_allowed);
+        return false;
+    }
+
+    if (strcmp(connection->path, "/events") == 0) {
+        if (not server_event_stream(connection)) {
+            printf("Reponse code: 503\n");
+            connection->response = service_unavailable;
+            connection->response_length = strlen(service_unavailable);
+            return false;
+        }
+        /* the first event is the current state */
+        printf("Reponse code: 200\n");
+        connection->event_cursor[0] = state_version.load(std::memory_order_acquire) - 1;
+        connection->event_cursor[1] = 0;
+        connection->response = event_stream_header;
+        connection->response_length = strlen(event_stream_header);
+        return false;
+    }
+#if STREAM_INPUT
+    if (strcmp(connection->path, "/stream") == 0) {
+        write_stream_response(connection);
+        return false;
+    }
+#endif
+
+    /* control payloads are parsed here, the state task gets them ready to apply */
+    change_animation_message_t* message = &connection->message;
+    if (route != NULL and route->handler == &apply_control_message) {
+        bool parsed = connection->binary_body ?
+            control_parse_binary(connection->body, connection->body_length, &message->control) :
+            control_parse_json((const char*)connection->body, connection->body_length, &message->control);
+        if (not parsed) {
+            printf("Reponse code: 400\n");
+            connection->response = bad_request;
+            connection->response_length = strlen(bad_request);
+            return false;
         }
+    }
 
+    message->program = NULL;
+    if (route != NULL and route->handler == &apply_program_message) {
+        /* uploads are verified before they reach the state task or the flash */
+        if (args.id >= PROGRAM_SLOTS or
+            (connection->content_length > 0 and not program_verify(connection->body, connection->body_length))) {
+            printf("Reponse code: 400\n");
+            connection->response = bad_request;
+            connection->response_length = strlen(bad_request);
+            return false;
+        }
+        if (connection->content_length > 0) {
+            message->program = connection->body;
+            message->program_length = connection->body_length;
+        }
     }
 
+    /* the path stays in the connection's line buffer until the response is built */
+    message->path = connection->path;
+
+    /* the ring holds more commands than there are connections */
+    message->queued = esp_timer_get_time();
+    command_ring_push(&command_ring, message);
+    xTaskNotifyGive(change_animation_state_task_handle);
+    return true;
+
+}
+
+
+/**
+ * @brief Builds the response once the state task handled the request
+ * 
+ * @param connection client connection
+ */
+void build_response(connection_t* connection) {
+
+    if (connection->message.response == ROUTE_JSON) {
+        write_control_response(connection);
+        return;
+    }
+
+    const String& response = write_response(&connection->message);
+    connection->response = response.c_str();
+    connection->response_length = response.length();
+
+}
+
+
+const server_handler_t request_handler = {
+    .request = &queue_request,
+    .respond = &build_response,
+    .event = &write_event
+};
+
+
+/**
+ * @brief Serves all client connections
+ * 
+ * @param args 
+ */
+void client_task(void* args) {
+    
+    server_run(&request_handler);
+
 }
 
 
@@ -413,17 +1242,54 @@ extern "C" void app_main(void) {
     gpio_set_direction(MIDDLE_LED, GPIO_MODE_OUTPUT);
     gpio_set_direction(LEFT_LED, GPIO_MODE_OUTPUT);
 
+    /* saved speed, animation and colors */
+    restore_state();
+
+    /* initialise frame output */
+#if PIXEL_OUTPUT
+    if (not pixel_strip_init(PIXEL_PIN, PIXEL_COUNT)) {
+        printf("Error setting up the pixel strip!\n");
+        while (true) { delay(1000); }
+    }
+    pixel_set_brightness(brightness);
+    frame_init(LED_PIN_MASK, &pixel_frame_backend);
+#elif PWM_OUTPUT
+    pwm_attach(RGB_LED_RED, PWM_RESOLUTION);
+    pwm_attach(RGB_LED_BLUE, PWM_RESOLUTION);
+    pwm_attach(RGB_LED_GREEN, PWM_RESOLUTION);
+    pwm_attach(RIGHT_LED, PWM_RESOLUTION);
+    pwm_attach(MIDDLE_LED, PWM_RESOLUTION);
+    pwm_attach(LEFT_LED, PWM_RESOLUTION);
+    pwm_set_fade_time(FRAME_CLOCK_ONE / frame_rate);
+    pwm_set_brightness(brightness);
+    frame_init(LED_PIN_MASK, &pwm_frame_backend);
+#else
+    frame_init(LED_PIN_MASK, &gpio_frame_backend);
+#endif
+
+#if SYNC_ROLE != SYNC_OFF
+    /* join the other controllers before the first frame */
+    if (not sync_begin()) {
+        printf("Error setting up frame sync!\n");
+        while (true) { delay(1000); }
+    }
+#endif
+#if STREAM_INPUT
+    if (not stream_begin()) {
+        printf("Error setting up the stream input!\n");
+        while (true) { delay(1000); }
+    }
+#endif
+
     /* initialise timer */
     set_and_start_tick_timer();
 
-    /* create queue */
-    animation_change_queue = xQueueCreate(1, sizeof(change_animation_message_t));
-
-    /* create semaphore */
-    semaphore_handle = xSemaphoreCreateBinary();
+    /* create command ring */
+    command_ring_init(&command_ring);
+    publish_state();
     
-    /* create tasks */
-    xTaskCreate(client_task, "client", STACK_SIZE, NULL, 0, &client_task_handle);
+    /* create tasks, the state task has to exist before connections are served */
     xTaskCreate(change_animation_state_task, "change the animation state", STACK_SIZE, NULL, 0, &change_animation_state_task_handle);
+    xTaskCreate(client_task, "client", SERVER_STACK_SIZE, NULL, 0, &client_task_handle);
 
 }
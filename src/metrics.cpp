@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <freertos/FreeRTOS.h>
+
+#include "metrics.h"
+
+struct metrics_histogram {
+    uint32_t buckets[METRICS_BUCKETS];
+    /* durations beyond the last bucket */
+    uint32_t overflow;
+    uint32_t count;
+    uint64_t sum;
+};
+
+typedef struct metrics_histogram metrics_histogram_t;
+
+struct metrics_description {
+    const char* name;
+    const char* help;
+};
+
+static const metrics_description histogram_descriptions[METRICS_HISTOGRAM_COUNT] = {
+    { "led_tick_lateness_seconds", "Delay of the tick behind its period." },
+    { "led_tick_duration_seconds", "Time spent in the tick." },
+    { "led_request_parse_seconds", "Time from the first byte of a request until it is complete." },
+    { "led_queue_wait_seconds", "Time a request waits in the command ring." },
+    { "led_response_write_seconds", "Time from the first until the last byte of a response." },
+};
+
+static const metrics_description counter_descriptions[METRICS_COUNTER_COUNT] = {
+    { "led_missed_ticks_total", "Tick periods skipped because the timer task fell behind." },
+    { "led_state_changes_total", "State changes staged for flash." },
+    { "led_flash_writes_total", "Writes of the state to flash." },
+};
+
+static metrics_histogram_t histograms[METRICS_HISTOGRAM_COUNT];
+static uint32_t counters[METRICS_COUNTER_COUNT];
+static portMUX_TYPE metrics_mux = portMUX_INITIALIZER_UNLOCKED;
+
+
+/**
+ * @brief Bucket of a duration, METRICS_BUCKETS when it is beyond the last one
+ * 
+ */
+static int bucket_of(uint32_t duration) {
+
+    if (duration < METRICS_LINEAR) { return duration; }
+
+    int exponent = 31 - __builtin_clz(duration);
+    if (exponent >= METRICS_MAX_EXPONENT) { return METRICS_BUCKETS; }
+    int sub_bucket = (duration >> (exponent - 2)) & (METRICS_SUB_BUCKETS - 1);
+    return METRICS_LINEAR + (exponent - METRICS_MIN_EXPONENT) * METRICS_SUB_BUCKETS + sub_bucket;
+
+}
+
+
+/**
+ * @brief Largest duration of a bucket in microseconds
+ * 
+ */
+static uint32_t bucket_bound(int bucket) {
+
+    if (bucket < METRICS_LINEAR) { return bucket; }
+
+    int exponent = METRICS_MIN_EXPONENT + (bucket - METRICS_LINEAR) / METRICS_SUB_BUCKETS;
+    int sub_bucket = (bucket - METRICS_LINEAR) % METRICS_SUB_BUCKETS;
+    return ((METRICS_SUB_BUCKETS + sub_bucket + 1) << (exponent - 2)) - 1;
+
+}
+
+
+void metrics_record(metrics_histogram_id histogram, int64_t duration) {
+
+    if (duration < 0) { duration = 0; }
+    int bucket = bucket_of(duration > UINT32_MAX ? UINT32_MAX : (uint32_t)duration);
+    metrics_histogram_t* target = &histograms[histogram];
+
+    portENTER_CRITICAL(&metrics_mux);
+    if (bucket < METRICS_BUCKETS) { target->buckets[bucket]++; }
+    else { target->overflow++; }
+    target->count++;
+    target->sum += duration;
+    portEXIT_CRITICAL(&metrics_mux);
+
+}
+
+
+void metrics_count(metrics_counter_id counter, uint32_t count) {
+
+    portENTER_CRITICAL(&metrics_mux);
+    counters[counter] += count;
+    portEXIT_CRITICAL(&metrics_mux);
+
+}
+
+
+/**
+ * @brief snprintf which keeps track of the remaining buffer, `length`
+ * passes `size` once something was cut off
+ * 
+ */
+#define APPEND(...) do {                                                        \
+        if (length < size) { length += snprintf(buffer + length, size - length, __VA_ARGS__); } \
+    } while (0)
+
+size_t metrics_render(char* buffer, size_t size) {
+
+    size_t length = 0;
+    if (size == 0) { return 0; }
+    buffer[0] = '\0';
+
+    /* counters first, a family that does not fit is left out as a whole,
+       scrapers reject a page ending in a partial line or histogram */
+    for (int i = 0; i < METRICS_COUNTER_COUNT; i++) {
+        portENTER_CRITICAL(&metrics_mux);
+        uint32_t count = counters[i];
+        portEXIT_CRITICAL(&metrics_mux);
+
+        const char* name = counter_descriptions[i].name;
+        size_t start = length;
+        APPEND("# HELP %s %s\n# TYPE %s counter\n%s %u\n", name, counter_descriptions[i].help, name, name, (unsigned)count);
+        if (length >= size) {
+            length = start;
+            buffer[length] = '\0';
+        }
+    }
+
+    for (int i = 0; i < METRICS_HISTOGRAM_COUNT; i++) {
+        /* copied out, so recording never waits on the formatting */
+        metrics_histogram_t histogram;
+        portENTER_CRITICAL(&metrics_mux);
+        memcpy(&histogram, &histograms[i], sizeof(histogram));
+        portEXIT_CRITICAL(&metrics_mux);
+
+        const char* name = histogram_descriptions[i].name;
+        size_t start = length;
+        APPEND("# HELP %s %s\n# TYPE %s histogram\n", name, histogram_descriptions[i].help, name);
+        uint32_t cumulative = 0;
+        for (int bucket = 0; bucket < METRICS_BUCKETS; bucket++) {
+            if (histogram.buckets[bucket] == 0) { continue; }
+            cumulative += histogram.buckets[bucket];
+            uint32_t bound = bucket_bound(bucket);
+            APPEND("%s_bucket{le=\"%u.%06u\"} %u\n", name, (unsigned)(bound / 1000000), (unsigned)(bound % 1000000), (unsigned)cumulative);
+        }
+        APPEND("%s_bucket{le=\"+Inf\"} %u\n", name, (unsigned)histogram.count);
+        APPEND("%s_sum %llu.%06u\n%s_count %u\n", name, (unsigned long long)(histogram.sum / 1000000),
+               (unsigned)(histogram.sum % 1000000), name, (unsigned)histogram.count);
+        if (length >= size) {
+            length = start;
+            buffer[length] = '\0';
+        }
+    }
+
+    return length;
+
+}
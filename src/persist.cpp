@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <Preferences.h>
+
+#include "metrics.h"
+#include "persist.h"
+
+static Preferences preferences;
+
+/* last written and staged state */
+static persisted_state_t persist_written;
+static persisted_state_t persist_staged;
+static int persist_changes = 0;
+static int64_t persist_last_change = 0;
+
+
+/**
+ * @brief Compares the fields worth a write
+ * 
+ */
+static bool same_state(const persisted_state_t* a, const persisted_state_t* b) {
+
+    return a->animation_type == b->animation_type and a->animation_speed == b->animation_speed and
+           a->brightness == b->brightness and a->frame_rate == b->frame_rate and a->program == b->program and
+           a->color_count == b->color_count and
+           memcmp(a->colors, b->colors, a->color_count) == 0;
+
+}
+
+
+bool persist_begin(persisted_state_t* state) {
+
+    if (not preferences.begin(PERSIST_NAMESPACE)) { return false; }
+
+    persisted_state_t stored;
+    if (preferences.getBytesLength(PERSIST_KEY) != sizeof(stored) or
+        preferences.getBytes(PERSIST_KEY, &stored, sizeof(stored)) != sizeof(stored) or
+        stored.version != PERSIST_VERSION) {
+        return false;
+    }
+
+    *state = stored;
+    persist_written = stored;
+    persist_staged = stored;
+    return true;
+
+}
+
+
+void persist_stage(const persisted_state_t* state, int64_t now) {
+
+    bool changed = not same_state(state, &persist_staged);
+    persist_staged = *state;
+    persist_staged.version = PERSIST_VERSION;
+    if (not changed) { return; }
+
+    metrics_count(METRICS_STATE_CHANGES, 1);
+    /* changing back before the write costs nothing */
+    if (same_state(&persist_staged, &persist_written)) {
+        persist_changes = 0;
+        return;
+    }
+    persist_changes++;
+    persist_last_change = now;
+
+}
+
+
+int64_t persist_poll(int64_t now) {
+
+    if (persist_changes == 0) { return -1; }
+
+    int64_t due = persist_last_change + PERSIST_QUIET_TIME;
+    if (now < due and persist_changes < PERSIST_MAX_CHANGES) { return due - now; }
+
+    /* one blob, so one nvs commit however many fields changed */
+    if (preferences.putBytes(PERSIST_KEY, &persist_staged, sizeof(persist_staged)) == sizeof(persist_staged)) {
+        metrics_count(METRICS_FLASH_WRITES, 1);
+    }
+    persist_written = persist_staged;
+    persist_changes = 0;
+    return -1;
+
+}
+
+
+bool persist_save_program(int id, const uint8_t* program, size_t length) {
+
+    char key[16];
+    snprintf(key, sizeof(key), PERSIST_PROGRAM_KEY "%d", id);
+    if (preferences.putBytes(key, program, length) != length) { return false; }
+    metrics_count(METRICS_FLASH_WRITES, 1);
+    return true;
+
+}
+
+
+size_t persist_load_program(int id, uint8_t* program, size_t size) {
+
+    char key[16];
+    snprintf(key, sizeof(key), PERSIST_PROGRAM_KEY "%d", id);
+    size_t length = preferences.getBytesLength(key);
+    if (length == 0 or length > size) { return 0; }
+    return preferences.getBytes(key, program, length);
+
+}
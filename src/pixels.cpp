@@ -0,0 +1,178 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "esp32-hal-rmt.h"
+
+#include "macros.h"
+#include "pixel_encoder.h"
+#include "pixels.h"
+
+static rmt_obj_t* pixel_rmt = NULL;
+static uint16_t pixel_count = 0;
+/* GRB frame being drawn */
+static uint8_t* pixel_data = NULL;
+/* encoded frames, one is sent while the other one is filled */
+static uint32_t* pixel_symbol_buffers[2] = { NULL, NULL };
+static int pixel_back = 0;
+/* time the frame on the wire is completely out (us) */
+static int64_t pixel_busy_until = 0;
+/* the back buffer holds a frame waiting for the wire, the timer sends it once the wire is free */
+static esp_timer_handle_t pixel_timer = NULL;
+static bool pixel_pending = false;
+static size_t pixel_pending_length = 0;
+static uint8_t pixel_brightness = 255;
+
+/* led levels, the pixel backend receives changes only */
+static uint32_t pixel_levels = 0;
+
+
+static void pixel_send_pending(void* arg);
+
+
+bool pixel_strip_init(gpio_num_t pin, uint16_t count) {
+
+    rmt_obj_t* rmt = rmtInit(pin, true, RMT_MEM_64);
+    if (rmt == NULL) { return false; }
+
+    size_t symbols = (size_t)count * PIXEL_BYTES * 8 + 1;
+    pixel_data = (uint8_t*)calloc(count, PIXEL_BYTES);
+    pixel_symbol_buffers[0] = (uint32_t*)malloc(symbols * sizeof(uint32_t));
+    pixel_symbol_buffers[1] = (uint32_t*)malloc(symbols * sizeof(uint32_t));
+    /* sends a frame that had to wait for the wire, runs in the esp_timer task like the tick */
+    const esp_timer_create_args_t timer_args = {
+        .callback = &pixel_send_pending,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "pixels",
+        .skip_unhandled_events = false
+    };
+    if (pixel_data == NULL or pixel_symbol_buffers[0] == NULL or pixel_symbol_buffers[1] == NULL or
+        esp_timer_create(&timer_args, &pixel_timer) != ESP_OK) {
+        free(pixel_data);
+        free(pixel_symbol_buffers[0]);
+        free(pixel_symbol_buffers[1]);
+        rmtDeinit(rmt);
+        return false;
+    }
+
+    rmtSetTick(rmt, PIXEL_TICK_NS);
+    pixel_rmt = rmt;
+
+    pixel_count = count;
+    return true;
+
+}
+
+
+void pixel_set(uint16_t index, uint8_t red, uint8_t green, uint8_t blue) {
+
+    if (index >= pixel_count) { return; }
+    uint8_t* pixel = pixel_data + index * PIXEL_BYTES;
+    pixel[0] = (green * pixel_brightness) / 255;
+    pixel[1] = (red * pixel_brightness) / 255;
+    pixel[2] = (blue * pixel_brightness) / 255;
+
+}
+
+
+void pixel_fill(uint16_t first, uint16_t count, uint8_t red, uint8_t green, uint8_t blue) {
+
+    for (uint16_t i = first; i < first + count and i < pixel_count; i++) {
+        pixel_set(i, red, green, blue);
+    }
+
+}
+
+
+void pixel_set_brightness(uint8_t brightness) {
+
+    pixel_brightness = brightness;
+
+}
+
+
+/**
+ * @brief Starts sending the back buffer, the hal does not report when
+ * it is out, so that is known from the length of the frame
+ * 
+ */
+static void pixel_send(size_t length) {
+
+    /* rmtWrite keeps feeding the channel from the buffer in the background */
+    rmtWrite(pixel_rmt, (rmt_data_t*)pixel_symbol_buffers[pixel_back], length);
+    pixel_busy_until = esp_timer_get_time() +
+                       ((int64_t)(length - 1) * PIXEL_BIT_NS + PIXEL_RESET * PIXEL_TICK_NS + 999) / 1000;
+
+    pixel_back ^= 1;
+
+}
+
+
+static void pixel_send_pending(void* arg) {
+
+    if (not pixel_pending) { return; }
+    pixel_pending = false;
+    pixel_send(pixel_pending_length);
+
+}
+
+
+void pixel_show(void) {
+
+    if (pixel_rmt == NULL) { return; }
+
+    /* the back buffer is free, it was sent two frames ago or holds a frame still waiting */
+    uint32_t* symbols = pixel_symbol_buffers[pixel_back];
+    size_t length = pixel_encode(pixel_data, (size_t)pixel_count * PIXEL_BYTES, symbols);
+
+    int64_t wait = pixel_busy_until - esp_timer_get_time();
+    if (wait <= 0) {
+        if (pixel_pending) {
+            esp_timer_stop(pixel_timer);
+            pixel_pending = false;
+        }
+        pixel_send(length);
+        return;
+    }
+
+    /* the previous frame is still on the wire, this one goes out right after it
+       unless a newer frame replaces it first, the caller does not wait */
+    pixel_pending_length = length;
+    if (not pixel_pending) {
+        pixel_pending = true;
+        esp_timer_start_once(pixel_timer, wait);
+    }
+
+}
+
+
+static void pixel_frame_write(uint32_t set_mask, uint32_t clear_mask) {
+
+    pixel_levels = (pixel_levels | set_mask) & ~clear_mask;
+
+    /* bars take the color of the rgb led, white while it is dark */
+    uint8_t red = (pixel_levels & (1UL << RGB_LED_RED)) ? 255 : 0;
+    uint8_t green = (pixel_levels & (1UL << RGB_LED_GREEN)) ? 255 : 0;
+    uint8_t blue = (pixel_levels & (1UL << RGB_LED_BLUE)) ? 255 : 0;
+    if (not (red or green or blue)) { red = green = blue = 255; }
+
+    const gpio_num_t bars[] = { LEFT_LED, MIDDLE_LED, RIGHT_LED };
+    uint16_t segment = pixel_count / 3;
+    for (int i = 0; i < 3; i++) {
+        /* the last bar takes the remainder */
+        uint16_t length = (i == 2) ? pixel_count - 2 * segment : segment;
+        if (pixel_levels & (1UL << bars[i])) {
+            pixel_fill(i * segment, length, red, green, blue);
+        } else {
+            pixel_fill(i * segment, length, 0, 0, 0);
+        }
+    }
+
+    pixel_show();
+
+}
+
+const frame_backend_t pixel_frame_backend = {
+    .write = &pixel_frame_write
+};
@@ -0,0 +1,122 @@
+#include "macros.h"
+#include "program.h"
+
+
+bool program_verify(const uint8_t* program, size_t length) {
+
+    if (length <= PROGRAM_HEADER_SIZE or length > PROGRAM_MAX_SIZE or
+        program[0] != 'L' or program[1] != 'P' or program[2] != PROGRAM_VERSION) {
+        return false;
+    }
+
+    /* frames shown so far by every open loop, the outermost level is the program itself */
+    int depth = 0;
+    bool shows_frame[PROGRAM_MAX_DEPTH + 1] = { false };
+
+    size_t pc = PROGRAM_HEADER_SIZE;
+    while (pc < length) {
+        uint8_t opcode = program[pc];
+        bool has_operand = opcode == PROGRAM_FRAME or opcode == PROGRAM_LOOP or opcode == PROGRAM_COLOR or opcode == PROGRAM_FADE;
+        if (has_operand and pc + 1 >= length) { return false; }
+        uint8_t operand = has_operand ? program[pc + 1] : 0;
+
+        switch (opcode) {
+            case PROGRAM_FRAME:
+                if (operand & ~(FRAME_BAR_MASK | FRAME_RGB_MASK)) { return false; }
+                for (int i = 0; i <= depth; i++) { shows_frame[i] = true; }
+                break;
+            case PROGRAM_LOOP:
+                if (operand == 0 or depth == PROGRAM_MAX_DEPTH) { return false; }
+                depth++;
+                shows_frame[depth] = false;
+                break;
+            case PROGRAM_END:
+                /* a loop without a frame would spin through the budget every tick */
+                if (depth == 0 or not shows_frame[depth]) { return false; }
+                depth--;
+                break;
+            case PROGRAM_COLOR:
+                if (operand > GREEN) { return false; }
+                break;
+            case PROGRAM_RANDOM:
+                break;
+            case PROGRAM_FADE:
+                if (operand > 1) { return false; }
+                break;
+            default:
+                return false;
+        }
+        pc += has_operand ? 2 : 1;
+    }
+
+    return depth == 0 and shows_frame[0];
+
+}
+
+
+void program_start(program_state_t* state, uint32_t seed) {
+
+    state->pc = PROGRAM_HEADER_SIZE;
+    state->depth = 0;
+    state->random = seed ? seed : 1;
+
+}
+
+
+bool program_step(const uint8_t* program, size_t length, program_state_t* state, uint8_t color_count,
+                  program_frame_t* frame, int* executed) {
+
+    frame->color = -1;
+    frame->sequence_index = -1;
+    frame->fade = -1;
+
+    for (int budget = 0; budget < PROGRAM_BUDGET; budget++) {
+        if (state->pc >= length) { state->pc = PROGRAM_HEADER_SIZE; }
+        uint8_t opcode = program[state->pc];
+        /* single byte instructions may end the program */
+        uint8_t operand = ((size_t)state->pc + 1 < length) ? program[state->pc + 1] : 0;
+
+        switch (opcode) {
+            case PROGRAM_FRAME:
+                frame->frame = operand;
+                state->pc += 2;
+                if (executed != NULL) { *executed = budget + 1; }
+                return true;
+            case PROGRAM_LOOP:
+                state->pc += 2;
+                state->loop_start[state->depth] = state->pc;
+                state->loop_left[state->depth] = operand;
+                state->depth++;
+                break;
+            case PROGRAM_END:
+                state->pc += 1;
+                if (--state->loop_left[state->depth - 1] != 0) {
+                    state->pc = state->loop_start[state->depth - 1];
+                } else {
+                    state->depth--;
+                }
+                break;
+            case PROGRAM_COLOR:
+                frame->color = operand;
+                frame->sequence_index = -1;
+                state->pc += 2;
+                break;
+            case PROGRAM_RANDOM:
+                state->random ^= state->random << 13;
+                state->random ^= state->random >> 17;
+                state->random ^= state->random << 5;
+                frame->sequence_index = color_count ? state->random % color_count : -1;
+                frame->color = -1;
+                state->pc += 1;
+                break;
+            case PROGRAM_FADE:
+                frame->fade = operand;
+                state->pc += 2;
+                break;
+        }
+    }
+
+    if (executed != NULL) { *executed = PROGRAM_BUDGET; }
+    return false;
+
+}
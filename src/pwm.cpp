@@ -0,0 +1,208 @@
+#include <math.h>
+
+#include <freertos/FreeRTOS.h>
+
+#include "esp_timer.h"
+#include "esp32-hal-ledc.h"
+
+#include "pwm.h"
+
+/* crossfade progress is a Q16 fraction */
+#define FADE_ONE (1UL << 16)
+
+/* gamma of the lookup table */
+#define PWM_GAMMA 2.2f
+
+struct pwm_channel {
+    gpio_num_t pin;
+    uint8_t channel;
+    uint8_t resolution;
+    uint8_t from;       /* level at the start of the crossfade */
+    uint8_t to;         /* level of the committed frame */
+    uint32_t duty;      /* last written duty */
+};
+
+typedef struct pwm_channel pwm_channel_t;
+
+static pwm_channel_t pwm_channels[PWM_MAX_CHANNELS];
+static uint8_t pwm_channel_count = 0;
+
+/* perceived level (0-255) -> 16 bit duty, shifted down to the channel resolution */
+static uint16_t gamma_table[256];
+
+/* crossfade state, only the tick writes duties, the state task sets the fade time and brightness */
+static uint32_t fade_progress = FADE_ONE;
+static int64_t fade_start = 0;
+static uint64_t fade_time = 0;
+static uint8_t pwm_brightness = 255;
+static bool brightness_changed = false;
+static portMUX_TYPE fade_mux = portMUX_INITIALIZER_UNLOCKED;
+
+
+static void build_gamma_table(void) {
+
+    for (int level = 0; level < 256; level++) {
+        gamma_table[level] = (uint16_t)(powf(level / 255.0f, PWM_GAMMA) * 65535.0f + 0.5f);
+    }
+
+}
+
+
+/**
+ * @brief Linear interpolation of a single level, `progress` is Q16
+ * 
+ */
+static inline uint8_t interpolate(uint8_t from, uint8_t to, uint32_t progress) {
+
+    return (uint8_t)(from + (((int32_t)to - (int32_t)from) * (int32_t)progress >> 16));
+
+}
+
+
+static inline uint32_t level_to_duty(uint8_t level, uint8_t resolution) {
+
+    return gamma_table[(level * pwm_brightness) / 255] >> (16 - resolution);
+
+}
+
+
+/**
+ * @brief Writes duties of all channels at the given crossfade progress,
+ * LEDC is only touched for channels whose duty changed
+ * 
+ */
+static void update_duties(uint32_t progress) {
+
+    for (int i = 0; i < pwm_channel_count; i++) {
+        pwm_channel_t* channel = &pwm_channels[i];
+        uint32_t duty = level_to_duty(interpolate(channel->from, channel->to, progress), channel->resolution);
+        if (duty != channel->duty) {
+            ledcWrite(channel->channel, duty);
+            channel->duty = duty;
+        }
+    }
+
+}
+
+
+void pwm_fade(int64_t now) {
+
+    portENTER_CRITICAL(&fade_mux);
+    bool fading = fade_progress < FADE_ONE;
+    if (fading) {
+        uint64_t elapsed = now > fade_start ? now - fade_start : 0;
+        fade_progress = elapsed >= fade_time ? FADE_ONE : (uint32_t)((elapsed << 16) / fade_time);
+    }
+    uint32_t progress = fade_progress;
+    bool update = fading or brightness_changed;
+    brightness_changed = false;
+    portEXIT_CRITICAL(&fade_mux);
+
+    if (update) { update_duties(progress); }
+
+}
+
+
+static void pwm_frame_write(uint32_t set_mask, uint32_t clear_mask) {
+
+    int64_t now = esp_timer_get_time();
+
+    /* start from wherever the previous crossfade got */
+    for (int i = 0; i < pwm_channel_count; i++) {
+        pwm_channel_t* channel = &pwm_channels[i];
+        channel->from = interpolate(channel->from, channel->to, fade_progress);
+        if (set_mask & (1UL << channel->pin)) { channel->to = 255; }
+        else if (clear_mask & (1UL << channel->pin)) { channel->to = 0; }
+    }
+
+    portENTER_CRITICAL(&fade_mux);
+    fade_start = now;
+    fade_progress = (fade_time == 0) ? FADE_ONE : 0;
+    uint32_t progress = fade_progress;
+    brightness_changed = false;
+    portEXIT_CRITICAL(&fade_mux);
+
+    update_duties(progress);
+
+}
+
+const frame_backend_t pwm_frame_backend = {
+    .write = &pwm_frame_write
+};
+
+
+bool pwm_attach(gpio_num_t pin, uint8_t resolution) {
+
+    if (pwm_channel_count >= PWM_MAX_CHANNELS) { return false; }
+
+    if (pwm_channel_count == 0) { build_gamma_table(); }
+
+    if (resolution < PWM_MIN_RESOLUTION) { resolution = PWM_MIN_RESOLUTION; }
+    if (resolution > PWM_MAX_RESOLUTION) { resolution = PWM_MAX_RESOLUTION; }
+
+    /* even channels only, odd ones would share the LEDC timer */
+    pwm_channel_t* channel = &pwm_channels[pwm_channel_count];
+    channel->pin = pin;
+    channel->channel = pwm_channel_count * 2;
+    channel->resolution = resolution;
+    channel->from = 0;
+    channel->to = 0;
+    channel->duty = 0;
+
+    ledcSetup(channel->channel, PWM_FREQUENCY, resolution);
+    ledcAttachPin(pin, channel->channel);
+    ledcWrite(channel->channel, 0);
+
+    pwm_channel_count++;
+    return true;
+
+}
+
+
+void pwm_detach_all(void) {
+
+    for (int i = 0; i < pwm_channel_count; i++) {
+        ledcDetachPin(pwm_channels[i].pin);
+    }
+    pwm_channel_count = 0;
+
+}
+
+
+void pwm_set_fade_time(uint64_t time) {
+
+    portENTER_CRITICAL(&fade_mux);
+    fade_time = time;
+    portEXIT_CRITICAL(&fade_mux);
+
+}
+
+
+void pwm_set_brightness(uint8_t brightness) {
+
+    /* applied by the next pwm_fade, so duties are only ever written from the tick */
+    portENTER_CRITICAL(&fade_mux);
+    pwm_brightness = brightness;
+    brightness_changed = true;
+    portEXIT_CRITICAL(&fade_mux);
+
+}
+
+
+void pwm_set_level(gpio_num_t pin, uint8_t level) {
+
+    for (int i = 0; i < pwm_channel_count; i++) {
+        pwm_channel_t* channel = &pwm_channels[i];
+        if (channel->pin != pin) { continue; }
+
+        channel->from = level;
+        channel->to = level;
+
+        uint32_t duty = level_to_duty(level, channel->resolution);
+        if (duty != channel->duty) {
+            ledcWrite(channel->channel, duty);
+            channel->duty = duty;
+        }
+    }
+
+}
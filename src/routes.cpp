@@ -0,0 +1,104 @@
+#include <string.h>
+
+#include "routes.h"
+
+/* longest id or query number, keeps the parse from overflowing */
+#define ROUTE_MAX_DIGITS    8
+
+
+/**
+ * @brief Splits a request path into route name, id and query
+ * 
+ * @return length of the route name at the start of the path, 0 when the id is too long
+ */
+static size_t route_split(const char* path, route_args_t* args) {
+
+    size_t length = 0;
+    while (path[length] != '\0' and path[length] != '?') { length++; }
+    args->query = path[length] == '?' ? path + length + 1 : path + length;
+    args->id = -1;
+
+    /* a numeric last segment is the id, the name keeps the '/' in front of it */
+    size_t segment = length;
+    while (segment > 0 and path[segment - 1] >= '0' and path[segment - 1] <= '9') { segment--; }
+    if (segment < length and segment > 1 and path[segment - 1] == '/') {
+        if (length - segment > ROUTE_MAX_DIGITS) { return 0; }
+        args->id = 0;
+        for (size_t i = segment; i < length; i++) { args->id = args->id * 10 + (path[i] - '0'); }
+        length = segment;
+    }
+    return length;
+
+}
+
+
+/**
+ * @brief Orders a route name against the first `length` characters of a path
+ * 
+ */
+static int route_order(const char* path, size_t length, const char* name) {
+
+    for (size_t i = 0; i < length; i++) {
+        if (path[i] != name[i]) { return (unsigned char)path[i] - (unsigned char)name[i]; }
+    }
+    return name[length] == '\0' ? 0 : -1;
+
+}
+
+
+const route_t* route_match(const route_t* routes, size_t count, const char* path, route_args_t* args) {
+
+    size_t length = route_split(path, args);
+    if (length == 0 or length >= ROUTE_NAME_SIZE) { return NULL; }
+
+    /* binary search, the table is sorted by name */
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        int order = route_order(path, length, routes[middle].name);
+        if (order == 0) {
+            /* routes taking an id need one, the others must not get one */
+            bool takes_id = length > 1 and path[length - 1] == '/';
+            if (takes_id != (args->id >= 0)) { return NULL; }
+            args->value = routes[middle].value;
+            return &routes[middle];
+        }
+        if (order < 0) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return NULL;
+
+}
+
+
+bool route_query_long(const char* query, const char* key, long* value) {
+
+    size_t key_length = strlen(key);
+    while (*query != '\0') {
+        if (strncmp(query, key, key_length) == 0 and query[key_length] == '=') {
+            const char* digit = query + key_length + 1;
+            bool negative = *digit == '-';
+            if (negative) { digit++; }
+            if (*digit < '0' or *digit > '9') { return false; }
+
+            long parsed = 0;
+            for (int digits = 0; *digit >= '0' and *digit <= '9'; digits++) {
+                if (digits == ROUTE_MAX_DIGITS) { return false; }
+                parsed = parsed * 10 + (*digit++ - '0');
+            }
+            if (*digit != '\0' and *digit != '&') { return false; }
+            *value = negative ? -parsed : parsed;
+            return true;
+        }
+
+        const char* next = strchr(query, '&');
+        if (next == NULL) { break; }
+        query = next + 1;
+    }
+    return false;
+
+}
@@ -0,0 +1,554 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "lwip/sockets.h"
+#include "esp_timer.h"
+
+#include "metrics.h"
+#include "server.h"
+
+/* listening socket */
+static int server_fd = -1;
+
+static connection_t connections[SERVER_MAX_CONNECTIONS];
+
+static const char payload_too_large[] = "HTTP/1.1 413 Payload Too Large\r\nContent-Length: 0\r\n\r\n";
+static const char uri_too_long[] = "HTTP/1.1 414 URI Too Long\r\nContent-Length: 0\r\n\r\n";
+static const char malformed_request[] = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n";
+
+
+bool server_begin(uint16_t port) {
+
+    for (int i = 0; i < SERVER_MAX_CONNECTIONS; i++) {
+        connections[i].fd = -1;
+        connections[i].state = CONNECTION_CLOSED;
+    }
+
+    server_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (server_fd < 0) { return false; }
+
+    int enable = 1;
+    setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    if (bind(server_fd, (struct sockaddr*)&address, sizeof(address)) < 0 or
+        listen(server_fd, SERVER_MAX_CONNECTIONS) < 0) {
+        close(server_fd);
+        server_fd = -1;
+        return false;
+    }
+    fcntl(server_fd, F_SETFL, O_NONBLOCK);
+    return true;
+
+}
+
+
+static void close_connection(connection_t* connection) {
+
+    close(connection->fd);
+    connection->fd = -1;
+    connection->state = CONNECTION_CLOSED;
+
+}
+
+
+/**
+ * @brief Resets the parsed request, bytes of pipelined
+ * requests already in the line buffer are kept
+ * 
+ */
+static void start_request(connection_t* connection) {
+
+    /* the previous request line is done with, whatever follows it moves to the front */
+    connection->line_length -= connection->head_length;
+    memmove(connection->line, connection->line + connection->head_length, connection->line_length + 1);
+    connection->head_length = 0;
+
+    connection->state = CONNECTION_READING;
+    connection->skip_line = false;
+    connection->method = NULL;
+    connection->path = NULL;
+    connection->path_length = 0;
+    connection->keep_alive = true;
+    connection->accepts_gzip = false;
+    connection->binary_body = false;
+    connection->if_none_match[0] = '\0';
+    connection->content_length = 0;
+    connection->request_start = 0;
+    connection->write_start = 0;
+
+}
+
+
+static void accept_connection(int64_t now) {
+
+    int fd = accept(server_fd, NULL, NULL);
+    if (fd < 0) { return; }
+
+    for (int i = 0; i < SERVER_MAX_CONNECTIONS; i++) {
+        connection_t* connection = &connections[i];
+        if (connection->state != CONNECTION_CLOSED) { continue; }
+
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        connection->fd = fd;
+        connection->last_activity = now;
+        connection->line[0] = '\0';
+        connection->line_length = 0;
+        connection->head_length = 0;
+        connection->requests = 0;
+        connection->event_stream = false;
+        start_request(connection);
+        return;
+    }
+
+    /* listening socket is only polled while a slot is free */
+    close(fd);
+
+}
+
+
+int server_parse_request_line(char* line, size_t length, server_request_line_t* request) {
+
+    if (length >= SERVER_REQUEST_LINE_SIZE) { return 414; }
+
+    /* method, upper case letters only */
+    size_t method_length = 0;
+    while (method_length < length and line[method_length] >= 'A' and line[method_length] <= 'Z') { method_length++; }
+    if (method_length == 0 or method_length >= SERVER_METHOD_SIZE or method_length == length or line[method_length] != ' ') {
+        return 400;
+    }
+
+    /* origin form path, no spaces or control characters */
+    char* path = line + method_length + 1;
+    size_t path_length = 0;
+    size_t rest = length - method_length - 1;
+    while (path_length < rest and (unsigned char)path[path_length] > ' ' and path[path_length] != 0x7f) { path_length++; }
+    if (path_length == 0 or path[0] != '/' or path_length == rest or path[path_length] != ' ') { return 400; }
+    if (path_length >= SERVER_PATH_SIZE) { return 414; }
+
+    const char* version = path + path_length + 1;
+    size_t version_length = rest - path_length - 1;
+    if (version_length != 8 or strncmp(version, "HTTP/1.", 7) != 0 or (version[7] != '0' and version[7] != '1')) { return 400; }
+
+    line[method_length] = '\0';
+    path[path_length] = '\0';
+    request->method = line;
+    request->method_length = method_length;
+    request->path = path;
+    request->path_length = path_length;
+    request->http11 = version[7] == '1';
+    return 200;
+
+}
+
+
+/**
+ * @brief Handles one header line of the request head
+ * 
+ * @return false when the request is malformed
+ */
+static bool parse_header(connection_t* connection, char* line) {
+
+    /* headers, only the ones picking the response are kept */
+    if (strncasecmp(line, "Accept-Encoding:", 16) == 0) {
+        connection->accepts_gzip = strstr(line + 16, "gzip") != NULL;
+    } else if (strncasecmp(line, "If-None-Match:", 14) == 0) {
+        char* value = line + 14;
+        while (*value == ' ') { value++; }
+        strncpy(connection->if_none_match, value, SERVER_ETAG_SIZE - 1);
+        connection->if_none_match[SERVER_ETAG_SIZE - 1] = '\0';
+    } else if (strncasecmp(line, "Content-Length:", 15) == 0) {
+        char* end;
+        unsigned long length = strtoul(line + 15, &end, 10);
+        if (end == line + 15) { return false; }
+        connection->content_length = length;
+    } else if (strncasecmp(line, "Connection:", 11) == 0) {
+        char* value = line + 11;
+        while (*value == ' ') { value++; }
+        if (strncasecmp(value, "close", 5) == 0) { connection->keep_alive = false; }
+        if (strncasecmp(value, "keep-alive", 10) == 0) { connection->keep_alive = true; }
+    } else if (strncasecmp(line, "Content-Type:", 13) == 0) {
+        connection->binary_body = strstr(line + 13, "application/octet-stream") != NULL;
+    }
+    return true;
+
+}
+
+
+/**
+ * @brief Starts sending the response the handler set up, a HEAD
+ * request gets the head of it only
+ * 
+ */
+static void start_response(connection_t* connection) {
+
+    if (connection->method != NULL and strcmp(connection->method, "HEAD") == 0) {
+        const char* end = (const char*)memmem(connection->response, connection->response_length, "\r\n\r\n", 4);
+        if (end != NULL) { connection->response_length = end + 4 - connection->response; }
+        /* no body, so no events either */
+        connection->event_stream = false;
+    }
+    connection->response_offset = 0;
+    connection->state = CONNECTION_WRITING;
+
+}
+
+
+/**
+ * @brief Hands a complete request over to the handler
+ * 
+ */
+static void dispatch_request(connection_t* connection, const server_handler_t* handler) {
+
+    metrics_record(METRICS_REQUEST_PARSE, esp_timer_get_time() - connection->request_start);
+    connection->message.handled.store(false, std::memory_order_relaxed);
+    connection->response_offset = 0;
+    if (handler->request(connection)) {
+        connection->state = CONNECTION_PENDING;
+        return;
+    }
+    start_response(connection);
+
+}
+
+
+/**
+ * @brief Answers a request the handler never sees, the connection
+ * closes afterwards since the rest of the request is unread
+ * 
+ */
+static void reject_request(connection_t* connection, const char* response, size_t length) {
+
+    printf("Reponse code: %.3s\n", response + 9);
+    connection->response = response;
+    connection->response_length = length;
+    connection->keep_alive = false;
+    start_response(connection);
+
+}
+
+
+/**
+ * @brief Moves the part of the body received with the head
+ * into the body buffer, dispatches the request once it is complete
+ * 
+ */
+static void finish_head(connection_t* connection, const server_handler_t* handler) {
+
+    if (connection->content_length > SERVER_BODY_SIZE) {
+        /* the unread body would be taken for the next request */
+        reject_request(connection, payload_too_large, sizeof(payload_too_large) - 1);
+        return;
+    }
+
+    char* received = connection->line + connection->head_length;
+    size_t buffered = connection->line_length - connection->head_length;
+    connection->body_length = buffered < connection->content_length ? buffered : connection->content_length;
+    memcpy(connection->body, received, connection->body_length);
+    /* anything behind the body belongs to the next request */
+    connection->line_length -= connection->body_length;
+    memmove(received, received + connection->body_length, buffered - connection->body_length + 1);
+
+    if (connection->body_length < connection->content_length) {
+        connection->state = CONNECTION_READING_BODY;
+        return;
+    }
+    dispatch_request(connection, handler);
+
+}
+
+
+static void read_body(connection_t* connection, const server_handler_t* handler, int64_t now) {
+
+    int received = recv(connection->fd, connection->body + connection->body_length,
+                        connection->content_length - connection->body_length, 0);
+    if (received < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) { return; }
+    if (received <= 0) {
+        close_connection(connection);
+        return;
+    }
+
+    connection->body_length += received;
+    connection->last_activity = now;
+    if (connection->body_length == connection->content_length) { dispatch_request(connection, handler); }
+
+}
+
+
+/**
+ * @brief Parses the complete lines in the line buffer, the request line
+ * stays in front of it for the method and path views
+ * 
+ */
+static void parse_head(connection_t* connection, const server_handler_t* handler) {
+
+    char* buffer = connection->line + connection->head_length;
+    char* line_end;
+    while ((line_end = strchr(buffer, '\n')) != NULL) {
+        size_t consumed = line_end - buffer + 1;
+        if (line_end > buffer and line_end[-1] == '\r') { line_end--; }
+        *line_end = '\0';
+
+        if (connection->skip_line) {
+            connection->skip_line = false;
+        } else if (connection->path == NULL and buffer[0] == '\0') {
+            /* empty lines ahead of the request line are ignored, RFC 9112 2.2 */
+        } else if (connection->path == NULL) {
+            server_request_line_t request;
+            int status = server_parse_request_line(buffer, line_end - buffer, &request);
+            if (status == 414) {
+                reject_request(connection, uri_too_long, sizeof(uri_too_long) - 1);
+                return;
+            }
+            if (status != 200) {
+                reject_request(connection, malformed_request, sizeof(malformed_request) - 1);
+                return;
+            }
+            connection->method = request.method;
+            connection->path = request.path;
+            connection->path_length = request.path_length;
+            /* HTTP/1.0 clients have to ask for a persistent connection */
+            if (not request.http11) { connection->keep_alive = false; }
+            printf("Request: %s\n", connection->path);
+
+            connection->head_length += consumed;
+            buffer += consumed;
+            continue;
+        } else if (buffer[0] == '\0') {
+            /* empty line ends the head, whatever follows is body */
+            connection->line_length -= consumed;
+            memmove(buffer, buffer + consumed, connection->line_length - connection->head_length + 1);
+            finish_head(connection, handler);
+            return;
+        } else if (not parse_header(connection, buffer)) {
+            reject_request(connection, malformed_request, sizeof(malformed_request) - 1);
+            return;
+        }
+
+        connection->line_length -= consumed;
+        memmove(buffer, buffer + consumed, connection->line_length - connection->head_length + 1);
+    }
+
+    /* line does not fit, a request line is answered, a header line is dropped */
+    if (connection->path == NULL and connection->line_length >= SERVER_REQUEST_LINE_SIZE) {
+        reject_request(connection, uri_too_long, sizeof(uri_too_long) - 1);
+        return;
+    }
+    if (connection->line_length == SERVER_LINE_SIZE - 1) {
+        connection->skip_line = true;
+        connection->line_length = connection->head_length;
+        connection->line[connection->line_length] = '\0';
+    }
+
+}
+
+
+static void read_connection(connection_t* connection, const server_handler_t* handler, int64_t now) {
+
+    int received = recv(connection->fd, connection->line + connection->line_length,
+                        SERVER_LINE_SIZE - 1 - connection->line_length, 0);
+    if (received < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) { return; }
+    if (received <= 0) {
+        close_connection(connection);
+        return;
+    }
+
+    if (connection->request_start == 0) { connection->request_start = now; }
+    connection->line_length += received;
+    connection->last_activity = now;
+    connection->line[connection->line_length] = '\0';
+    parse_head(connection, handler);
+
+}
+
+
+static void write_connection(connection_t* connection, const server_handler_t* handler, int64_t now) {
+
+    size_t length = connection->response_length;
+    if (connection->write_start == 0) { connection->write_start = now; }
+    int sent = send(connection->fd, connection->response + connection->response_offset,
+                    length - connection->response_offset, 0);
+    if (sent < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) { return; }
+    if (sent < 0) {
+        close_connection(connection);
+        return;
+    }
+
+    connection->response_offset += sent;
+    connection->last_activity = now;
+    if (connection->response_offset < length) { return; }
+    metrics_record(METRICS_RESPONSE_WRITE, now - connection->write_start);
+    connection->write_start = 0;
+
+    /* event streams only ever send */
+    if (connection->event_stream) {
+        connection->state = CONNECTION_EVENTS;
+        return;
+    }
+
+    connection->requests++;
+    if (not connection->keep_alive or connection->requests == SERVER_MAX_REQUESTS) {
+        close_connection(connection);
+        return;
+    }
+    /* pipelined requests may already wait in the line buffer */
+    start_request(connection);
+    if (connection->line_length != 0) { connection->request_start = now; }
+    parse_head(connection, handler);
+
+}
+
+
+/**
+ * @brief Drops whatever a viewer sends, notices when it goes away
+ * 
+ */
+static void read_events(connection_t* connection) {
+
+    int received = recv(connection->fd, connection->line, SERVER_LINE_SIZE, 0);
+    if (received < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) { return; }
+    if (received <= 0) { close_connection(connection); }
+
+}
+
+
+/**
+ * @brief Starts sending the next event of an idle stream
+ * 
+ */
+static void next_event(connection_t* connection, const server_handler_t* handler, int64_t now) {
+
+    static const char heartbeat[] = ":\n\n";
+
+    size_t length = handler->event(connection);
+    if (length != 0) {
+        connection->response = connection->reply;
+        connection->response_length = length;
+    } else if (now - connection->last_activity >= SERVER_EVENT_HEARTBEAT) {
+        connection->response = heartbeat;
+        connection->response_length = sizeof(heartbeat) - 1;
+    } else {
+        return;
+    }
+    connection->response_offset = 0;
+    connection->state = CONNECTION_WRITING;
+
+}
+
+
+bool server_event_stream(connection_t* connection) {
+
+    int streams = 0;
+    for (int i = 0; i < SERVER_MAX_CONNECTIONS; i++) {
+        if (connections[i].state != CONNECTION_CLOSED and connections[i].event_stream) { streams++; }
+    }
+    if (streams >= SERVER_MAX_EVENT_STREAMS) { return false; }
+
+    connection->event_stream = true;
+    return true;
+
+}
+
+
+void server_run(const server_handler_t* handler) {
+
+    while (true) {
+
+        fd_set read_set, write_set;
+        FD_ZERO(&read_set);
+        FD_ZERO(&write_set);
+        int max_fd = -1;
+        bool pending = false;
+        bool streaming = false;
+        bool free_slot = false;
+        int64_t now = esp_timer_get_time();
+        int64_t deadline = INT64_MAX;
+
+        for (int i = 0; i < SERVER_MAX_CONNECTIONS; i++) {
+            connection_t* connection = &connections[i];
+
+            if (connection->state == CONNECTION_PENDING) {
+                /* the state task owns the message until it is handled */
+                if (not connection->message.handled.load(std::memory_order_acquire)) {
+                    pending = true;
+                    continue;
+                }
+                handler->respond(connection);
+                connection->last_activity = now;
+                start_response(connection);
+            }
+
+            if (connection->state == CONNECTION_EVENTS) {
+                next_event(connection, handler, now);
+                streaming = true;
+            }
+
+            /* idle event streams wait as long as there is nothing to send */
+            if (connection->state != CONNECTION_CLOSED and connection->state != CONNECTION_EVENTS and
+                now - connection->last_activity >= SERVER_IDLE_TIMEOUT) {
+                close_connection(connection);
+            }
+            if (connection->state == CONNECTION_CLOSED) {
+                free_slot = true;
+                continue;
+            }
+
+            if (connection->state != CONNECTION_EVENTS and connection->last_activity + SERVER_IDLE_TIMEOUT < deadline) {
+                deadline = connection->last_activity + SERVER_IDLE_TIMEOUT;
+            }
+            FD_SET(connection->fd, connection->state == CONNECTION_WRITING ? &write_set : &read_set);
+            if (connection->fd > max_fd) { max_fd = connection->fd; }
+        }
+
+        if (free_slot) {
+            FD_SET(server_fd, &read_set);
+            if (server_fd > max_fd) { max_fd = server_fd; }
+        }
+
+        /* block until a socket is ready, the next idle timeout or forever */
+        struct timeval timeout;
+        struct timeval* timeout_pointer = &timeout;
+        if (pending) {
+            timeout.tv_sec = 0;
+            timeout.tv_usec = SERVER_PENDING_POLL * 1000;
+        } else if (streaming and deadline - now > SERVER_EVENT_POLL * 1000) {
+            /* events are published by other tasks, so they are polled for */
+            timeout.tv_sec = 0;
+            timeout.tv_usec = SERVER_EVENT_POLL * 1000;
+        } else if (deadline != INT64_MAX) {
+            timeout.tv_sec = (deadline - now) / 1000000;
+            timeout.tv_usec = (deadline - now) % 1000000;
+        } else {
+            timeout_pointer = NULL;
+        }
+
+        if (select(max_fd + 1, &read_set, &write_set, NULL, timeout_pointer) <= 0) { continue; }
+
+        now = esp_timer_get_time();
+        if (free_slot and FD_ISSET(server_fd, &read_set)) { accept_connection(now); }
+
+        for (int i = 0; i < SERVER_MAX_CONNECTIONS; i++) {
+            connection_t* connection = &connections[i];
+            if (connection->state == CONNECTION_READING and FD_ISSET(connection->fd, &read_set)) {
+                read_connection(connection, handler, now);
+            } else if (connection->state == CONNECTION_READING_BODY and FD_ISSET(connection->fd, &read_set)) {
+                read_body(connection, handler, now);
+            } else if (connection->state == CONNECTION_WRITING and FD_ISSET(connection->fd, &write_set)) {
+                write_connection(connection, handler, now);
+            } else if (connection->state == CONNECTION_EVENTS and FD_ISSET(connection->fd, &read_set)) {
+                read_events(connection);
+            }
+        }
+
+    }
+
+}
@@ -0,0 +1,167 @@
+#include <string.h>
+
+#include <AsyncUDP.h>
+
+#include "macros.h"
+#include "frame.h"
+#include "pwm.h"
+#include "pixels.h"
+#include "stream.h"
+
+/* channels mapped onto the outputs, pixels in red green blue
+   order or the bars left to right followed by red, green and blue */
+#if PIXEL_OUTPUT
+#define STREAM_CHANNELS (PIXEL_COUNT * PIXEL_BYTES)
+#else
+#define STREAM_CHANNELS 6
+
+static const gpio_num_t stream_pins[STREAM_CHANNELS] = { LEFT_LED, MIDDLE_LED, RIGHT_LED, RGB_LED_RED, RGB_LED_GREEN, RGB_LED_BLUE };
+#endif
+
+static_assert(STREAM_FIRST_CHANNEL >= 1 and STREAM_FIRST_CHANNEL - 1 + STREAM_CHANNELS <= STREAM_UNIVERSE_SIZE,
+              "the outputs have to fit into one universe");
+
+static AsyncUDP stream_udp;
+
+/* latest frame, the udp task overwrites it until the tick takes it */
+static portMUX_TYPE stream_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t stream_channels[STREAM_CHANNELS];
+static bool stream_fresh = false;
+static int64_t stream_last_frame = 0;
+static bool stream_sequenced = false;
+static uint8_t stream_sequence = 0;
+static stream_stats_t stream_stats;
+
+/* owned by the tick */
+static uint8_t stream_output[STREAM_CHANNELS];
+static bool stream_active = false;
+
+
+bool stream_parse(const uint8_t* data, size_t length, stream_frame_t* frame) {
+
+    if (length < STREAM_HEADER_SIZE or memcmp(data, "Art-Net", 8) != 0) { return false; }
+    if ((data[8] | (data[9] << 8)) != STREAM_OPCODE_DMX) { return false; }
+    if (((data[10] << 8) | data[11]) < STREAM_PROTOCOL) { return false; }
+
+    uint16_t count = (data[16] << 8) | data[17];
+    if (count == 0 or count > STREAM_UNIVERSE_SIZE or count > length - STREAM_HEADER_SIZE) { return false; }
+
+    frame->sequence = data[12];
+    frame->universe = (data[14] | (data[15] << 8)) & 0x7fff;
+    frame->count = count;
+    frame->channels = data + STREAM_HEADER_SIZE;
+    return true;
+
+}
+
+
+/**
+ * @brief Takes the mapped channels of a frame of our universe,
+ * a frame the tick hasn't shown yet is replaced, last frame wins
+ * 
+ */
+static void stream_packet(AsyncUDPPacket& packet) {
+
+    int64_t now = esp_timer_get_time();
+    stream_frame_t frame;
+    bool parsed = stream_parse(packet.data(), packet.length(), &frame);
+
+    portENTER_CRITICAL(&stream_mux);
+    if (not parsed) {
+        stream_stats.invalid++;
+    } else if (frame.universe == STREAM_UNIVERSE) {
+        stream_stats.received++;
+        /* a big jump back is a restarted sender, not a late frame */
+        int8_t behind = (int8_t)(stream_sequence - frame.sequence);
+        if (frame.sequence != 0 and stream_sequenced and behind >= 0 and behind < STREAM_SEQUENCE_WINDOW) {
+            stream_stats.out_of_order++;
+        } else {
+            if (stream_fresh) { stream_stats.superseded++; }
+            /* channels beyond a short frame are off */
+            size_t first = STREAM_FIRST_CHANNEL - 1;
+            size_t count = (frame.count > first) ? frame.count - first : 0;
+            if (count > STREAM_CHANNELS) { count = STREAM_CHANNELS; }
+            memcpy(stream_channels, frame.channels + first, count);
+            memset(stream_channels + count, 0, STREAM_CHANNELS - count);
+
+            stream_fresh = true;
+            stream_last_frame = now;
+            stream_sequenced = frame.sequence != 0;
+            stream_sequence = frame.sequence;
+        }
+    }
+    portEXIT_CRITICAL(&stream_mux);
+
+}
+
+
+bool stream_begin(void) {
+
+    if (not stream_udp.listen(STREAM_PORT)) { return false; }
+    stream_udp.onPacket(&stream_packet);
+    return true;
+
+}
+
+
+/**
+ * @brief Writes a frame to the outputs
+ * 
+ */
+static void stream_show(const uint8_t* channels) {
+
+#if PIXEL_OUTPUT
+    for (uint16_t i = 0; i < PIXEL_COUNT; i++) {
+        const uint8_t* pixel = channels + i * PIXEL_BYTES;
+        pixel_set(i, pixel[0], pixel[1], pixel[2]);
+    }
+    pixel_show();
+#elif PWM_OUTPUT
+    for (int i = 0; i < STREAM_CHANNELS; i++) { pwm_set_level(stream_pins[i], channels[i]); }
+#else
+    for (int i = 0; i < STREAM_CHANNELS; i++) { frame_set_level(stream_pins[i], channels[i] >= 128); }
+    frame_commit();
+#endif
+
+}
+
+
+bool stream_tick(int64_t now) {
+
+    portENTER_CRITICAL(&stream_mux);
+    bool running = stream_last_frame != 0 and now - stream_last_frame < STREAM_TIMEOUT;
+    bool fresh = stream_fresh;
+    if (fresh) {
+        memcpy(stream_output, stream_channels, STREAM_CHANNELS);
+        stream_fresh = false;
+        stream_stats.shown++;
+    }
+    if (not running) {
+        /* the next stream starts without a sequence history */
+        stream_sequenced = false;
+    }
+    portEXIT_CRITICAL(&stream_mux);
+
+    if (not running) {
+        if (stream_active) {
+            /* the animation repaints every output on its next frame */
+            stream_active = false;
+            frame_invalidate();
+        }
+        return false;
+    }
+
+    stream_active = true;
+    if (fresh) { stream_show(stream_output); }
+    return true;
+
+}
+
+
+void stream_get_stats(stream_stats_t* stats) {
+
+    portENTER_CRITICAL(&stream_mux);
+    *stats = stream_stats;
+    portEXIT_CRITICAL(&stream_mux);
+
+}
@@ -0,0 +1,107 @@
+#include <AsyncUDP.h>
+
+#include "macros.h"
+#include "sync.h"
+
+static AsyncUDP sync_udp;
+static const IPAddress sync_group(SYNC_GROUP_ADDRESS);
+
+/* latest beacon, written by the udp task and taken by the tick */
+static portMUX_TYPE sync_mux = portMUX_INITIALIZER_UNLOCKED;
+static sync_beacon_t sync_latest;
+static bool sync_pending = false;
+
+static int64_t sync_next_beacon = 0;
+
+
+void sync_encode(const sync_beacon_t* beacon, uint8_t* data) {
+
+    data[0] = 'L';
+    data[1] = 'S';
+    data[2] = SYNC_VERSION;
+    data[3] = beacon->animation_type;
+    data[4] = beacon->rgb_sequence_index;
+    data[5] = beacon->active_rgb;
+    for (int i = 0; i < 4; i++) { data[6 + i] = beacon->frame_rate >> (8 * i); }
+    for (int i = 0; i < 8; i++) { data[10 + i] = beacon->position >> (8 * i); }
+
+}
+
+
+bool sync_decode(const uint8_t* data, size_t length, sync_beacon_t* beacon) {
+
+    if (length != SYNC_BEACON_SIZE or data[0] != 'L' or data[1] != 'S' or data[2] != SYNC_VERSION) { return false; }
+    if (data[3] >= ANIMATION_COUNT or data[5] > GREEN) { return false; }
+
+    beacon->animation_type = data[3];
+    beacon->rgb_sequence_index = data[4];
+    beacon->active_rgb = data[5];
+    beacon->frame_rate = 0;
+    for (int i = 0; i < 4; i++) { beacon->frame_rate |= (uint32_t)data[6 + i] << (8 * i); }
+    beacon->position = 0;
+    for (int i = 0; i < 8; i++) { beacon->position |= (uint64_t)data[10 + i] << (8 * i); }
+    return beacon->frame_rate != 0;
+
+}
+
+
+/**
+ * @brief Keeps the latest beacon, stamped with its arrival time
+ * 
+ */
+static void sync_packet(AsyncUDPPacket& packet) {
+
+    int64_t now = esp_timer_get_time();
+    sync_beacon_t beacon;
+    if (not sync_decode(packet.data(), packet.length(), &beacon)) { return; }
+    beacon.time = now;
+
+    portENTER_CRITICAL(&sync_mux);
+    sync_latest = beacon;
+    sync_pending = true;
+    portEXIT_CRITICAL(&sync_mux);
+
+}
+
+
+bool sync_begin(void) {
+
+    if (not sync_udp.listenMulticast(sync_group, SYNC_PORT)) { return false; }
+#if SYNC_ROLE == SYNC_FOLLOWER
+    sync_udp.onPacket(&sync_packet);
+#endif
+    return true;
+
+}
+
+
+bool sync_due(int64_t now) {
+
+    if (now < sync_next_beacon) { return false; }
+    /* stays on the beat, unless the tick fell behind by more than one */
+    sync_next_beacon += SYNC_BEACON_PERIOD;
+    if (sync_next_beacon <= now) { sync_next_beacon = now + SYNC_BEACON_PERIOD; }
+    return true;
+
+}
+
+
+void sync_send(const sync_beacon_t* beacon) {
+
+    uint8_t data[SYNC_BEACON_SIZE];
+    sync_encode(beacon, data);
+    sync_udp.writeTo(data, sizeof(data), sync_group, SYNC_PORT);
+
+}
+
+
+bool sync_receive(sync_beacon_t* beacon) {
+
+    portENTER_CRITICAL(&sync_mux);
+    bool pending = sync_pending;
+    if (pending) { *beacon = sync_latest; }
+    sync_pending = false;
+    portEXIT_CRITICAL(&sync_mux);
+    return pending;
+
+}
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Embeds the files from assets/ into src/assets.cpp.
+
+Every asset is minified, gzip compressed and stored as complete HTTP
+responses (gzip, identity and 304) in flash, so the server only has to
+pick one and send it. Run after changing anything in assets/, the
+firmware build does it automatically.
+"""
+
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+ASSET_DIR = os.path.join(ROOT, "assets")
+OUTPUT = os.path.join(ROOT, "src", "assets.cpp")
+
+CONTENT_TYPES = {
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".html": "text/html",
+    ".svg": "image/svg+xml",
+}
+
+# assets never change without a firmware update, the etag revalidates them afterwards
+CACHE_CONTROL = "public, max-age=86400"
+
+
+def minify(name, data):
+    if name.endswith(".css"):
+        text = data.decode("utf-8")
+        text = re.sub(r"\s+", " ", text)
+        text = re.sub(r"\s*([{};:,])\s*", r"\1", text)
+        return text.replace(";}", "}").strip().encode("utf-8")
+    if name.endswith(".js"):
+        # block comments and indentation only, the code itself stays untouched
+        text = re.sub(r"/\*.*?\*/", "", data.decode("utf-8"), flags=re.S)
+        lines = (line.strip() for line in text.splitlines())
+        return "\n".join(line for line in lines if line).encode("utf-8")
+    return data
+
+
+def head(status, fields):
+    lines = ["HTTP/1.1 " + status] + ["%s: %s" % field for field in fields]
+    return ("\r\n".join(lines) + "\r\n\r\n").encode("ascii")
+
+
+def c_array(name, data):
+    rows = []
+    for start in range(0, len(data), 16):
+        rows.append("    " + ", ".join("0x%02x" % byte for byte in data[start:start + 16]) + ",")
+    return "static const uint8_t %s[%d] = {\n%s\n};\n" % (name, len(data), "\n".join(rows))
+
+
+def main():
+    arrays = []
+    entries = []
+
+    for index, name in enumerate(sorted(os.listdir(ASSET_DIR))):
+        extension = os.path.splitext(name)[1]
+        if extension not in CONTENT_TYPES:
+            continue
+        with open(os.path.join(ASSET_DIR, name), "rb") as asset_file:
+            body = minify(name, asset_file.read())
+        compressed = gzip.compress(body, 9, mtime=0)
+        etag = '"%s"' % hashlib.sha1(body).hexdigest()[:16]
+
+        common = [("ETag", etag), ("Cache-Control", CACHE_CONTROL), ("Vary", "Accept-Encoding")]
+        content = [("Content-Type", CONTENT_TYPES[extension])]
+        gzip_response = head("200 OK", content + [("Content-Encoding", "gzip"),
+                             ("Content-Length", len(compressed))] + common) + compressed
+        identity_response = head("200 OK", content + [("Content-Length", len(body))] + common) + body
+        not_modified_response = head("304 Not Modified", common)
+
+        prefix = "asset_%d" % index
+        arrays.append("/* %s, %d bytes, %d gzipped */\n" % (name, len(body), len(compressed)))
+        arrays.append(c_array(prefix + "_gzip", gzip_response))
+        arrays.append(c_array(prefix + "_identity", identity_response))
+        arrays.append(c_array(prefix + "_not_modified", not_modified_response))
+        arrays.append("\n")
+        entries.append("    { \"/%s\", \"%s\", %s_gzip, sizeof(%s_gzip), %s_identity, sizeof(%s_identity), "
+                       "%s_not_modified, sizeof(%s_not_modified) },"
+                       % (name, etag.replace('"', '\\"'), prefix, prefix, prefix, prefix, prefix, prefix))
+
+    source = ("/* generated by tools/embed_assets.py from assets/, do not edit */\n\n"
+              "#include <string.h>\n\n"
+              "#include \"assets.h\"\n\n\n"
+              + "".join(arrays) +
+              "\nconst asset_t assets[] = {\n" + "\n".join(entries) + "\n};\n\n"
+              "const size_t asset_count = sizeof(assets) / sizeof(assets[0]);\n\n\n"
+              "const asset_t* asset_find(const char* path) {\n\n"
+              "    for (size_t i = 0; i < asset_count; i++) {\n"
+              "        if (strcmp(assets[i].path, path) == 0) { return &assets[i]; }\n"
+              "    }\n"
+              "    return NULL;\n\n"
+              "}\n\n\n"
+              "bool asset_not_modified(const asset_t* asset, const char* if_none_match) {\n\n"
+              "    /* a list of tags, weak comparison as RFC 7232 asks for */\n"
+              "    return strcmp(if_none_match, \"*\") == 0 or strstr(if_none_match, asset->etag) != NULL;\n\n"
+              "}\n")
+
+    with open(OUTPUT, "w") as output:
+        output.write(source)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
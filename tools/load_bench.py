@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Sends control requests from concurrent clients and reports requests/s and latency.
+
+Every client keeps its own keep-alive connection (or opens one per request
+with --close) and cycles through a mix of state reads, speed changes and
+animation switches as fast as the controller answers. Runs once for each
+client count and prints requests per second with the median and 99th
+percentile latency, and how many requests had to be sent again on a new
+connection because the controller closed the old one. Works against the device and the host simulator.
+
+    tools/load_bench.py localhost:8080 --clients 1 4 16 --seconds 5
+"""
+
+import argparse
+import http.client
+import threading
+import time
+
+# method, path and JSON body of each request in the mix
+REQUESTS = [
+    ("GET", "/", None),
+    ("GET", "/speed?bpm=90", None),
+    ("POST", "/control", '{"animation":"worm","colors":["red","green"]}'),
+    ("GET", "/animation_snake", None),
+    ("GET", "/speed?bpm=120", None),
+    ("POST", "/control", '{"animation":"pump","brightness":200}'),
+]
+
+
+def send(connection, method, path, body, close):
+    headers = {"Connection": "close"} if close else {}
+    if body is not None:
+        headers["Content-Type"] = "application/json"
+    connection.request(method, path, body=body, headers=headers)
+    response = connection.getresponse()
+    response.read()
+    return response
+
+
+def client(host, close, deadline, latencies, errors, reconnects):
+    connection = None
+    served = 0
+    request = 0
+    while time.monotonic() < deadline:
+        method, path, body = REQUESTS[request % len(REQUESTS)]
+        request += 1
+        start = time.monotonic()
+        try:
+            if connection is None:
+                connection = http.client.HTTPConnection(host, timeout=5)
+                served = 0
+            try:
+                response = send(connection, method, path, body, close)
+            except (ConnectionError, http.client.RemoteDisconnected):
+                # the controller closes a connection after SERVER_MAX_REQUESTS,
+                # a request racing that close is sent again like browsers do
+                if served == 0:
+                    raise
+                reconnects.append(1)
+                connection.close()
+                connection = http.client.HTTPConnection(host, timeout=5)
+                served = 0
+                response = send(connection, method, path, body, close)
+            served += 1
+            if response.status != 200:
+                errors.append(response.status)
+            if close or response.will_close:
+                connection.close()
+                connection = None
+        except (OSError, http.client.HTTPException) as error:
+            errors.append(str(error))
+            if connection is not None:
+                connection.close()
+            connection = None
+            continue
+        latencies.append(time.monotonic() - start)
+    if connection is not None:
+        connection.close()
+
+
+def percentile(values, share):
+    if not values:
+        return 0.0
+    return values[min(len(values) - 1, int(len(values) * share))]
+
+
+def run(host, clients, seconds, close):
+    latencies = [[] for _ in range(clients)]
+    errors = []
+    reconnects = []
+    deadline = time.monotonic() + seconds
+    threads = [threading.Thread(target=client, args=(host, close, deadline, latencies[i], errors, reconnects))
+               for i in range(clients)]
+    start = time.monotonic()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.monotonic() - start
+
+    merged = sorted(latency for own in latencies for latency in own)
+    return len(merged) / elapsed, percentile(merged, 0.5), percentile(merged, 0.99), len(errors), len(reconnects)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host", help="host[:port] of the controller")
+    parser.add_argument("--clients", type=int, nargs="+", default=[1, 4, 16])
+    parser.add_argument("--seconds", type=float, default=5.0)
+    parser.add_argument("--close", action="store_true", help="a new connection for every request")
+    args = parser.parse_args()
+
+    print("%8s %10s %10s %10s %8s %8s" % ("clients", "req/s", "p50 ms", "p99 ms", "retried", "errors"))
+    failed = False
+    for clients in args.clients:
+        rate, median, p99, errors, retried = run(args.host, clients, args.seconds, args.close)
+        print("%8d %10.0f %10.2f %10.2f %8d %8d" % (clients, rate, median * 1000, p99 * 1000, retried, errors))
+        failed = failed or errors > 0
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""Replays a sequence of control commands and reports how long it took.
+
+Sends the same commands three ways: a new connection for every command,
+one keep-alive connection waiting for each response before the next
+request, and pipelined with several requests in flight on a connection.
+Prints the time, commands per second and connections opened for each,
+and checks that every command was answered with 200 in order. Requests
+that were still unanswered when the controller closed a connection after
+SERVER_MAX_REQUESTS are sent again on a new one.
+
+    tools/replay_bench.py localhost:8080 --commands 1000 --depth 8
+"""
+
+import argparse
+import json
+import socket
+import time
+
+# state changes cycled through, each answered with the state page or document
+COMMANDS = [
+    ("GET", "/animation_worm", None),
+    ("GET", "/speed?bpm=90", None),
+    ("POST", "/control", {"animation": "snake", "colors": ["red", "blue"]}),
+    ("GET", "/speed_high", None),
+    ("POST", "/control", {"brightness": 128}),
+    ("GET", "/animation_pump", None),
+    ("GET", "/", None),
+]
+
+
+def request_bytes(command, close):
+    method, path, body = command
+    data = b"" if body is None else json.dumps(body, separators=(",", ":")).encode()
+    head = "%s %s HTTP/1.1\r\nHost: led\r\n" % (method, path)
+    if data:
+        head += "Content-Type: application/json\r\nContent-Length: %d\r\n" % len(data)
+    if close:
+        head += "Connection: close\r\n"
+    return head.encode() + b"\r\n" + data
+
+
+class Connection:
+    def __init__(self, address):
+        self.sock = socket.create_connection(address, timeout=5)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.buffer = b""
+
+    def send(self, data):
+        self.sock.sendall(data)
+
+    def response(self):
+        """Reads the next response by its Content-Length, None once the connection is closed."""
+        while b"\r\n\r\n" not in self.buffer:
+            if not self.fill():
+                return None
+        head, rest = self.buffer.split(b"\r\n\r\n", 1)
+        length = 0
+        for line in head.split(b"\r\n")[1:]:
+            name, _, value = line.partition(b":")
+            if name.strip().lower() == b"content-length":
+                length = int(value)
+        while len(rest) < length:
+            if not self.fill():
+                return None
+            rest = self.buffer.split(b"\r\n\r\n", 1)[1]
+        self.buffer = rest[length:]
+        return int(head[9:12])
+
+    def fill(self):
+        try:
+            data = self.sock.recv(65536)
+        except (ConnectionResetError, socket.timeout):
+            return False
+        self.buffer += data
+        return len(data) > 0
+
+    def close(self):
+        self.sock.close()
+
+
+def replay(address, commands, close, depth):
+    """Sends the commands with up to `depth` requests in flight, returns statuses and connections used."""
+    statuses = []
+    connections = 0
+    next_command = 0
+    while next_command < len(commands):
+        connection = Connection(address)
+        connections += 1
+        in_flight = []
+        while next_command + len(in_flight) < len(commands) or in_flight:
+            while len(in_flight) < depth and next_command + len(in_flight) < len(commands):
+                index = next_command + len(in_flight)
+                try:
+                    connection.send(request_bytes(commands[index], close))
+                except OSError:
+                    break
+                in_flight.append(index)
+            if not in_flight:
+                break
+            status = connection.response()
+            if status is None:
+                # closed under the requests in flight, they go out again on a new connection
+                break
+            statuses.append(status)
+            in_flight.pop(0)
+            next_command += 1
+            if close:
+                break
+        connection.close()
+    return statuses, connections
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host", help="host[:port] of the controller")
+    parser.add_argument("--commands", type=int, default=1000)
+    parser.add_argument("--depth", type=int, default=8, help="pipelined requests in flight")
+    args = parser.parse_args()
+
+    host, _, port = args.host.partition(":")
+    address = (host, int(port or 80))
+    commands = [COMMANDS[i % len(COMMANDS)] for i in range(args.commands)]
+
+    print("%-26s %10s %12s %12s" % ("mode", "seconds", "commands/s", "connections"))
+    failed = False
+    for name, close, depth in (("connection per command", True, 1),
+                               ("keep-alive", False, 1),
+                               ("pipelined, %d in flight" % args.depth, False, args.depth)):
+        start = time.monotonic()
+        statuses, connections = replay(address, commands, close, depth)
+        elapsed = time.monotonic() - start
+        wrong = sum(1 for status in statuses if status != 200)
+        print("%-26s %10.3f %12.0f %12d%s" % (name, elapsed, len(statuses) / elapsed, connections,
+                                             "  %d not answered with 200" % wrong if wrong else ""))
+        failed = failed or wrong > 0 or len(statuses) != len(commands)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
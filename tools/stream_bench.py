@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Streams ArtDmx frames to a controller and reports how many it showed.
+
+Sends numbered frames of a moving test pattern at a fixed rate, then
+compares the controller's /stream counters from before and after the
+run: frames shown per second and how many frames were dropped, either
+superseded by a newer frame before the next tick or out of order. The
+firmware has to be built with STREAM_INPUT 1.
+
+    tools/stream_bench.py esp32-led-controller.local --fps 44 --seconds 10
+"""
+
+import argparse
+import json
+import random
+import socket
+import struct
+import time
+import urllib.request
+
+STREAM_PORT = 6454
+OPCODE_DMX = 0x5000
+PROTOCOL = 14
+
+
+def artdmx(sequence, universe, channels):
+    return (b"Art-Net\0" + struct.pack("<H", OPCODE_DMX) + struct.pack(">H", PROTOCOL) +
+            bytes([sequence, 0]) + struct.pack("<H", universe) + struct.pack(">H", len(channels)) +
+            bytes(channels))
+
+
+def stats(host):
+    with urllib.request.urlopen("http://%s/stream" % host, timeout=5) as response:
+        return json.load(response)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host")
+    parser.add_argument("--fps", type=float, default=44.0)
+    parser.add_argument("--seconds", type=float, default=10.0)
+    parser.add_argument("--universe", type=int, default=0)
+    parser.add_argument("--channels", type=int, default=512)
+    parser.add_argument("--reorder", type=float, default=0.0,
+                        help="share of frames sent after their successor")
+    args = parser.parse_args()
+
+    before = stats(args.host)
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    address = (socket.gethostbyname(args.host), STREAM_PORT)
+
+    period = 1.0 / args.fps
+    count = int(args.fps * args.seconds)
+    held = None
+    start = time.monotonic()
+    for frame in range(count):
+        # one lit channel walking across the universe
+        channels = [0] * args.channels
+        channels[frame % args.channels] = 255
+        packet = artdmx(frame % 255 + 1, args.universe, channels)
+
+        if held is None and random.random() < args.reorder:
+            held = packet
+        else:
+            sock.sendto(packet, address)
+            if held is not None:
+                sock.sendto(held, address)
+                held = None
+
+        # absolute deadlines, so sending time doesn't slow the rate down
+        delay = start + (frame + 1) * period - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+    if held is not None:
+        sock.sendto(held, address)
+    elapsed = time.monotonic() - start
+
+    # the last frames may still be waiting for a tick
+    time.sleep(0.1)
+    after = stats(args.host)
+    delta = {key: after[key] - before[key] for key in after}
+
+    print("sent          %6d frames, %7.1f fps" % (count, count / elapsed))
+    print("received      %6d frames, %5.1f %% lost on the network" %
+          (delta["received"], 100.0 * (count - delta["received"]) / count))
+    print("shown         %6d frames, %7.1f fps" % (delta["shown"], delta["shown"] / elapsed))
+    if delta["received"]:
+        print("superseded    %6d frames, %5.1f %%" % (delta["superseded"], 100.0 * delta["superseded"] / delta["received"]))
+        print("out of order  %6d frames, %5.1f %%" % (delta["out_of_order"], 100.0 * delta["out_of_order"] / delta["received"]))
+
+
+if __name__ == "__main__":
+    main()